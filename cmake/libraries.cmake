@@ -46,3 +46,22 @@ function(check_codecov Target)
     endif()
     list(APPEND ${Libraries} coverage_config)
 endfunction(check_codecov)
+
+# Compiles mapping files into NAME.cpp with sable-fontgen and adds it to Target,
+# which can then load the fonts from sable::generated::NAME.
+function(sable_compile_fonts Target Name)
+    set(mappings "")
+    foreach(mapping ${ARGN})
+        get_filename_component(mapping ${mapping} ABSOLUTE)
+        list(APPEND mappings ${mapping})
+    endforeach()
+    set(output "${CMAKE_CURRENT_BINARY_DIR}/${Name}.cpp")
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND sable-fontgen --symbol ${Name} ${output} ${mappings}
+        DEPENDS sable-fontgen ${mappings}
+        COMMENT "Compiling fonts into ${Name}.cpp"
+        VERBATIM
+    )
+    target_sources(${Target} PRIVATE ${output})
+endfunction(sable_compile_fonts)
@@ -0,0 +1,266 @@
+#include "sable.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "font/fontlist.h"
+#include "parse/textparser.h"
+#include "data/mapper.h"
+
+struct sable_fonts {
+    sable::FontList fonts;
+    std::string locale;
+};
+
+struct sable_encoder {
+    sable::FontList fonts;
+    std::string mode, locale;
+    int page;
+    bool autoend;
+    sable::util::Mapper mapper;
+
+    sable_encoder(
+        const sable::FontList& fonts,
+        const std::string& mode,
+        const std::string& locale,
+        int page,
+        bool autoend,
+        const sable::util::Mapper& mapper
+    ) : fonts{fonts}, mode{mode}, locale{locale}, page{page}, autoend{autoend}, mapper{mapper} {}
+
+    // TextParser isn't safe to share between threads, so each call borrows one of its own.
+    mutable std::mutex mutex;
+    mutable std::vector<std::unique_ptr<sable::TextParser>> idle;
+
+    std::unique_ptr<sable::TextParser> acquire() const
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (!idle.empty()) {
+                auto parser = std::move(idle.back());
+                idle.pop_back();
+                return parser;
+            }
+        }
+        return std::make_unique<sable::TextParser>(
+            sable::FontList(fonts),
+            mode,
+            locale,
+            sable::options::ExportWidth::Off,
+            sable::options::ExportAddress::Off
+        );
+    }
+
+    void release(std::unique_ptr<sable::TextParser>&& parser) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        idle.push_back(std::move(parser));
+    }
+
+    // returns the width of the widest line.
+    int encode(sable::TextParser& parser, const char* text, std::vector<unsigned char>& data) const
+    {
+        using sable::TextParser;
+        auto settings = parser.getDefaultSetting(mapper.ToRom(0));
+        settings.page = page;
+        settings.autoend = autoend ? sable::ParseSettings::Autoend::On : sable::ParseSettings::Autoend::Off;
+        std::istringstream input(text);
+        int width = 0;
+        bool keepReading = false;
+        auto lastRead = TextParser::Metadata::No;
+        while (input || keepReading) {
+            keepReading = false;
+            auto rs = parser.parseLine(input, settings, data, lastRead, mapper);
+            width = std::max(width, rs.length);
+            lastRead = rs.metadata;
+            if (!rs.endOfBlock) {
+                keepReading |= (!data.empty() || lastRead == TextParser::Metadata::Yes);
+            }
+        }
+        return width;
+    }
+};
+
+namespace {
+    thread_local std::string lastError;
+
+    template<class T>
+    T* fail(const std::string& message)
+    {
+        lastError = message;
+        return nullptr;
+    }
+
+    sable_fonts* load(const YAML::Node& node, const char* locale)
+    {
+        auto fonts = std::make_unique<sable_fonts>();
+        fonts->locale = locale == nullptr ? "" : locale;
+        fonts->fonts = sable::FontList(fonts->locale);
+        fonts->fonts.load(node);
+        // everything is built up front, so encoders never have to change the list.
+        for (auto& name: fonts->fonts.getNames()) {
+            fonts->fonts.at(name);
+        }
+        lastError.clear();
+        return fonts.release();
+    }
+}
+
+extern "C" {
+
+int sable_api_version(void)
+{
+    return SABLE_API_VERSION;
+}
+
+const char* sable_last_error(void)
+{
+    return lastError.c_str();
+}
+
+sable_fonts* sable_fonts_load_file(const char* path, const char* locale)
+{
+    if (path == nullptr) {
+        return fail<sable_fonts>("No mapping file given.");
+    }
+    try {
+        std::string file(path);
+        if (file.size() > 4 && file.compare(file.size() - 4, 4, ".tbl") == 0) {
+            std::ifstream table(file, std::ios::binary);
+            if (!table) {
+                return fail<sable_fonts>(file + " could not be opened.");
+            }
+            auto fonts = std::make_unique<sable_fonts>();
+            fonts->locale = locale == nullptr ? "" : locale;
+            fonts->fonts = sable::FontList(fonts->locale);
+            // the font is named after the file, without its directory or extension.
+            auto start = file.find_last_of("/\\");
+            start = start == std::string::npos ? 0 : start + 1;
+            fonts->fonts.loadTable(table, file.substr(start, file.size() - 4 - start));
+            lastError.clear();
+            return fonts.release();
+        }
+        return load(YAML::LoadFile(path), locale);
+    } catch (std::exception &e) {
+        return fail<sable_fonts>(e.what());
+    }
+}
+
+sable_fonts* sable_fonts_load_yaml(const char* yaml, const char* locale)
+{
+    if (yaml == nullptr) {
+        return fail<sable_fonts>("No YAML given.");
+    }
+    try {
+        return load(YAML::Load(yaml), locale);
+    } catch (std::exception &e) {
+        return fail<sable_fonts>(e.what());
+    }
+}
+
+void sable_fonts_free(sable_fonts* fonts)
+{
+    delete fonts;
+}
+
+sable_encoder* sable_encoder_create(const sable_fonts* fonts, const char* font, int page, int autoend)
+{
+    if (fonts == nullptr || font == nullptr) {
+        return fail<sable_encoder>("No fonts or font name given.");
+    }
+    if (!fonts->fonts.contains(font)) {
+        return fail<sable_encoder>(std::string("Font \"") + font + "\" was not defined");
+    }
+    if (page < 0 || page >= fonts->fonts.at(font).getNumberOfPages()) {
+        return fail<sable_encoder>(std::string("Font \"") + font + "\" does not have page " + std::to_string(page));
+    }
+    try {
+        auto encoder = std::make_unique<sable_encoder>(
+            fonts->fonts,
+            font,
+            fonts->locale,
+            page,
+            autoend != 0,
+            sable::util::Mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE)
+        );
+        encoder->release(encoder->acquire());
+        lastError.clear();
+        return encoder.release();
+    } catch (std::exception &e) {
+        return fail<sable_encoder>(e.what());
+    }
+}
+
+void sable_encoder_free(sable_encoder* encoder)
+{
+    delete encoder;
+}
+
+sable_status sable_encode(
+    const sable_encoder* encoder,
+    const char* const* strings,
+    size_t count,
+    unsigned char* output,
+    size_t output_size,
+    sable_result* results
+) {
+    if (encoder == nullptr || (count > 0 && (strings == nullptr || results == nullptr)) || (output == nullptr && output_size > 0)) {
+        lastError = "Missing encoder, strings, output or results.";
+        return SABLE_INVALID_ARGUMENT;
+    }
+    sable_status status = SABLE_OK;
+    auto setStatus = [&status] (sable_result& result, sable_status value, const std::string& message) {
+        result.status = value;
+        if (status == SABLE_OK) {
+            status = value;
+            lastError = message;
+        }
+    };
+    std::unique_ptr<sable::TextParser> parser;
+    try {
+        parser = encoder->acquire();
+    } catch (std::exception &e) {
+        lastError = e.what();
+        return SABLE_FONT_ERROR;
+    }
+    std::vector<unsigned char> data;
+    size_t position = 0;
+    for (size_t index = 0; index < count; ++index) {
+        auto& result = results[index];
+        result = {position, 0, 0, SABLE_OK};
+        if (strings[index] == nullptr) {
+            setStatus(result, SABLE_INVALID_ARGUMENT, "String " + std::to_string(index) + " is null.");
+            continue;
+        }
+        data.clear();
+        try {
+            result.width = encoder->encode(*parser, strings[index], data);
+        } catch (std::exception &e) {
+            setStatus(result, SABLE_ENCODING_ERROR, "String " + std::to_string(index) + ": " + e.what());
+            continue;
+        }
+        result.length = data.size();
+        if (output_size - position < data.size()) {
+            setStatus(result, SABLE_BUFFER_TOO_SMALL, "The output buffer is too small.");
+            continue;
+        }
+        if (!data.empty()) {
+            std::memcpy(output + position, data.data(), data.size());
+        }
+        position += data.size();
+    }
+    encoder->release(std::move(parser));
+    if (status == SABLE_OK) {
+        lastError.clear();
+    }
+    return status;
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef SABLE_C_API_H
+#define SABLE_C_API_H
+
+/*
+ * C interface for encoding text with Sable fonts without a project directory.
+ *
+ * Fonts are loaded once from a mapping file (the same YAML as a project's
+ * inMapping files) and shared by any number of encoders. An encoder can be
+ * used from several threads at once.
+ *
+ * Functions which fail return NULL or a non-zero status, and sable_last_error
+ * describes the most recent failure on the calling thread.
+ */
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32) && defined(SABLE_SHARED_LIBRARY)
+    #ifdef SABLE_EXPORTS
+        #define SABLE_API __declspec(dllexport)
+    #else
+        #define SABLE_API __declspec(dllimport)
+    #endif
+#elif defined(SABLE_EXPORTS)
+    #define SABLE_API __attribute__((visibility("default")))
+#else
+    #define SABLE_API
+#endif
+
+#define SABLE_API_VERSION 1
+
+typedef struct sable_fonts sable_fonts;
+typedef struct sable_encoder sable_encoder;
+
+typedef enum sable_status {
+    SABLE_OK = 0,
+    SABLE_INVALID_ARGUMENT = 1,
+    SABLE_FONT_ERROR = 2,
+    SABLE_ENCODING_ERROR = 3,
+    SABLE_BUFFER_TOO_SMALL = 4
+} sable_status;
+
+typedef struct sable_result {
+    /* where the encoded bytes start in the output buffer. */
+    size_t offset;
+    /* number of encoded bytes, which is the size needed if status is SABLE_BUFFER_TOO_SMALL. */
+    size_t length;
+    /* width in pixels of the widest line. */
+    int width;
+    sable_status status;
+} sable_result;
+
+SABLE_API int sable_api_version(void);
+
+/* The message for the last failure on this thread, or an empty string. */
+SABLE_API const char* sable_last_error(void);
+
+/* Loads every font in a mapping file, or in YAML text.
+ * A file ending in .tbl is read as a Thingy table with one font, named after the file. */
+SABLE_API sable_fonts* sable_fonts_load_file(const char* path, const char* locale);
+SABLE_API sable_fonts* sable_fonts_load_yaml(const char* yaml, const char* locale);
+SABLE_API void sable_fonts_free(sable_fonts* fonts);
+
+/* Creates an encoder for one font. The fonts can be freed afterwards.
+ * With autoend set, each string gets the font's end code unless it ends with a command which ends it. */
+SABLE_API sable_encoder* sable_encoder_create(const sable_fonts* fonts, const char* font, int page, int autoend);
+SABLE_API void sable_encoder_free(sable_encoder* encoder);
+
+/* Encodes count UTF-8 strings one after another into output, filling in one result per string.
+ * A string which doesn't fit, or can't be encoded, gets an error status and no space in output,
+ * and the rest of the strings are still encoded. Returns the first error status, or SABLE_OK. */
+SABLE_API sable_status sable_encode(
+    const sable_encoder* encoder,
+    const char* const* strings,
+    size_t count,
+    unsigned char* output,
+    size_t output_size,
+    sable_result* results
+);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* SABLE_C_API_H */
@@ -20,6 +20,14 @@ struct TextNode {
     options::ExportAddress exportAddress;
 };
 
+// A label for data that was already written under another label, so it has no
+// file of its own.
+struct AliasNode {
+    std::string target;
+    size_t size;
+    options::ExportWidth exportWidth;
+};
+
 }
 
 #endif // ADDRESS_H
@@ -40,6 +40,28 @@ const TextNode& AddressList::getFile(const std::string &label) const
     return m_TextNodeList.at(label);
 }
 
+void AddressList::addAlias(const std::string &label, int address, AliasNode &&alias)
+{
+    m_Addresses.push_back({address, label, false});
+    m_AliasList[label] = std::move(alias);
+}
+
+const AliasNode* AddressList::findAlias(const std::string &label) const
+{
+    if (auto result = m_AliasList.find(label); result != m_AliasList.end()) {
+        return &result->second;
+    }
+    return nullptr;
+}
+
+std::size_t AddressList::getSize(const std::string &label) const
+{
+    if (auto alias = findAlias(label); alias != nullptr) {
+        return alias->size;
+    }
+    return getFile(label).size;
+}
+
 void AddressList::addTable(const std::string& name, Table &&tbl)
 {
     m_Addresses.push_back({tbl.getAddress(), name, true});
@@ -29,6 +29,11 @@ public:
         options::ExportAddress exportAddress
     );
     const TextNode& getFile(const std::string& label) const;
+    void addAlias(const std::string& label, int address, AliasNode&& alias);
+    // nullptr if label isn't an alias.
+    const AliasNode* findAlias(const std::string& label) const;
+    // the size of the data under a file's or an alias's label.
+    std::size_t getSize(const std::string& label) const;
 
     void addTable(const std::string& name, Table&& tbl);
     const Table& getTable(const std::string& label) const;
@@ -48,6 +53,7 @@ public:
 private:
     std::vector<AddressNode> m_Addresses;
     std::unordered_map<std::string, TextNode> m_TextNodeList;
+    std::unordered_map<std::string, AliasNode> m_AliasList;
     std::unordered_map<std::string, Table> m_TableList;
     int nextAddress;
     bool isSorted;
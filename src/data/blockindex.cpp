@@ -0,0 +1,63 @@
+#include "blockindex.h"
+
+#include <algorithm>
+
+namespace sable {
+
+namespace {
+    constexpr std::uint64_t HASH_BASE = 0x100000001B3;
+
+    // hashes are built back to front so every suffix of a block can be hashed in one pass.
+    std::uint64_t extend(std::uint64_t hash, unsigned char value)
+    {
+        return hash * HASH_BASE + value + 1;
+    }
+
+    std::uint64_t key(std::uint64_t hash, std::size_t length)
+    {
+        return hash ^ (length * 0x9E3779B97F4A7C15);
+    }
+}
+
+std::optional<BlockIndex::Match> BlockIndex::find(const std::vector<unsigned char> &data) const
+{
+    if (data.empty()) {
+        return std::nullopt;
+    }
+    std::uint64_t hash = 0;
+    for (auto it = data.rbegin(); it != data.rend(); ++it) {
+        hash = extend(hash, *it);
+    }
+    auto [first, last] = m_Suffixes.equal_range(key(hash, data.size()));
+    for (auto it = first; it != last; ++it) {
+        const Stored& candidate = m_Blocks[it->second.block];
+        if (candidate.data.size() - it->second.offset == data.size() &&
+            std::equal(data.begin(), data.end(), candidate.data.begin() + it->second.offset)
+        ) {
+            return Match{
+                candidate.label,
+                candidate.address + static_cast<int>(it->second.offset),
+                it->second.offset
+            };
+        }
+    }
+    return std::nullopt;
+}
+
+void BlockIndex::add(const std::string &label, int address, const std::vector<unsigned char> &data)
+{
+    std::size_t block = m_Blocks.size();
+    m_Blocks.push_back({label, address, data});
+    std::uint64_t hash = 0;
+    for (std::size_t offset = data.size(); offset > 0; --offset) {
+        hash = extend(hash, data[offset - 1]);
+        m_Suffixes.insert({key(hash, data.size() - offset + 1), Suffix{block, offset - 1}});
+    }
+}
+
+std::size_t BlockIndex::size() const
+{
+    return m_Blocks.size();
+}
+
+}
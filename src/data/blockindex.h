@@ -0,0 +1,42 @@
+#ifndef BLOCKINDEX_H
+#define BLOCKINDEX_H
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sable {
+
+// Index of every suffix of the blocks written so far, so that a new block which
+// is identical to (or the tail of) an existing one can point into it instead.
+class BlockIndex
+{
+public:
+    struct Match {
+        std::string label;
+        int address;
+        std::size_t offset;
+    };
+
+    std::optional<Match> find(const std::vector<unsigned char>& data) const;
+    void add(const std::string& label, int address, const std::vector<unsigned char>& data);
+    std::size_t size() const;
+private:
+    struct Stored {
+        std::string label;
+        int address;
+        std::vector<unsigned char> data;
+    };
+    struct Suffix {
+        std::size_t block;
+        std::size_t offset;
+    };
+    std::vector<Stored> m_Blocks;
+    std::unordered_multimap<std::uint64_t, Suffix> m_Suffixes;
+};
+
+}
+
+#endif // BLOCKINDEX_H
@@ -0,0 +1,146 @@
+#include "compression.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace sable {
+
+namespace compression {
+
+namespace {
+    std::vector<unsigned char> compressLZ(const std::vector<unsigned char>& data)
+    {
+        if (data.size() > 0xFFFF) {
+            throw std::runtime_error("Block is too large to be compressed.");
+        }
+        std::vector<unsigned char> output{
+            static_cast<unsigned char>(data.size() & 0xFF),
+            static_cast<unsigned char>(data.size() >> 8)
+        };
+        std::size_t literalStart = 0;
+        auto flushLiterals = [&output, &data, &literalStart] (std::size_t end) {
+            while (literalStart < end) {
+                std::size_t count = std::min(end - literalStart, LZ_MAX_LITERALS);
+                output.push_back(count - 1);
+                output.insert(output.end(), data.begin() + literalStart, data.begin() + literalStart + count);
+                literalStart += count;
+            }
+        };
+
+        std::size_t position = 0;
+        while (position < data.size()) {
+            std::size_t bestLength = 0, bestDistance = 0;
+            std::size_t windowStart = position > LZ_WINDOW ? position - LZ_WINDOW : 0;
+            for (std::size_t candidate = windowStart; candidate < position; ++candidate) {
+                std::size_t length = 0;
+                // the source may overlap the output, same as the decompressor.
+                while (length < LZ_MAX_MATCH &&
+                       position + length < data.size() &&
+                       data[candidate + length] == data[position + length]) {
+                    ++length;
+                }
+                if (length > bestLength) {
+                    bestLength = length;
+                    bestDistance = position - candidate;
+                }
+            }
+            if (bestLength >= LZ_MIN_MATCH) {
+                flushLiterals(position);
+                output.push_back(0x80 | (bestLength - LZ_MIN_MATCH));
+                output.push_back(bestDistance - 1);
+                position += bestLength;
+                literalStart = position;
+            } else {
+                ++position;
+            }
+        }
+        flushLiterals(data.size());
+        return output;
+    }
+
+    std::vector<unsigned char> decompressLZ(const std::vector<unsigned char>& data)
+    {
+        if (data.size() < 2) {
+            throw std::runtime_error("Compressed block is missing its header.");
+        }
+        std::size_t length = data[0] | (data[1] << 8);
+        std::vector<unsigned char> output;
+        output.reserve(length);
+        std::size_t position = 2;
+        auto next = [&data, &position] () {
+            if (position >= data.size()) {
+                throw std::runtime_error("Compressed block ended unexpectedly.");
+            }
+            return data[position++];
+        };
+        while (output.size() < length) {
+            unsigned char command = next();
+            if (command < 0x80) {
+                for (int count = command + 1; count > 0; --count) {
+                    output.push_back(next());
+                }
+            } else {
+                std::size_t count = (command & 0x7F) + LZ_MIN_MATCH;
+                std::size_t distance = next() + 1;
+                if (distance > output.size()) {
+                    throw std::runtime_error("Compressed block refers to data before its start.");
+                }
+                for (std::size_t source = output.size() - distance; count > 0; --count) {
+                    output.push_back(output[source++]);
+                }
+            }
+        }
+        output.resize(length);
+        return output;
+    }
+}
+
+Codec parseCodec(const std::string &name)
+{
+    if (name == "none") {
+        return Codec::None;
+    } else if (name == "lz") {
+        return Codec::LZ;
+    }
+    throw std::runtime_error("none or lz.");
+}
+
+std::string getCodecName(Codec codec)
+{
+    switch (codec) {
+    case Codec::None:
+        return "none";
+    case Codec::LZ:
+        return "lz";
+    default:
+        throw std::logic_error("Undefined codec.");
+    }
+}
+
+std::vector<unsigned char> compress(Codec codec, const std::vector<unsigned char> &data)
+{
+    switch (codec) {
+    case Codec::None:
+        return data;
+    case Codec::LZ:
+        return compressLZ(data);
+    default:
+        throw std::logic_error("Undefined codec.");
+    }
+}
+
+std::vector<unsigned char> decompress(Codec codec, const std::vector<unsigned char> &data)
+{
+    switch (codec) {
+    case Codec::None:
+        return data;
+    case Codec::LZ:
+        return decompressLZ(data);
+    default:
+        throw std::logic_error("Undefined codec.");
+    }
+}
+
+}
+
+}
@@ -0,0 +1,35 @@
+#ifndef COMPRESSION_H
+#define COMPRESSION_H
+
+#include <string>
+#include <vector>
+
+namespace sable {
+
+namespace compression {
+
+enum class Codec {
+    None, LZ
+};
+
+// LZ blocks start with the decompressed length as a 2 byte little-endian value,
+// followed by commands:
+//  0x00-0x7F: copy the next (n + 1) bytes as-is.
+//  0x80-0xFF: copy (n & 0x7F) + 3 bytes from the already decompressed data,
+//             starting (next byte + 1) bytes back.
+constexpr std::size_t LZ_MAX_LITERALS = 0x80;
+constexpr std::size_t LZ_MIN_MATCH = 3;
+constexpr std::size_t LZ_MAX_MATCH = 0x7F + LZ_MIN_MATCH;
+constexpr std::size_t LZ_WINDOW = 0x100;
+
+Codec parseCodec(const std::string& name);
+std::string getCodecName(Codec codec);
+
+std::vector<unsigned char> compress(Codec codec, const std::vector<unsigned char>& data);
+std::vector<unsigned char> decompress(Codec codec, const std::vector<unsigned char>& data);
+
+}
+
+}
+
+#endif // COMPRESSION_H
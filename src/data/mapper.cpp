@@ -1,29 +1,38 @@
 #include "mapper.h"
 
+#include <charconv>
 #include <sstream>
+#include <stdexcept>
 #include <iomanip>
 
-std::pair<unsigned int, int> sable::util::strToHex(const std::string &val)
+std::pair<unsigned int, int> sable::util::strToHex(std::string_view val)
 {
     int bytes;
-    std::stringstream t;
-    if (val.front() == '$') {
+    auto digits = val;
+    if (!val.empty() && val.front() == '$') {
         bytes = val.length() / 2;
-        t = std::stringstream(val.substr(1, val.length()-1));
+        digits.remove_prefix(1);
     } else {
         bytes = (val.length() + 1) / 2;
-        t = std::stringstream(val);
     }
-    int tmp;
-    t >> std::hex >> tmp;
-
-    if (tmp > 0xFFFFFF) {
-        throw std::runtime_error(std::string("Hex value \"") + val +"\" too large.");
+    // a sign and a 0x prefix are accepted, like they are when reading hex from a stream.
+    bool negative = !digits.empty() && digits.front() == '-';
+    if (!digits.empty() && (digits.front() == '-' || digits.front() == '+')) {
+        digits.remove_prefix(1);
+    }
+    if (digits.size() > 2 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X')) {
+        digits.remove_prefix(2);
+    }
+    unsigned int tmp;
+    auto end = digits.data() + digits.size();
+    auto [ptr, ec] = std::from_chars(digits.data(), end, tmp, 16);
+    if (ec == std::errc::result_out_of_range || (ec == std::errc() && !negative && tmp > 0xFFFFFF)) {
+        throw std::runtime_error(std::string("Hex value \"") + std::string(val) +"\" too large.");
     }
-    if (!t.eof()){
+    if (ec != std::errc() || ptr != end) {
         return std::make_pair(0, -1);
     }
-    return std::make_pair(tmp, bytes);
+    return std::make_pair(negative ? 0u - tmp : tmp, bytes);
 }
 
 sable::util::MapperType sable::util::getExpandedType(sable::util::MapperType m)
@@ -91,9 +100,34 @@ sable::util::Mapper::Mapper(const sable::util::MapperType &m, bool header, bool
             break;
         }
     }
+    buildTables();
+}
+
+void sable::util::Mapper::buildTables()
+{
+    auto tables = std::make_shared<Tables>();
+    tables->pcBases.fill(-1);
+    tables->romBases.fill(-1);
+    if (m_type != MapperType::INVALID) {
+        for (std::size_t chunk = 0; chunk < tables->pcBases.size(); ++chunk) {
+            int base = calculatePC(chunk << HALF_BANK_BITS);
+            // keep the size check for the end of the chunk, not the start.
+            if (base == -2) {
+                base = calculatePC(chunk << HALF_BANK_BITS, false);
+            }
+            tables->pcBases[chunk] = base;
+        }
+        for (std::size_t chunk = 0; chunk < tables->romBases.size(); ++chunk) {
+            int address = (chunk << HALF_BANK_BITS) + offset;
+            if (address < max_size) {
+                tables->romBases[chunk] = calculateRom(address);
+            }
+        }
+    }
+    m_Tables = std::move(tables);
 }
 
-int sable::util::Mapper::ToRom(int address) const
+int sable::util::Mapper::calculateRom(int address) const
 {
     if (address < 0 || address >= max_size) {
         // cannot exist in the ROM
@@ -118,7 +152,7 @@ int sable::util::Mapper::ToRom(int address) const
     return finalAddress;
 }
 
-int sable::util::Mapper::ToPC(int address) const
+int sable::util::Mapper::calculatePC(int address, bool checkSize) const
 {
     if (address<0 || address>0xFFFFFF) //not 24bit
         return -1;
@@ -133,7 +167,7 @@ int sable::util::Mapper::ToPC(int address) const
     int reverseSizeMask = ((max_size - 1) & (0x800000 & ~address) >> 1) << shift;
     int bank = ((address & reverseBankMask) | reverseSizeMask) >> shift;
     int calculatedAddress = ((address & reverseAddressMask) | bank) + offset;
-    if (calculatedAddress >= max_size) {
+    if (checkSize && calculatedAddress >= max_size) {
         return -2;
     }
     return calculatedAddress;
@@ -182,6 +216,7 @@ size_t sable::util::Mapper::calculateFileSize(int maxAddress) const
 void sable::util::Mapper::setIsHeadered(bool isHeadered) // not covered
 {
     offset = isHeadered ? 0x200 : 0;
+    buildTables();
 }
 
 int sable::util::Mapper::getSize() const
@@ -1,9 +1,12 @@
 #ifndef SABLE_UTIL_MAPPER_H
 #define SABLE_UTIL_MAPPER_H
 
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <tuple>
 #include <string>
+#include <string_view>
 
 namespace sable {
 namespace util {
@@ -21,20 +24,74 @@ static constexpr const int NORMAL_ROM_MAX_SIZE = 0x400000;
 static constexpr const int ROM_MAX_SIZE = 0x007F0000;
 static constexpr std::size_t MAX_ALLOWED_FILESIZE_SHORTCUT = 8388608;
 
-std::pair<unsigned int, int> strToHex(const std::string& val);
+std::pair<unsigned int, int> strToHex(std::string_view val);
 
 MapperType getExpandedType(MapperType m);
 class Mapper {
+    static constexpr int HALF_BANK_BITS = 15;
+    static constexpr int HALF_BANK_MASK = (1 << HALF_BANK_BITS) - 1;
+    static constexpr std::size_t PC_CHUNKS = 0x1000000 >> HALF_BANK_BITS;
+    static constexpr std::size_t ROM_CHUNKS = 0x800000 >> HALF_BANK_BITS;
+    // Every 32KB chunk of the ROM maps to a contiguous 32KB region of the SNES
+    // address space and vice versa, so conversions only need to look up the base
+    // of the chunk and add the rest of the address.
+    struct Tables {
+        std::array<int, PC_CHUNKS> pcBases;
+        std::array<int, ROM_CHUNKS> romBases;
+    };
     int shift;
     int offset;
     int max_size;
     unsigned int mask;
     unsigned int sram_mask;
     MapperType m_type;
+    std::shared_ptr<const Tables> m_Tables;
+
+    int calculateRom(int address) const;
+    int calculatePC(int address, bool checkSize = true) const;
+    void buildTables();
 public:
     Mapper(const MapperType& m, bool header, bool highType, int size = 0);
-    int ToRom(int address) const;
-    int ToPC(int address) const;
+    int ToRom(int address) const
+    {
+        int adjustedAddress = address - offset;
+        if (address < 0 || address >= max_size) {
+            // cannot exist in the ROM
+            return -1;
+        } else if (adjustedAddress < 0) {
+            return calculateRom(address);
+        }
+        int base = m_Tables->romBases[adjustedAddress >> HALF_BANK_BITS];
+        return base < 0 ? base : base | (adjustedAddress & HALF_BANK_MASK);
+    }
+    int ToPC(int address) const
+    {
+        if (address < 0 || address > 0xFFFFFF) {
+            return -1;
+        }
+        int base = m_Tables->pcBases[address >> HALF_BANK_BITS];
+        if (base < 0) {
+            return base;
+        }
+        int calculatedAddress = base + (address & HALF_BANK_MASK);
+        return calculatedAddress >= max_size ? -2 : calculatedAddress;
+    }
+    template<typename InputIt, typename OutputIt>
+    OutputIt ToRom(InputIt first, InputIt last, OutputIt out) const
+    {
+        for (; first != last; ++first) {
+            *(out++) = ToRom(*first);
+        }
+        return out;
+    }
+    template<typename InputIt, typename OutputIt>
+    OutputIt ToPC(InputIt first, InputIt last, OutputIt out) const
+    {
+        for (; first != last; ++first) {
+            *(out++) = ToPC(*first);
+        }
+        return out;
+    }
     operator bool() const;
     MapperType getType() const;
     size_t calculateFileSize(int maxAddress) const;
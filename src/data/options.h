@@ -13,6 +13,22 @@ enum class ExportWidth {
     On, Off
 };
 
+enum class Deduplicate {
+    On, Off
+};
+
+enum class CompressBlocks {
+    On, Off
+};
+
+enum class BinaryWidths {
+    On, Off
+};
+
+enum class CacheAssembly {
+    On, Off
+};
+
 }
 
 }
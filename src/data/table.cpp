@@ -1,8 +1,9 @@
 #include "table.h"
 #include "mapper.h"
-#include <iomanip>
+#include "tokenizer.h"
+#include <istream>
 #include <algorithm>
-#include <sstream>
+#include <stdexcept>
 
 namespace sable {
 
@@ -58,157 +59,109 @@ std::vector<std::string> Table::getDataFromFile(
 )
 {
     std::vector<std::string> v;
-    std::string line, input;
+    std::string line;
     int tableLine = 1;
+    auto error = [&tableLine] (std::string_view option, const char* message) {
+        return std::runtime_error(
+                    "line " + std::to_string(tableLine) +
+                    ": " + std::string(option) + message
+                    );
+    };
     while (!getline(tableFile, line).fail()) {
-        if (line.find('\r') != std::string::npos) {
-            line.erase(line.find('\r'), 1);
-        }
-        if (!line.empty()) {
-            std::istringstream lineStream(line);
-            lineStream >> input;
-            std::string option;
+        util::Tokenizer lineTokens(line);
+        auto input = lineTokens.next();
+        if (!input.empty()) {
+            std::string_view option;
             if (input == "address") {
-                if (!(lineStream >> option)) {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": missing value for table address."
-                                );
+                if ((option = lineTokens.next()).empty()) {
+                    throw error("", "missing value for table address.");
                 }
                 auto result = util::strToHex(option);
                 if (result.second < 0 || mapper.ToPC(result.first) == -1) {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": " + option + " is not a valid SNES address."
-                                );
+                    throw error(option, " is not a valid SNES address.");
                 }
                 m_Address = result.first;
             } else if (input == "file") {
-                if (lineStream >> option) {
-                    v.push_back(option);
+                if (!(option = lineTokens.next()).empty()) {
+                    v.emplace_back(option);
                 } else {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": missing filename."
-                                );
+                    throw error("", "missing filename.");
                 }
             } else if (input == "entry") {
-                if (lineStream >> option) {
+                if (!(option = lineTokens.next()).empty()) {
                     if (option == "const") {
                         int size, address;
-                        if (!(lineStream >> option)) {
-                            throw std::runtime_error(
-                                        "line " + std::to_string(tableLine) +
-                                        ": missing data for constant entry."
-                                        );
+                        if ((option = lineTokens.next()).empty()) {
+                            throw error("", "missing data for constant entry.");
                         }
                         if (option.back() == ',') {
                             // Probably should cause an error here
                             // if (!getStoreWidths()) {}
-                            option.pop_back();
+                            option.remove_suffix(1);
                         }
                         auto result = util::strToHex(option);
                         if (result.second < 0) {
-                            throw std::runtime_error(
-                                        "line " + std::to_string(tableLine) +
-                                        ": " + option + " is not a valid SNES address."
-                                        );
+                            throw error(option, " is not a valid SNES address.");
                         } else if (result.second > m_AddressSize) {
-                            throw std::runtime_error(
-                                        "line " + std::to_string(tableLine) +
-                                        ": " + option + " is larger than the max width for the table."
-                                        );
+                            throw error(option, " is larger than the max width for the table.");
                         }
                         address = result.first;
                         if (getStoreWidths()) {
-                            if (!(lineStream >> option)) {
-                                throw std::runtime_error(
-                                            "line " + std::to_string(tableLine) +
-                                            ": missing width for constant entry."
-                                            );
+                            if ((option = lineTokens.next()).empty()) {
+                                throw error("", "missing width for constant entry.");
                             }
                             if (option.front() == '$') {
                                 result = util::strToHex(option);
                                 if (result.second < 0) {
-                                    throw std::runtime_error(
-                                                "line " + std::to_string(tableLine) +
-                                                ": " + option + " is not a valid hexadecimal number."
-                                                );
+                                    throw error(option, " is not a valid hexadecimal number.");
                                 }
                                 size = result.first;
+                            } else if (auto value = util::parseInt(option)) {
+                                size = *value;
                             } else {
-                                try {
-                                    size = std::stoi(option);
-                                } catch (std::invalid_argument &e) {
-                                    throw std::runtime_error(
-                                                "line " + std::to_string(tableLine) +
-                                                ": " + option + " is not a decimal or hex number."
-                                                );
-                                }
+                                throw error(option, " is not a decimal or hex number.");
                             }
                         } else {
                             // Probably should cause an error if widths aren't being stored.
-                            // if (!lineStream.eof())
+                            // if (!lineTokens.done())
                             size = -1;
                         }
                         addEntry(address, size);
                     } else {
-                        addEntry(option);
+                        addEntry(std::string(option));
                     }
                 } else {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": missing data for table entry."
-                                );
+                    throw error("", "missing data for table entry.");
                 }
             } else if (input == "data") {
-                if (lineStream >> option) {
+                if (!(option = lineTokens.next()).empty()) {
                     auto result = util::strToHex(option);
                     if (result.second < 0 || mapper.ToPC(result.first) == -1) {
-                        throw std::runtime_error(
-                                    "line " + std::to_string(tableLine) +
-                                    ": " + option + " is not a valid SNES address."
-                                    );
+                        throw error(option, " is not a valid SNES address.");
                     }
                     m_DataAddress = result.first;
                 } else {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": missing address for table data address setting."
-                                );
+                    throw error("", "missing address for table data address setting.");
                 }
             } else if (input == "width") {
-                if (lineStream >> option) {
-                    try {
-                        int tableAddresssDataWidth = std::stoi(option);
-                        if (tableAddresssDataWidth != 2 && tableAddresssDataWidth != 3) {
-                            throw std::runtime_error(
-                                        "line " + std::to_string(tableLine) +
-                                        ": width value should be 2 or 3."
-                                        );
-                        }
-                        setAddressSize(tableAddresssDataWidth);
-                    } catch (const std::invalid_argument& e) {
-                        throw std::runtime_error(
-                                    "line " + std::to_string(tableLine)
-                                    + ": width value should be 2 or 3."
-                                    );
+                if (!(option = lineTokens.next()).empty()) {
+                    auto tableAddresssDataWidth = util::parseInt(option);
+                    if (!tableAddresssDataWidth ||
+                        (*tableAddresssDataWidth != 2 && *tableAddresssDataWidth != 3)) {
+                        throw error("", "width value should be 2 or 3.");
                     }
-
+                    setAddressSize(*tableAddresssDataWidth);
                 } else {
-                    throw std::runtime_error(
-                                "line " + std::to_string(tableLine) +
-                                ": missing value for table width setting."
-                                );
+                    throw error("", "missing value for table width setting.");
                 }
             } else if (input == "savewidth") {
                 // Probably should cause an error if widths aren't being stored.
-                // if (!lineStream.eof())
+                // if (!lineTokens.done())
                 setStoreWidths(true);
             } else {
                 throw std::runtime_error(
                     "line " + std::to_string(tableLine)
-                    + ": unrecognized setting \"" + input + "\""
+                    + ": unrecognized setting \"" + std::string(input) + "\""
                 );
             }
         }
@@ -0,0 +1,53 @@
+#include "tokenizer.h"
+
+#include <algorithm>
+#include <charconv>
+
+namespace sable {
+
+namespace util {
+
+Tokenizer::Tokenizer(std::string_view line) : m_Line{line}
+{
+
+}
+
+std::string_view Tokenizer::next()
+{
+    m_Line = rest();
+    auto end = std::find_if(m_Line.begin(), m_Line.end(), isSpace) - m_Line.begin();
+    auto token = m_Line.substr(0, end);
+    m_Line.remove_prefix(end);
+    return token;
+}
+
+std::string_view Tokenizer::rest() const
+{
+    auto start = std::find_if_not(m_Line.begin(), m_Line.end(), isSpace) - m_Line.begin();
+    return m_Line.substr(start);
+}
+
+bool Tokenizer::done() const
+{
+    return rest().empty();
+}
+
+bool isSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+}
+
+std::optional<int> parseInt(std::string_view value, int base)
+{
+    int result;
+    auto end = value.data() + value.size();
+    if (auto [ptr, ec] = std::from_chars(value.data(), end, result, base);
+        ec == std::errc() && ptr == end) {
+        return result;
+    }
+    return std::nullopt;
+}
+
+}
+
+}
@@ -0,0 +1,36 @@
+#ifndef TOKENIZER_H
+#define TOKENIZER_H
+
+#include <optional>
+#include <string_view>
+
+namespace sable {
+
+namespace util {
+
+// Splits a line into whitespace separated tokens without copying it.
+// The line has to outlive the tokenizer and any tokens read from it.
+class Tokenizer
+{
+public:
+    explicit Tokenizer(std::string_view line);
+
+    // returns an empty view once the line has been used up.
+    std::string_view next();
+    // returns the unread part of the line, without leading whitespace.
+    std::string_view rest() const;
+    bool done() const;
+private:
+    std::string_view m_Line;
+};
+
+bool isSpace(char c);
+
+// The whole value has to be a number for it to be parsed.
+std::optional<int> parseInt(std::string_view value, int base = 10);
+
+}
+
+}
+
+#endif // TOKENIZER_H
@@ -272,6 +272,15 @@ Font Builder::make(const YAML::Node &config, const std::string &name, const std:
         byteWidth
     );
 
+    if (config[Font::COMPRESSION].IsDefined()) {
+        f.setCompression(compression::parseCodec(
+            validate<std::string>(config[Font::COMPRESSION], name, Font::COMPRESSION, [] (const std::string& val) {
+                compression::parseCodec(val);
+                return val;
+            })
+        ));
+    }
+
     if (!config[Font::ENCODING].IsDefined()) {
         throw generateError(config.Mark(), name, Font::ENCODING, "is missing.");
     }
@@ -0,0 +1,45 @@
+#include "compiledfont.h"
+
+#include <string>
+#include <vector>
+
+namespace sable {
+
+Font CompiledFont::build() const
+{
+    Font font(
+        std::string(name),
+        std::string(localeId),
+        hasDigraphs,
+        commandValue,
+        isFixedWidth,
+        defaultWidth,
+        maxWidth,
+        std::string(fontWidthLocation),
+        byteWidth
+    );
+    font.setCompression(compression);
+    // the ids were normalized when the font was generated.
+    for (auto page = pages; page != pages + pageCount; ++page) {
+        Font::Page built;
+        for (auto glyph = page->glyphs; glyph != page->glyphs + page->glyphCount; ++glyph) {
+            built.addGlyph(std::string(glyph->id), Font::TextNode{glyph->code, glyph->width});
+        }
+        for (auto noun = page->nouns; noun != page->nouns + page->nounCount; ++noun) {
+            auto codes = page->nounCodes + noun->firstCode;
+            built.addNoun(std::string(noun->id), Font::NounNode{std::vector<int>(codes, codes + noun->codeCount), noun->width});
+        }
+        built.setMaxValue(page->maxValue);
+        font.addPage(std::move(built));
+    }
+    for (auto command = commands; command != commands + commandCount; ++command) {
+        font.addCommandData(std::string(command->id), Font::CommandNode{command->code, command->page, command->isNewLine});
+    }
+    for (auto extra = extras; extra != extras + extraCount; ++extra) {
+        font.addExtra(std::string(extra->id), extra->value);
+    }
+    font.validate(true);
+    return font;
+}
+
+} // namespace sable
@@ -0,0 +1,257 @@
+#ifndef SABLE_FONT_COMPILEDFONT_H
+#define SABLE_FONT_COMPILEDFONT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+#include "font.h"
+#include "data/compression.h"
+
+namespace sable {
+
+// A font compiled into the program from source written by sable-fontgen (see
+// FontCodeGenerator), so it can be loaded without its mapping file, YAML or
+// normalization. build() makes the same Font the mapping would, and TextParser
+// encodes text for a font loaded this way straight from the tables below, with no
+// map lookups, normalization or exceptions unless something isn't in them.
+// Every table keeps the order the font was built in, since the first glyph for a
+// code decides its width. Each one has an index of slots, which hold an entry's
+// position + 1 or 0, laid out by the generator with compiled::hash and linear
+// probing.
+struct CompiledFont
+{
+    struct Glyph {
+        std::string_view id;
+        unsigned int code;
+        int width;
+    };
+    struct Noun {
+        std::string_view id;
+        // the noun's codes are nounCodes[firstCode] up to nounCodes[firstCode + codeCount].
+        std::size_t firstCode;
+        std::size_t codeCount;
+        int width;
+    };
+    // the first characters of a font's digraphs.
+    struct Prefix {
+        std::string_view id;
+    };
+    struct Page {
+        const Glyph* glyphs;
+        std::size_t glyphCount;
+        const Noun* nouns;
+        std::size_t nounCount;
+        const int* nounCodes;
+        int maxValue;
+        // the width of every code, like Font's width table.
+        const int* widths;
+        std::size_t widthCount;
+        const std::uint32_t* glyphSlots;
+        std::size_t glyphSlotCount;
+        const std::uint32_t* nounSlots;
+        std::size_t nounSlotCount;
+        // every id a glyph with more than one character starts with, so a digraph
+        // is only looked for after a character which can start one.
+        const Prefix* prefixes;
+        const std::uint32_t* prefixSlots;
+        std::size_t prefixSlotCount;
+    };
+    struct Command {
+        std::string_view id;
+        unsigned int code;
+        int page;
+        bool isNewLine;
+    };
+    struct Extra {
+        std::string_view id;
+        int value;
+    };
+
+    std::string_view name;
+    std::string_view localeId;
+    bool hasDigraphs;
+    int commandValue;
+    bool isFixedWidth;
+    int defaultWidth;
+    int maxWidth;
+    std::string_view fontWidthLocation;
+    int byteWidth;
+    compression::Codec compression;
+    const Page* pages;
+    std::size_t pageCount;
+    const Command* commands;
+    std::size_t commandCount;
+    const Extra* extras;
+    std::size_t extraCount;
+    const std::uint32_t* commandSlots;
+    std::size_t commandSlotCount;
+    const std::uint32_t* extraSlots;
+    std::size_t extraSlotCount;
+
+    Font build() const;
+
+    // These return nullptr if id isn't in the table, and expect ids in NFC like
+    // the tables are. page has to be below pageCount.
+    const Glyph* findGlyph(std::size_t page, std::string_view id) const;
+    // the glyph for first followed by second.
+    const Glyph* findDigraph(std::size_t page, std::string_view first, std::string_view second) const;
+    const Noun* findNoun(std::size_t page, std::string_view id) const;
+    const Command* findCommand(std::string_view id) const;
+    const Extra* findExtra(std::string_view id) const;
+    int getWidth(std::size_t page, unsigned int code) const;
+};
+
+// All the fonts in one generated file.
+struct CompiledFonts
+{
+    const CompiledFont* fonts;
+    std::size_t count;
+
+    const CompiledFont* begin() const
+    {
+        return fonts;
+    }
+    const CompiledFont* end() const
+    {
+        return fonts + count;
+    }
+};
+
+namespace compiled {
+    // FNV-1a, which the generator lays the slots out with. Hashing the rest of a
+    // string from the hash of its start gives the hash of the whole thing.
+    constexpr std::uint32_t hash(std::string_view text, std::uint32_t start = 2166136261u)
+    {
+        for (char c: text) {
+            start = (start ^ static_cast<unsigned char>(c)) * 16777619u;
+        }
+        return start;
+    }
+
+    // the entry whose id is first followed by second, or nullptr.
+    template<class Entry>
+    constexpr const Entry* find(
+        const Entry* entries,
+        const std::uint32_t* slots,
+        std::size_t slotCount,
+        std::string_view first,
+        std::string_view second = {}
+    ) {
+        if (slotCount == 0) {
+            return nullptr;
+        }
+        std::size_t mask = slotCount - 1;
+        for (std::size_t slot = hash(second, hash(first)) & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+            auto id = entries[slots[slot] - 1].id;
+            if (id.size() == first.size() + second.size() &&
+                id.substr(0, first.size()) == first && id.substr(first.size()) == second) {
+                return &entries[slots[slot] - 1];
+            }
+        }
+        return nullptr;
+    }
+
+    // Checks generated files run with static_assert, so a bad table doesn't compile.
+
+    // every entry has to be found through the slots.
+    template<class Entry, std::size_t N, std::size_t S>
+    constexpr bool findsEvery(const std::array<Entry, N>& entries, const std::array<std::uint32_t, S>& slots)
+    {
+        for (auto& entry: entries) {
+            if (find(entries.data(), slots.data(), S, entry.id) != &entry) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // every glyph code needs a width.
+    template<std::size_t N, std::size_t W>
+    constexpr bool hasWidths(const std::array<CompiledFont::Glyph, N>& glyphs, const std::array<int, W>&)
+    {
+        for (auto& glyph: glyphs) {
+            if (glyph.code >= W) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // order lists the entries sorted by id, and each id has to come after the one before it.
+    template<class Entry, std::size_t N>
+    constexpr bool hasUniqueIds(const std::array<Entry, N>& entries, const std::array<std::uint32_t, N>& order)
+    {
+        for (std::size_t index = 1; index < N; ++index) {
+            if (order[index] >= N || !(entries[order[index - 1]].id < entries[order[index]].id)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // glyphs have to fit in the font's byte width, and can't use the command prefix.
+    template<std::size_t N>
+    constexpr bool glyphCodesFit(const std::array<CompiledFont::Glyph, N>& glyphs, int byteWidth, int commandValue)
+    {
+        for (auto& glyph: glyphs) {
+            if (glyph.code >= (1u << (8 * byteWidth)) || static_cast<int>(glyph.code) == commandValue) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    template<std::size_t N>
+    constexpr bool hasCommand(const std::array<CompiledFont::Command, N>& commands, std::string_view id)
+    {
+        for (auto& command: commands) {
+            if (command.id == id) {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+// these are used for every character of a script, so they're kept where they can be inlined.
+inline const CompiledFont::Glyph* CompiledFont::findGlyph(std::size_t page, std::string_view id) const
+{
+    auto& table = pages[page];
+    return compiled::find(table.glyphs, table.glyphSlots, table.glyphSlotCount, id);
+}
+
+inline const CompiledFont::Glyph* CompiledFont::findDigraph(std::size_t page, std::string_view first, std::string_view second) const
+{
+    auto& table = pages[page];
+    if (compiled::find(table.prefixes, table.prefixSlots, table.prefixSlotCount, first) == nullptr) {
+        return nullptr;
+    }
+    return compiled::find(table.glyphs, table.glyphSlots, table.glyphSlotCount, first, second);
+}
+
+inline const CompiledFont::Noun* CompiledFont::findNoun(std::size_t page, std::string_view id) const
+{
+    auto& table = pages[page];
+    return compiled::find(table.nouns, table.nounSlots, table.nounSlotCount, id);
+}
+
+inline const CompiledFont::Command* CompiledFont::findCommand(std::string_view id) const
+{
+    return compiled::find(commands, commandSlots, commandSlotCount, id);
+}
+
+inline const CompiledFont::Extra* CompiledFont::findExtra(std::string_view id) const
+{
+    return compiled::find(extras, extraSlots, extraSlotCount, id);
+}
+
+inline int CompiledFont::getWidth(std::size_t page, unsigned int code) const
+{
+    return isFixedWidth ? defaultWidth : pages[page].widths[code];
+}
+
+} // namespace sable
+
+#endif // SABLE_FONT_COMPILEDFONT_H
@@ -1,6 +1,7 @@
 #include "font.h"
 #include <exception>
 #include <algorithm>
+#include <mutex>
 
 #include "normalize.h"
 
@@ -8,6 +9,32 @@
 
 namespace sable {
 
+namespace {
+    // Returns an existing copy of value if any font has already built one, so pages which
+    // reuse an encoding (like through a YAML anchor) only keep one copy in memory.
+    template<class T, class Hash, class Equal>
+    std::shared_ptr<T> share(std::shared_ptr<T>&& value, Hash hash, Equal equal)
+    {
+        static std::mutex mutex;
+        static std::unordered_multimap<std::size_t, std::weak_ptr<T>> pool;
+
+        auto key = hash(*value);
+        std::lock_guard<std::mutex> lock(mutex);
+        auto [start, end] = pool.equal_range(key);
+        for (auto it = start; it != end; ) {
+            if (auto existing = it->second.lock(); !existing) {
+                it = pool.erase(it);
+            } else if (equal(*existing, *value)) {
+                return existing;
+            } else {
+                ++it;
+            }
+        }
+        pool.emplace(key, value);
+        return std::move(value);
+    }
+}
+
 Font::Font(
     const std::string& name,
     const std::string& localeId,
@@ -32,9 +59,13 @@ Font::Font(
 
     const Font::CommandNode &Font::getCommandData(const std::string &id) const
     {
-        if (auto cIt = m_CommandConvertMap.find(normalize(id));
-            cIt == m_CommandConvertMap.end()
-        ) {
+        // keys are normalized when they're added, and ids from the script when it's read,
+        // so normalizing is only needed when an id from somewhere else misses.
+        auto cIt = m_CommandConvertMap.find(id);
+        if (cIt == m_CommandConvertMap.end() && !isNormalized(id)) {
+            cIt = m_CommandConvertMap.find(normalize(id));
+        }
+        if (cIt == m_CommandConvertMap.end()) {
             throw CodeNotFound("Command not found.");
         } else {
             return cIt->second;
@@ -72,28 +103,27 @@ Font::Font(
             throw CodeNotFound(std::string("font " + m_Name + " does not have page " + std::to_string(page)));
         }
 
-        auto realId = normalize(id);
-
-        const auto &m_TextConvertMap = m_Pages[page].glyphs;
-        if (auto it = m_TextConvertMap.find(realId); it == m_TextConvertMap.end()) {
+        auto node = m_Pages[page].getGlyphs().find(id);
+        if (node == nullptr && !isNormalized(id)) {
+            node = m_Pages[page].getGlyphs().find(normalize(id));
+        }
+        if (node == nullptr) {
             if (!throws) {
                 return std::nullopt;
             }
             throw CodeNotFound(std::string("\"") + id + "\" not found in " + ENCODING + " of font " + m_Name);
         } else {
-            auto tmp = it->second;
-            return tmp;
+            return *node;
         }
     }
 
     int Font::getWidth(int page, const std::string &id) const
     {
-       auto wVal = lookupTextNode(page, id, true)->width;
-       if (m_IsFixedWidth || wVal <= 0) {
+       auto code = lookupTextNode(page, id, true)->code;
+       if (m_IsFixedWidth) {
            return m_DefaultWidth;
-       } else {
-           return wVal;
        }
+       return (*m_Pages[page].widths)[code];
     }
 
     std::tuple<unsigned int, bool> Font::getTextCode(int page, const std::string &id, const std::string& next) const
@@ -111,7 +141,10 @@ Font::Font(
         if (!(page < m_Pages.size())) {
             throw CodeNotFound(std::string("font " + m_Name + " does not have page " + std::to_string(page)));
         }
-        auto nounItr = m_Pages[page].nouns.find(normalize(id));
+        auto nounItr = m_Pages[page].nouns.find(id);
+        if (nounItr == m_Pages[page].nouns.end() && !isNormalized(id)) {
+            nounItr = m_Pages[page].nouns.find(normalize(id));
+        }
         if (nounItr == m_Pages[page].nouns.end()) {
             throw CodeNotFound(id + " not found in " + NOUNS + " of font " + m_Name);
         }
@@ -129,16 +162,29 @@ Font::Font(
 
     int Font::getExtraValue(const std::string &id) const
     {
-        if (auto eIt = m_Extras.find(normalize(id)); eIt == m_Extras.end()) {
+        auto eIt = m_Extras.find(id);
+        if (eIt == m_Extras.end() && !isNormalized(id)) {
+            eIt = m_Extras.find(normalize(id));
+        }
+        if (eIt == m_Extras.end()) {
             throw CodeNotFound(id + " not found in font " + m_Name);
         } else {
             return eIt->second;
         }
     }
 
+    const std::unordered_map<std::string, Font::CommandNode> &Font::getCommands() const
+    {
+        return m_CommandConvertMap;
+    }
+
+    const std::unordered_map<std::string, int> &Font::getExtras() const
+    {
+        return m_Extras;
+    }
+
     void Font::getFontWidths(int page, std::back_insert_iterator<std::vector<int> > inserter) const
     {
-        typedef std::pair<std::string, TextNode> TextDataPair;
         if (!(page < m_Pages.size())) {
             throw std::logic_error(
                 std::string("Tried to get widths for non-existent page ")  +
@@ -147,50 +193,46 @@ Font::Font(
                         m_Name
             );
         }
-        const auto& m_TextConvertMap = m_Pages[page].glyphs;
-        std::vector<TextDataPair> v(m_TextConvertMap.begin(), m_TextConvertMap.end());
-        std::sort(v.begin(), v.end(), [](TextDataPair& a, TextDataPair& b) {
-            return a.second.code < b.second.code;
-        });
         int index = 0;
         if (this->getCommandValue() == 0) {
             index = 1;
         }
-        auto t = v.begin();
         if (m_IsFixedWidth) {
-            while (index <= m_Pages[page].maxValue) {
-                *(inserter++) = m_DefaultWidth;
-                index++;
-                ++t;
-            }
-        } else {
-            // never ran into an issue with this until I started testing pages
-            // my best guess is that adding those cases somehow messed with memory enough
-            // to trigger the infinite loop condition.
-            unsigned int lastCode = m_Pages[page].maxValue+1;
-            while (t != v.end()) {
-                if (lastCode != t->second.code ) {
-                    if (index == t->second.code) {
-                        if (t->second.width > 0) {
-                            *(inserter++) = t->second.width;
-                        } else {
-                            *(inserter++) = m_DefaultWidth;
-                        }
-                        ++index;
-                        lastCode = (t++)->second.code;
-                    } else {
-                        *(inserter++) = m_DefaultWidth;
-                        ++index;
-                    }
-                } else {
-                    ++t;
-                }
-            }
             for ( ; index <= m_Pages[page].maxValue; ++index) {
                 *(inserter++) = m_DefaultWidth;
             }
+        } else {
+            const auto& widths = *m_Pages[page].widths;
+            std::copy(widths.begin() + std::min<std::size_t>(index, widths.size()), widths.end(), inserter);
+        }
+    }
+
+    const Font::Page &Font::getPage(int page) const
+    {
+        if (!(page < m_Pages.size())) {
+            throw CodeNotFound(std::string("font " + m_Name + " does not have page " + std::to_string(page)));
         }
+        return m_Pages[page];
+    }
 
+    std::set<unsigned int> Font::getUsedCodes(int page) const
+    {
+        std::set<unsigned int> codes;
+        for (auto [id, glyph]: getPage(page).getGlyphs()) {
+            codes.insert(glyph.code);
+        }
+        // commands only share the glyph range when there's no command prefix.
+        if (m_CommandValue == -1) {
+            for (auto& [id, command]: m_CommandConvertMap) {
+                codes.insert(command.code);
+            }
+        } else {
+            codes.insert(m_CommandValue);
+        }
+        for (auto& [id, value]: m_Extras) {
+            codes.insert(value);
+        }
+        return codes;
     }
 
     unsigned int Font::getEndValue() const
@@ -200,7 +242,46 @@ Font::Font(
 
     void Font::addPage(Page &&pg)
     {
-        m_Pages.push_back(pg);
+        const auto& glyphs = pg.getGlyphs();
+        unsigned int maxCode = std::max(pg.maxValue, 0);
+        for (auto [id, glyph]: glyphs) {
+            maxCode = std::max(maxCode, glyph.code);
+        }
+        auto widths = std::make_shared<std::vector<int>>(maxCode + 1, m_DefaultWidth);
+        std::vector<bool> assigned(maxCode + 1, false);
+        for (auto [id, glyph]: glyphs) {
+            // the glyph table keeps the order glyphs were defined in, so if several glyphs
+            // share a code, the width of the first one defined with a width is always used.
+            if (glyph.width > 0 && !assigned[glyph.code]) {
+                (*widths)[glyph.code] = glyph.width;
+                assigned[glyph.code] = true;
+            }
+        }
+        if (pg.glyphs) {
+            pg.glyphs->shrink();
+            pg.glyphs = share(std::move(pg.glyphs), [] (const Glyphs& table) {
+                return table.hash([] (const TextNode& node) {
+                    return (static_cast<std::size_t>(node.code) << 16) ^ node.width;
+                });
+            }, [] (const Glyphs& lhs, const Glyphs& rhs) {
+                return lhs.equals(rhs, [] (const TextNode& left, const TextNode& right) {
+                    return left.code == right.code && left.width == right.width;
+                });
+            });
+        }
+        pg.widths = share(std::move(widths), [] (const std::vector<int>& values) {
+            std::size_t result = values.size();
+            for (int value: values) {
+                result = result * 31 + value;
+            }
+            return result;
+        }, std::equal_to<std::vector<int>>());
+        m_Pages.push_back(std::move(pg));
+    }
+
+    void Font::setCompression(compression::Codec codec)
+    {
+        m_Compression = codec;
     }
 
     void Font::validate(bool result)
@@ -249,6 +330,11 @@ Font::Font(
         return m_HasDigraphs;
     }
 
+    compression::Codec Font::getCompression() const
+    {
+        return m_Compression;
+    }
+
 #ifdef SABLE_KEEP_DEPRECATED
     std::tuple<unsigned int, bool> Font::getTextCode(const std::string &id, const std::string& next) const
     {
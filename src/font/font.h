@@ -8,16 +8,22 @@
 #include <optional>
 #include <cctype>
 #include <iterator>
+#include <memory>
+#include <set>
+#include <vector>
 
 #include "characteriterator.h"
+#include "glyphtable.h"
 #include "error.h"
 #include "codenotfound.h"
+#include "data/compression.h"
 
 namespace sable {
     class Font
     {
     public:
         friend class FontBuilder;
+        friend struct FontCodeGenerator;
         static constexpr const char* USE_DIGRAPHS = "HasDigraphs";
         static constexpr const char* BYTE_WIDTH = "ByteWidth";
         static constexpr const char* CMD_CHAR = "CommandValue";
@@ -35,6 +41,7 @@ namespace sable {
         static constexpr const char* CMD_NEWLINE_VAL = "newline";
         static constexpr const char* CMD_PAGE = "page";
         static constexpr const char* PAGES = "Pages";
+        static constexpr const char* COMPRESSION = "Compression";
 
 //        enum ReadType {ERROR, TEXT, COMMAND, EXTRA};
         Font(
@@ -58,6 +65,7 @@ namespace sable {
         int getCommandValue() const;
         int getMaxWidth() const;
         bool getHasDigraphs() const;
+        compression::Codec getCompression() const;
         const std::string& getFontWidthLocation() const;
 
         int getNumberOfPages() const;
@@ -75,14 +83,22 @@ namespace sable {
             std::vector<int> codes;
             int width = 0;
         };
+        typedef GlyphTable<TextNode> Glyphs;
         class Page  {
             friend class Font;
-            std::unordered_map<std::string, TextNode> glyphs;
+            friend struct FontCodeGenerator;
+            // shared between pages with identical encodings, and copied before it's changed.
+            std::shared_ptr<Glyphs> glyphs;
             std::unordered_map<std::string, NounNode> nouns;
             int maxValue;
+            // width of every code on the page, filled in when the page is added to a font.
+            std::shared_ptr<const std::vector<int>> widths;
         public:
             void addGlyph(const std::string& id, TextNode&& tx) {
-                glyphs[id] = tx;
+                if (!glyphs || glyphs.use_count() > 1) {
+                    glyphs = glyphs ? std::make_shared<Glyphs>(*glyphs) : std::make_shared<Glyphs>();
+                }
+                glyphs->insert(id, tx);
             }
             void addNoun(const std::string& id, NounNode&& n) {
                 nouns[id] = n;
@@ -90,6 +106,13 @@ namespace sable {
             void setMaxValue(int mx) {
                 maxValue = mx;
             }
+            const Glyphs& getGlyphs() const {
+                static const Glyphs empty;
+                return glyphs ? *glyphs : empty;
+            }
+            const std::unordered_map<std::string, NounNode>& getNouns() const {
+                return nouns;
+            }
         };
 
         const CommandNode& getCommandData(const std::string& id) const;
@@ -102,6 +125,8 @@ namespace sable {
         CharacterIterator getNounData(int page, const std::string& id) const;
         int getWidth(int page, const std::string& id) const;
         void getFontWidths(int page, std::back_insert_iterator<std::vector<int>> inserter) const;
+        const Page& getPage(int page) const;
+        std::set<unsigned int> getUsedCodes(int page) const;
 
 #ifdef SABLE_KEEP_DEPRECATED
         [[deprecated("Use getTextCode(int page, const std::string& id, ...) instead.")]]
@@ -118,6 +143,8 @@ namespace sable {
 
         int getExtraValue(const std::string& id) const;
         void addExtra(const std::string& id, int value);
+        const std::unordered_map<std::string, CommandNode>& getCommands() const;
+        const std::unordered_map<std::string, int>& getExtras() const;
 
         explicit operator bool() const;
     private:
@@ -127,6 +154,7 @@ namespace sable {
         int m_ByteWidth, m_CommandValue, m_MaxWidth, m_DefaultWidth;
         unsigned int endValue;
         std::string m_FontWidthLocation;
+        compression::Codec m_Compression = compression::Codec::None;
         std::vector<Page> m_Pages;
         std::unordered_map<std::string, CommandNode> m_CommandConvertMap;
         std::unordered_map<std::string, int> m_Extras;
@@ -136,6 +164,7 @@ namespace sable {
     public:
         unsigned int getEndValue() const;
         void addPage(Page&& pg);
+        void setCompression(compression::Codec codec);
         void validate(bool result);
     };
 }
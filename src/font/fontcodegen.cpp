@@ -0,0 +1,296 @@
+#include "fontcodegen.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <map>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string_view>
+
+#include "compiledfont.h"
+
+namespace sable {
+
+namespace {
+    // a string literal for text, with anything that isn't printable ASCII escaped.
+    std::string quote(std::string_view text)
+    {
+        static const char* octal = "01234567";
+        std::string result = "\"";
+        for (char c: text) {
+            auto byte = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                result += '\\';
+                result += c;
+            } else if (byte >= 0x20 && byte < 0x7F) {
+                result += c;
+            } else {
+                // three digits, so the escape can't run into a digit after it.
+                result += '\\';
+                result += octal[byte >> 6];
+                result += octal[(byte >> 3) & 7];
+                result += octal[byte & 7];
+            }
+        }
+        return result + '"';
+    }
+
+    bool isIdentifier(const std::string& symbol)
+    {
+        return !symbol.empty() && !std::isdigit(static_cast<unsigned char>(symbol.front())) &&
+            std::all_of(symbol.begin(), symbol.end(), [] (char c) {
+                return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+            });
+    }
+
+    std::string codecName(compression::Codec codec)
+    {
+        switch (codec) {
+        case compression::Codec::None:
+            return "None";
+        case compression::Codec::LZ:
+            return "LZ";
+        }
+        throw std::logic_error("No name for compression codec " + compression::getCodecName(codec) + '.');
+    }
+
+    // opens a constexpr std::array called name, or writes an empty one and returns false.
+    bool beginArray(std::ostream& out, const char* type, const std::string& name, std::size_t size)
+    {
+        out << "constexpr std::array<" << type << ", " << size << "> " << name;
+        if (size == 0) {
+            out << "{};\n";
+            return false;
+        }
+        out << " = {{\n";
+        return true;
+    }
+
+    // numbers, 16 to a line.
+    template<class Values>
+    void writeNumbers(std::ostream& out, const char* type, const std::string& name, const Values& values)
+    {
+        if (beginArray(out, type, name, values.size())) {
+            for (std::size_t index = 0; index < values.size(); ++index) {
+                out << (index % 16 == 0 ? "    " : " ") << values[index] << ',';
+                if (index % 16 == 15 || index + 1 == values.size()) {
+                    out << '\n';
+                }
+            }
+            out << "}};\n";
+        }
+    }
+
+    // the index CompiledFont looks ids up with: at least twice as many slots as ids,
+    // so probes stay short, with each id in the first free slot from its hash.
+    void writeSlots(std::ostream& out, const std::string& name, const std::vector<std::string_view>& ids)
+    {
+        std::size_t size = ids.empty() ? 0 : 1;
+        while (size < ids.size() * 2) {
+            size *= 2;
+        }
+        std::vector<std::uint32_t> slots(size, 0);
+        for (std::size_t index = 0; index < ids.size(); ++index) {
+            auto slot = compiled::hash(ids[index]) & (size - 1);
+            while (slots[slot] != 0) {
+                slot = (slot + 1) & (size - 1);
+            }
+            slots[slot] = index + 1;
+        }
+        writeNumbers(out, "std::uint32_t", name, slots);
+    }
+
+    // the order of ids, for checking they're unique without sorting the table itself.
+    template<class Ids>
+    void writeOrder(std::ostream& out, const std::string& name, const Ids& ids)
+    {
+        std::vector<std::uint32_t> order(ids.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&ids] (std::uint32_t lhs, std::uint32_t rhs) {
+            return ids[lhs] < ids[rhs];
+        });
+        writeNumbers(out, "std::uint32_t", name, order);
+    }
+}
+
+void FontCodeGenerator::write(
+    const std::vector<const Font*>& fonts,
+    const std::string& symbol,
+    const std::string& source,
+    std::ostream& out
+) {
+    if (!isIdentifier(symbol)) {
+        throw std::runtime_error('"' + symbol + "\" is not a valid C++ identifier.");
+    }
+    out << "// Generated by sable-fontgen from " << source << ".\n"
+        << "// Change the mapping and generate it again instead of editing it.\n\n"
+        << "#include <array>\n"
+        << "#include <cstdint>\n\n"
+        << "#include \"font/compiledfont.h\"\n\n"
+        << "namespace {\n\n"
+        << "using sable::CompiledFont;\n\n";
+
+    for (std::size_t fontIndex = 0; fontIndex < fonts.size(); ++fontIndex) {
+        const Font& font = *fonts[fontIndex];
+        std::string label = "font " + font.m_Name;
+        out << "// " << font.m_Name << "\n"
+            << "namespace font" << fontIndex << " {\n\n";
+
+        for (std::size_t pageIndex = 0; pageIndex < font.m_Pages.size(); ++pageIndex) {
+            auto& page = font.m_Pages[pageIndex];
+            auto suffix = std::to_string(pageIndex);
+            std::vector<std::string_view> glyphIds;
+            if (beginArray(out, "CompiledFont::Glyph", "glyphs" + suffix, page.getGlyphs().size())) {
+                for (auto [id, glyph]: page.getGlyphs()) {
+                    out << "    {" << quote(id) << ", " << glyph.code << ", " << glyph.width << "},\n";
+                    glyphIds.push_back(id);
+                }
+                out << "}};\n";
+            }
+            writeOrder(out, "glyphOrder" + suffix, glyphIds);
+            out << "static_assert(sable::compiled::hasUniqueIds(glyphs" << suffix << ", glyphOrder" << suffix << "), "
+                << quote(label + " page " + suffix + " has a glyph more than once.") << ");\n"
+                << "static_assert(sable::compiled::glyphCodesFit(glyphs" << suffix << ", "
+                << font.m_ByteWidth << ", " << font.m_CommandValue << "), "
+                << quote(label + " page " + suffix + " has a glyph code which doesn't fit or is the command value.") << ");\n";
+            writeSlots(out, "glyphSlots" + suffix, glyphIds);
+            out << "static_assert(sable::compiled::findsEvery(glyphs" << suffix << ", glyphSlots" << suffix << "), "
+                << quote(label + " page " + suffix + " has a glyph its index can't find.") << ");\n";
+            writeNumbers(out, "int", "widths" + suffix, *page.widths);
+            out << "static_assert(sable::compiled::hasWidths(glyphs" << suffix << ", widths" << suffix << "), "
+                << quote(label + " page " + suffix + " has a glyph without a width.") << ");\n";
+
+            // a character can only start a digraph if a longer glyph starts with it.
+            std::set<std::string_view> prefixes;
+            if (font.m_HasDigraphs) {
+                for (auto id: glyphIds) {
+                    for (std::size_t length = 1; length < id.size(); ++length) {
+                        // only whole UTF-8 sequences.
+                        if ((static_cast<unsigned char>(id[length]) & 0xC0) != 0x80) {
+                            prefixes.insert(id.substr(0, length));
+                        }
+                    }
+                }
+            }
+            std::vector<std::string_view> prefixIds(prefixes.begin(), prefixes.end());
+            if (beginArray(out, "CompiledFont::Prefix", "prefixes" + suffix, prefixIds.size())) {
+                for (auto id: prefixIds) {
+                    out << "    {" << quote(id) << "},\n";
+                }
+                out << "}};\n";
+            }
+            writeSlots(out, "prefixSlots" + suffix, prefixIds);
+
+            // nouns are in a hash map, so they're sorted to keep the output the same every time.
+            std::map<std::string_view, const Font::NounNode*> nouns;
+            for (auto& [id, noun]: page.getNouns()) {
+                nouns.emplace(id, &noun);
+            }
+            std::vector<int> codes;
+            std::vector<std::string_view> nounIds;
+            if (beginArray(out, "CompiledFont::Noun", "nouns" + suffix, nouns.size())) {
+                for (auto& [id, noun]: nouns) {
+                    out << "    {" << quote(id) << ", " << codes.size() << ", " << noun->codes.size() << ", " << noun->width << "},\n";
+                    codes.insert(codes.end(), noun->codes.begin(), noun->codes.end());
+                    nounIds.push_back(id);
+                }
+                out << "}};\n";
+            }
+            writeOrder(out, "nounOrder" + suffix, nounIds);
+            out << "static_assert(sable::compiled::hasUniqueIds(nouns" << suffix << ", nounOrder" << suffix << "), "
+                << quote(label + " page " + suffix + " has a noun more than once.") << ");\n";
+            writeSlots(out, "nounSlots" + suffix, nounIds);
+            out << "static_assert(sable::compiled::findsEvery(nouns" << suffix << ", nounSlots" << suffix << "), "
+                << quote(label + " page " + suffix + " has a noun its index can't find.") << ");\n";
+            writeNumbers(out, "int", "nounCodes" + suffix, codes);
+            out << '\n';
+        }
+
+        out << "constexpr std::array<CompiledFont::Page, " << font.m_Pages.size() << "> pages = {{\n";
+        for (std::size_t pageIndex = 0; pageIndex < font.m_Pages.size(); ++pageIndex) {
+            auto suffix = std::to_string(pageIndex);
+            out << "    {glyphs" << suffix << ".data(), glyphs" << suffix << ".size(), "
+                << "nouns" << suffix << ".data(), nouns" << suffix << ".size(), "
+                << "nounCodes" << suffix << ".data(), " << font.getMaxEncodedValue(pageIndex) << ",\n"
+                << "        widths" << suffix << ".data(), widths" << suffix << ".size(), "
+                << "glyphSlots" << suffix << ".data(), glyphSlots" << suffix << ".size(), "
+                << "nounSlots" << suffix << ".data(), nounSlots" << suffix << ".size(),\n"
+                << "        prefixes" << suffix << ".data(), prefixSlots" << suffix << ".data(), prefixSlots" << suffix << ".size()},\n";
+        }
+        out << "}};\n\n";
+
+        std::map<std::string_view, const Font::CommandNode*> commands;
+        for (auto& [id, command]: font.m_CommandConvertMap) {
+            commands.emplace(id, &command);
+        }
+        std::vector<std::string_view> commandIds;
+        if (beginArray(out, "CompiledFont::Command", "commands", commands.size())) {
+            for (auto& [id, command]: commands) {
+                out << "    {" << quote(id) << ", " << command->code << ", " << command->page << ", "
+                    << (command->isNewLine ? "true" : "false") << "},\n";
+                commandIds.push_back(id);
+            }
+            out << "}};\n";
+        }
+        writeOrder(out, "commandOrder", commandIds);
+        out << "static_assert(sable::compiled::hasUniqueIds(commands, commandOrder), "
+            << quote(label + " has a command more than once.") << ");\n";
+        writeSlots(out, "commandSlots", commandIds);
+        out << "static_assert(sable::compiled::findsEvery(commands, commandSlots), "
+            << quote(label + " has a command its index can't find.") << ");\n";
+        for (auto required: {"End", "NewLine"}) {
+            out << "static_assert(sable::compiled::hasCommand(commands, " << quote(required) << "), "
+                << quote(label + " has no " + required + " command.") << ");\n";
+        }
+
+        std::map<std::string_view, int> extras(font.m_Extras.begin(), font.m_Extras.end());
+        std::vector<std::string_view> extraIds;
+        if (beginArray(out, "CompiledFont::Extra", "extras", extras.size())) {
+            for (auto& [id, value]: extras) {
+                out << "    {" << quote(id) << ", " << value << "},\n";
+                extraIds.push_back(id);
+            }
+            out << "}};\n";
+        }
+        writeOrder(out, "extraOrder", extraIds);
+        out << "static_assert(sable::compiled::hasUniqueIds(extras, extraOrder), "
+            << quote(label + " has an extra more than once.") << ");\n";
+        writeSlots(out, "extraSlots", extraIds);
+        out << "static_assert(sable::compiled::findsEvery(extras, extraSlots), "
+            << quote(label + " has an extra its index can't find.") << ");\n\n"
+            << "} // namespace font" << fontIndex << "\n\n";
+    }
+
+    out << "constexpr std::array<CompiledFont, " << fonts.size() << "> fonts";
+    if (fonts.empty()) {
+        out << "{};\n\n";
+    } else {
+        out << " = {{\n";
+        for (std::size_t fontIndex = 0; fontIndex < fonts.size(); ++fontIndex) {
+            const Font& font = *fonts[fontIndex];
+            std::string ns = "font" + std::to_string(fontIndex) + "::";
+            out << "    {\n"
+                << "        " << quote(font.m_Name) << ", " << quote(font.m_LocaleId) << ",\n"
+                << "        " << (font.m_HasDigraphs ? "true" : "false") << ", " << font.m_CommandValue << ", "
+                << (font.m_IsFixedWidth ? "true" : "false") << ", " << font.m_DefaultWidth << ", " << font.m_MaxWidth << ",\n"
+                << "        " << quote(font.m_FontWidthLocation) << ", " << font.m_ByteWidth << ", "
+                << "sable::compression::Codec::" << codecName(font.m_Compression) << ",\n"
+                << "        " << ns << "pages.data(), " << ns << "pages.size(),\n"
+                << "        " << ns << "commands.data(), " << ns << "commands.size(),\n"
+                << "        " << ns << "extras.data(), " << ns << "extras.size(),\n"
+                << "        " << ns << "commandSlots.data(), " << ns << "commandSlots.size(),\n"
+                << "        " << ns << "extraSlots.data(), " << ns << "extraSlots.size()\n"
+                << "    },\n";
+        }
+        out << "}};\n\n";
+    }
+    out << "} // namespace\n\n"
+        << "namespace sable::generated {\n\n"
+        << "extern const CompiledFonts " << symbol << ";\n"
+        << "const CompiledFonts " << symbol << "{fonts.data(), fonts.size()};\n\n"
+        << "} // namespace sable::generated\n";
+}
+
+} // namespace sable
@@ -0,0 +1,30 @@
+#ifndef SABLE_FONT_FONTCODEGEN_H
+#define SABLE_FONT_FONTCODEGEN_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "font.h"
+
+namespace sable {
+
+// Writes fonts out as a C++ source file of constexpr CompiledFont tables, which
+// defines sable::generated::<symbol> as a CompiledFonts. Other files can use it with
+//   namespace sable::generated { extern const CompiledFonts <symbol>; }
+// The file checks its tables with static_assert: glyph, noun, command and extra ids
+// have to be unique and found through their indexes, glyph codes have to fit in the
+// byte width and have widths, and End and NewLine have to be defined.
+struct FontCodeGenerator
+{
+    static void write(
+        const std::vector<const Font*>& fonts,
+        const std::string& symbol,
+        const std::string& source,
+        std::ostream& out
+    );
+};
+
+} // namespace sable
+
+#endif // SABLE_FONT_FONTCODEGEN_H
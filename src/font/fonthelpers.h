@@ -4,6 +4,7 @@
 #include <map>
 #include <string>
 #include "font.h"
+#include "fontlist.h"
 
 namespace sable {
 
@@ -11,6 +12,11 @@ namespace sable {
     {
         return f.find(key) != f.end();
     }
+
+    bool contains(const sable::FontList &f, std::string key)
+    {
+        return f.contains(key);
+    }
 }
 
 #endif // FONTHELPERS_H
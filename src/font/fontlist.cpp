@@ -0,0 +1,164 @@
+#include "fontlist.h"
+
+#include <algorithm>
+
+#include "builder.h"
+#include "tblbuilder.h"
+
+namespace sable {
+
+FontList::FontList(const std::string &locale): m_Locale{locale} {}
+
+FontList::FontList(FontMap &&fonts): m_Fonts{std::move(fonts)} {}
+
+void FontList::load(const YAML::Node &mapping)
+{
+    for (auto it = mapping.begin(); it != mapping.end(); ++it) {
+        auto name = it->first.Scalar();
+        m_Fonts.erase(name);
+        m_Compiled.erase(name);
+        m_Definitions[name] = it->second;
+    }
+}
+
+void FontList::loadTable(std::istream &table, const std::string &name)
+{
+    auto font = TblBuilder::make(table, name, m_Locale);
+    m_Definitions.erase(name);
+    m_Compiled.erase(name);
+    m_Fonts.insert_or_assign(name, std::move(font));
+}
+
+void FontList::load(const CompiledFont &font)
+{
+    std::string name(font.name);
+    m_Definitions.erase(name);
+    m_Fonts.insert_or_assign(name, font.build());
+    m_Compiled.insert_or_assign(name, &font);
+}
+
+bool FontList::contains(const std::string &name) const
+{
+    return m_Fonts.find(name) != m_Fonts.end() || m_Definitions.find(name) != m_Definitions.end();
+}
+
+bool FontList::isBuilt(const std::string &name) const
+{
+    return m_Fonts.find(name) != m_Fonts.end();
+}
+
+std::size_t FontList::size() const
+{
+    return m_Fonts.size() + m_Definitions.size();
+}
+
+std::vector<std::string> FontList::getNames() const
+{
+    std::vector<std::string> names;
+    names.reserve(m_Fonts.size() + m_Definitions.size());
+    for (auto& [name, font]: m_Fonts) {
+        names.push_back(name);
+    }
+    for (auto& [name, node]: m_Definitions) {
+        names.push_back(name);
+    }
+    std::sort(names.begin(), names.end());
+    return names;
+}
+
+const CompiledFont* FontList::getCompiled(const std::string &name) const
+{
+    if (auto compiled = m_Compiled.find(name); compiled != m_Compiled.end()) {
+        return compiled->second;
+    }
+    return nullptr;
+}
+
+Font &FontList::at(const std::string &name)
+{
+    auto font = find(name);
+    if (font == m_Fonts.end()) {
+        throw std::out_of_range("Font \"" + name + "\" was not defined");
+    }
+    return font->second;
+}
+
+const Font &FontList::at(const std::string &name) const
+{
+    auto font = find(name);
+    if (font == m_Fonts.end()) {
+        throw std::out_of_range("Font \"" + name + "\" was not defined");
+    }
+    return font->second;
+}
+
+Font &FontList::operator[](const std::string &name)
+{
+    if (auto font = find(name); font != m_Fonts.end()) {
+        return font->second;
+    }
+    return m_Fonts[name];
+}
+
+auto FontList::find(const std::string &name) -> iterator
+{
+    if (auto font = m_Fonts.find(name); font != m_Fonts.end()) {
+        return font;
+    }
+    return build(name);
+}
+
+auto FontList::find(const std::string &name) const -> const_iterator
+{
+    if (auto font = m_Fonts.find(name); font != m_Fonts.end()) {
+        return font;
+    }
+    return build(name);
+}
+
+auto FontList::begin() -> iterator
+{
+    return m_Fonts.begin();
+}
+
+auto FontList::end() -> iterator
+{
+    return m_Fonts.end();
+}
+
+auto FontList::begin() const -> const_iterator
+{
+    return m_Fonts.cbegin();
+}
+
+auto FontList::end() const -> const_iterator
+{
+    return m_Fonts.cend();
+}
+
+void FontList::buildFontData() const
+{
+    std::vector<std::string> needed;
+    for (auto& [name, node]: m_Definitions) {
+        if (node.IsMap() && (node[Font::FONT_ADDR].IsDefined() || node[Font::COMPRESSION].IsDefined())) {
+            needed.push_back(name);
+        }
+    }
+    for (auto& name: needed) {
+        build(name);
+    }
+}
+
+auto FontList::build(const std::string &name) const -> iterator
+{
+    auto definition = m_Definitions.find(name);
+    if (definition == m_Definitions.end()) {
+        return m_Fonts.end();
+    }
+    // if the definition is bad, it stays unbuilt so the error comes up again on the next look up.
+    auto font = m_Fonts.emplace(name, FontBuilder::make(definition->second, name, m_Locale)).first;
+    m_Definitions.erase(definition);
+    return font;
+}
+
+}
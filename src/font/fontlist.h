@@ -0,0 +1,72 @@
+#ifndef FONTLIST_H
+#define FONTLIST_H
+
+#include <istream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <yaml-cpp/yaml.h>
+
+#include "font.h"
+#include "compiledfont.h"
+
+namespace sable {
+
+// Fonts by name, where a font defined in a mapping file is only built
+// the first time it's looked up. Iterating only visits fonts which have been built.
+class FontList
+{
+    typedef std::map<std::string, Font> FontMap;
+public:
+    typedef FontMap::iterator iterator;
+    typedef FontMap::const_iterator const_iterator;
+
+    FontList() = default;
+    explicit FontList(const std::string& locale);
+    FontList(FontMap&& fonts);
+
+    // indexes each font in a mapping file; later definitions replace earlier ones.
+    void load(const YAML::Node& mapping);
+    // builds a font called name from a Thingy table right away. See TblBuilder.
+    void loadTable(std::istream& table, const std::string& name);
+    // builds a font generated by sable-fontgen right away, replacing any font with its name.
+    // TextParser encodes text for it from font's tables, which have to outlive the list.
+    void load(const CompiledFont& font);
+
+    bool contains(const std::string& name) const;
+    bool isBuilt(const std::string& name) const;
+    // the number of fonts defined, built or not.
+    std::size_t size() const;
+    std::vector<std::string> getNames() const;
+    // the tables the font called name was loaded from, or nullptr if it came from a mapping.
+    const CompiledFont* getCompiled(const std::string& name) const;
+
+    // these build the font if needed, and throw std::out_of_range if it was never defined.
+    Font& at(const std::string& name);
+    const Font& at(const std::string& name) const;
+    // like std::map, an undefined name gets an empty font.
+    Font& operator[](const std::string& name);
+    iterator find(const std::string& name);
+    const_iterator find(const std::string& name) const;
+
+    iterator begin();
+    iterator end();
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    // builds the fonts with width tables or compression, whose data is written out
+    // whether or not any text uses them.
+    void buildFontData() const;
+private:
+    std::string m_Locale;
+    mutable FontMap m_Fonts;
+    mutable std::map<std::string, YAML::Node> m_Definitions;
+    std::map<std::string, const CompiledFont*> m_Compiled;
+
+    iterator build(const std::string& name) const;
+};
+
+}
+
+#endif // FONTLIST_H
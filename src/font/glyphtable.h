@@ -0,0 +1,166 @@
+#ifndef GLYPHTABLE_H
+#define GLYPHTABLE_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace sable {
+
+// Maps glyph ids to values for one font page. The ids are packed into one string
+// with an open addressing index over them, so a page with tens of thousands of
+// glyphs doesn't need an allocation and a hash node for each one.
+// Iterating visits the glyphs in the order they were first inserted.
+template<class Value>
+class GlyphTable
+{
+    struct Entry {
+        std::uint32_t offset;
+        std::uint32_t length;
+        Value value;
+    };
+    static constexpr std::uint32_t EMPTY = 0;
+
+    std::string m_Pool;
+    std::vector<Entry> m_Entries;
+    // entry index + 1 for each slot, or EMPTY.
+    std::vector<std::uint32_t> m_Slots;
+
+    std::string_view key(const Entry& entry) const
+    {
+        return std::string_view(m_Pool).substr(entry.offset, entry.length);
+    }
+
+    std::size_t findSlot(std::string_view id) const
+    {
+        std::size_t mask = m_Slots.size() - 1;
+        std::size_t slot = std::hash<std::string_view>{}(id) & mask;
+        while (m_Slots[slot] != EMPTY && key(m_Entries[m_Slots[slot] - 1]) != id) {
+            slot = (slot + 1) & mask;
+        }
+        return slot;
+    }
+
+    void rehash(std::size_t size)
+    {
+        m_Slots.assign(size, EMPTY);
+        for (std::uint32_t index = 0; index < m_Entries.size(); ++index) {
+            m_Slots[findSlot(key(m_Entries[index]))] = index + 1;
+        }
+    }
+public:
+    class const_iterator {
+        const GlyphTable* table;
+        typename std::vector<Entry>::const_iterator entry;
+    public:
+        typedef std::pair<std::string_view, const Value&> value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef std::forward_iterator_tag iterator_category;
+
+        const_iterator(const GlyphTable* t, typename std::vector<Entry>::const_iterator it): table{t}, entry{it} {}
+        value_type operator*() const
+        {
+            return value_type(table->key(*entry), entry->value);
+        }
+        const_iterator& operator++()
+        {
+            ++entry;
+            return *this;
+        }
+        bool operator==(const const_iterator& other) const
+        {
+            return entry == other.entry;
+        }
+        bool operator!=(const const_iterator& other) const
+        {
+            return entry != other.entry;
+        }
+    };
+
+    // replaces the value if the id is already in the table.
+    void insert(std::string_view id, const Value& value)
+    {
+        if ((m_Entries.size() + 1) * 2 > m_Slots.size()) {
+            rehash(m_Slots.empty() ? 16 : m_Slots.size() * 2);
+        }
+        auto slot = findSlot(id);
+        if (m_Slots[slot] != EMPTY) {
+            m_Entries[m_Slots[slot] - 1].value = value;
+            return;
+        }
+        m_Entries.push_back({static_cast<std::uint32_t>(m_Pool.size()), static_cast<std::uint32_t>(id.size()), value});
+        m_Pool.append(id);
+        m_Slots[slot] = m_Entries.size();
+    }
+
+    const Value* find(std::string_view id) const
+    {
+        if (m_Entries.empty()) {
+            return nullptr;
+        }
+        auto slot = m_Slots[findSlot(id)];
+        return slot == EMPTY ? nullptr : &m_Entries[slot - 1].value;
+    }
+
+    // trims the spare capacity left over from building the table.
+    void shrink()
+    {
+        m_Pool.shrink_to_fit();
+        m_Entries.shrink_to_fit();
+    }
+
+    std::size_t size() const
+    {
+        return m_Entries.size();
+    }
+
+    bool empty() const
+    {
+        return m_Entries.empty();
+    }
+
+    const_iterator begin() const
+    {
+        return const_iterator(this, m_Entries.cbegin());
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this, m_Entries.cend());
+    }
+
+    // a hash of the contents, for finding identical tables.
+    template<class ValueHash>
+    std::size_t hash(ValueHash valueHash) const
+    {
+        std::size_t result = std::hash<std::string>{}(m_Pool);
+        for (auto& entry: m_Entries) {
+            result = result * 31 + entry.length;
+            result = result * 31 + valueHash(entry.value);
+        }
+        return result;
+    }
+
+    // tables are equal when they have the same glyphs inserted in the same order.
+    template<class ValueEqual>
+    bool equals(const GlyphTable& other, ValueEqual valueEqual) const
+    {
+        if (m_Pool != other.m_Pool || m_Entries.size() != other.m_Entries.size()) {
+            return false;
+        }
+        for (std::size_t index = 0; index < m_Entries.size(); ++index) {
+            if (m_Entries[index].length != other.m_Entries[index].length ||
+                !valueEqual(m_Entries[index].value, other.m_Entries[index].value)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+#endif // GLYPHTABLE_H
@@ -1,6 +1,8 @@
 #include "normalize.h"
 #include <unicode/normalizer2.h>
 #include <unicode/bytestream.h>
+#include <unicode/stringpiece.h>
+#include <algorithm>
 #include <cstring>
 #include <optional>
 #include <stdexcept>
@@ -8,20 +10,50 @@
 
 namespace sable {
 
+namespace {
+    const icu::Normalizer2* nfcInstance()
+    {
+        // ICU keeps the instance for the life of the program.
+        static const icu::Normalizer2* instance = [] () {
+            UErrorCode err = U_ZERO_ERROR;
+            auto* nfc = icu::Normalizer2::getNFCInstance(err);
+            if (U_FAILURE(err)) {
+                throw std::runtime_error("couldn't get the NFC instance.");
+            }
+            return nfc;
+        }();
+        return instance;
+    }
+}
 
 std::string normalize(const std::string &in)
 {
+    if (isNormalized(in)) {
+        return in;
+    }
     UErrorCode err = U_ZERO_ERROR;
     std::string sinkDestNFC;
     icu::StringByteSink sinkNFC(&sinkDestNFC);
 
-    if (auto instance = icu::Normalizer2::getNFCInstance(err); U_FAILURE(err)) {
-        throw std::runtime_error("couldn't get the NFC instance.");
-    } else if (instance->normalizeUTF8(0, in, sinkNFC, nullptr, err); U_FAILURE(err)) {
+    if (nfcInstance()->normalizeUTF8(0, in, sinkNFC, nullptr, err); U_FAILURE(err)) {
         throw std::runtime_error("cound't perform NFC normalization.");
     }
 
     return sinkDestNFC;
 }
 
+bool isNormalized(std::string_view in)
+{
+    // ASCII can't change, and it's most of what's looked up.
+    if (std::all_of(in.begin(), in.end(), [] (char c) { return static_cast<unsigned char>(c) < 0x80; })) {
+        return true;
+    }
+    UErrorCode err = U_ZERO_ERROR;
+    bool result = nfcInstance()->isNormalizedUTF8(icu::StringPiece(in.data(), in.size()), err);
+    if (U_FAILURE(err)) {
+        throw std::runtime_error("cound't check NFC normalization.");
+    }
+    return result;
+}
+
 } // namespace sable
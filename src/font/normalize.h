@@ -2,11 +2,14 @@
 #define SABLE_NORMALIZE_H
 
 #include <string>
+#include <string_view>
 #include <locale>
 
 namespace sable {
 
 std::string normalize(const std::string& in);
+// true if in is already in NFC, which most text is. Much cheaper than normalize.
+bool isNormalized(std::string_view in);
 
 } // namespace sable
 
@@ -0,0 +1,188 @@
+#include "tblbuilder.h"
+
+#include <algorithm>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "normalize.h"
+
+namespace sable {
+
+namespace {
+    struct Entry {
+        enum class Kind {Glyph, End, NewLine, Command} kind;
+        // the code's hex digits.
+        std::string_view code;
+        std::string_view text;
+        int line;
+    };
+
+    int hexValue(char c)
+    {
+        if (c >= '0' && c <= '9') {
+            return c - '0';
+        } else if (c >= 'A' && c <= 'F') {
+            return c - 'A' + 10;
+        } else if (c >= 'a' && c <= 'f') {
+            return c - 'a' + 10;
+        }
+        return -1;
+    }
+
+    // the value of each group of byteWidth bytes, with the first byte of a group the lowest.
+    std::vector<int> readCodes(std::string_view hex, int byteWidth)
+    {
+        std::vector<int> codes;
+        std::size_t digits = byteWidth * 2;
+        codes.reserve(hex.size() / digits);
+        for (std::size_t start = 0; start < hex.size(); start += digits) {
+            int code = 0;
+            for (int byte = 0; byte < byteWidth; ++byte) {
+                code |= (hexValue(hex[start + byte * 2]) << 4 | hexValue(hex[start + byte * 2 + 1])) << (8 * byte);
+            }
+            codes.push_back(code);
+        }
+        return codes;
+    }
+
+    std::string stripBrackets(std::string_view text)
+    {
+        if (!text.empty() && text.front() == '[') {
+            text.remove_prefix(1);
+        }
+        if (!text.empty() && text.back() == ']') {
+            text.remove_suffix(1);
+        }
+        return normalize(std::string(text));
+    }
+
+    bool isMultipleCharacters(std::string_view text)
+    {
+        // counts the bytes which start a UTF-8 character.
+        return std::count_if(text.begin(), text.end(), [] (char c) {
+            return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        }) > 1;
+    }
+}
+
+Font TblBuilder::make(std::istream &input, const std::string &name, const std::string &localeId)
+{
+    // the whole table is read at once, and every entry refers into it until the font is built.
+    std::string contents(std::istreambuf_iterator<char>(input), {});
+    std::vector<Entry> entries;
+    entries.reserve(std::count(contents.begin(), contents.end(), '\n') + 1);
+
+    std::size_t glyphDigits = 0;
+    bool hasDigraphs = false;
+    std::string_view rest(contents);
+    for (int line = 1; !rest.empty(); ++line) {
+        auto end = rest.find('\n');
+        auto current = rest.substr(0, end);
+        rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+        if (!current.empty() && current.back() == '\r') {
+            current.remove_suffix(1);
+        }
+        if (line == 1 && current.substr(0, 3) == "\xEF\xBB\xBF") {
+            current.remove_prefix(3);
+        }
+        if (current.empty() || current.front() == '#' || current.front() == ';' || current.front() == '@') {
+            continue;
+        }
+
+        Entry entry{Entry::Kind::Glyph, {}, {}, line};
+        switch (current.front()) {
+        case '/':
+            entry.kind = Entry::Kind::End;
+            break;
+        case '*':
+            entry.kind = Entry::Kind::NewLine;
+            break;
+        case '$':
+            entry.kind = Entry::Kind::Command;
+            break;
+        }
+        if (entry.kind != Entry::Kind::Glyph) {
+            current.remove_prefix(1);
+        }
+        auto equals = current.find('=');
+        if (equals == std::string_view::npos && (entry.kind == Entry::Kind::Glyph || entry.kind == Entry::Kind::Command)) {
+            throw FontError(line, name, "", "Expected a hex code followed by =.");
+        }
+        // the text of an end or new line is only a label, so it can be left off.
+        entry.code = current.substr(0, equals);
+        entry.text = equals == std::string_view::npos ? std::string_view() : current.substr(equals + 1);
+        if (entry.code.empty() || entry.code.size() % 2 != 0 ||
+            !std::all_of(entry.code.begin(), entry.code.end(), [] (char c) { return hexValue(c) >= 0; })) {
+            throw FontError(line, name, "", '"' + std::string(entry.code) + "\" is not a hex code with a whole number of bytes.");
+        }
+        if (entry.kind == Entry::Kind::Command) {
+            // some tables list a command's parameters after its name.
+            entry.text = entry.text.substr(0, entry.text.find(','));
+        }
+        if (entry.text.empty() && (entry.kind == Entry::Kind::Glyph || entry.kind == Entry::Kind::Command)) {
+            throw FontError(line, name, "", "Code " + std::string(entry.code) + " has no text.");
+        }
+        if (entry.kind == Entry::Kind::Glyph) {
+            glyphDigits = glyphDigits == 0 ? entry.code.size() : std::min(glyphDigits, entry.code.size());
+            hasDigraphs |= entry.text.front() != '[' && isMultipleCharacters(entry.text);
+        }
+        entries.push_back(entry);
+    }
+
+    if (glyphDigits == 0) {
+        throw FontError(0, name, "", "The table has no glyphs.");
+    } else if (glyphDigits > 4) {
+        throw FontError(0, name, "", "Glyph codes must be 1 or 2 bytes.");
+    }
+    int byteWidth = glyphDigits / 2;
+
+    Font f(name, localeId, hasDigraphs, -1, false, 0, 0, "", byteWidth);
+    Font::Page page;
+    for (auto& entry: entries) {
+        if (entry.kind != Entry::Kind::Glyph && entry.code.size() != glyphDigits) {
+            throw FontError(entry.line, name, "", "Commands must have codes the same size as glyphs.");
+        }
+        if (entry.code.size() % glyphDigits != 0) {
+            throw FontError(entry.line, name, "", "Code " + std::string(entry.code) + " is not a whole number of " + std::to_string(byteWidth) + " byte glyph codes.");
+        }
+        auto codes = readCodes(entry.code, byteWidth);
+        switch (entry.kind) {
+        case Entry::Kind::Glyph:
+            // a sequence of codes is written for a word, so it can't stand for a single character.
+            if (codes.size() > 1 && entry.text.front() != '[' && !isMultipleCharacters(entry.text)) {
+                throw FontError(entry.line, name, "", "Code " + std::string(entry.code) + " is more than one glyph, but \"" + std::string(entry.text) + "\" is a single character.");
+            }
+            if (codes.size() == 1) {
+                page.addGlyph(stripBrackets(entry.text), Font::TextNode{static_cast<unsigned int>(codes.front())});
+            } else {
+                page.addNoun(stripBrackets(entry.text), Font::NounNode{std::move(codes)});
+            }
+            break;
+        case Entry::Kind::End:
+            f.addCommandData("End", Font::CommandNode{static_cast<unsigned int>(codes.front()), -1});
+            break;
+        case Entry::Kind::NewLine:
+            f.addCommandData("NewLine", Font::CommandNode{static_cast<unsigned int>(codes.front()), -1, true});
+            break;
+        case Entry::Kind::Command:
+            f.addCommandData(stripBrackets(entry.text), Font::CommandNode{static_cast<unsigned int>(codes.front()), -1});
+            break;
+        }
+    }
+    page.setMaxValue(byteWidth == 1 ? 0xFF : 0xFFFF);
+    f.addPage(std::move(page));
+
+    for (auto cd : {"End", "NewLine"}) {
+        try {
+            f.getCommandCode(cd);
+        } catch (CodeNotFound &e) {
+            throw FontError(0, name, "", std::string(cd) + " must be defined with a " + (cd[0] == 'E' ? '/' : '*') + " entry.");
+        }
+    }
+    f.validate(true);
+    return f;
+}
+
+} // namespace sable
@@ -0,0 +1,30 @@
+#ifndef SABLE_FONT_TBLBUILDER_H
+#define SABLE_FONT_TBLBUILDER_H
+
+#include <istream>
+#include <string>
+
+#include "font.h"
+
+namespace sable {
+
+// Builds a font from a Thingy table (.tbl), the usual romhacking format, without
+// going through YAML. Each line is one of:
+//   XX=text    a glyph. Longer codes (XXYY...) are read as bytes in ROM order.
+//   /XX=text   the End command.
+//   *XX=text   the NewLine command.
+//   $XX=name   a command called name.
+// Blank lines, lines starting with # or ; and @ table ids are skipped.
+//
+// The byte width is the length of the shortest glyph code. Glyphs with a longer
+// code become nouns with a code for each byte width of it. Digraphs are turned on
+// if any glyph is two or more characters long. Tables don't have widths, so every
+// glyph has a width of 0.
+struct TblBuilder
+{
+    static Font make(std::istream& input, const std::string& name, const std::string& localeId);
+};
+
+} // namespace sable
+
+#endif // SABLE_FONT_TBLBUILDER_H
@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <yaml-cpp/yaml.h>
+#include "font/fontlist.h"
+#include "font/fontcodegen.h"
+#include "wrapper/filesystem.h"
+
+// Compiles mapping files into a C++ source file of CompiledFont tables. See FontCodeGenerator.
+int main(int argc, char * argv[])
+{
+    using std::cerr;
+    std::string usage = std::string("Usage: ") + argv[0] +
+        " [--locale LOCALE] [--symbol NAME] OUTPUT MAPPING...\n"
+        "Writes every font in the mapping files (.yml or .tbl) to OUTPUT as C++ source, which\n"
+        "defines sable::generated::NAME (compiledFonts by default).\n";
+    std::string locale = "en_US.UTF8", symbol = "compiledFonts";
+    std::vector<std::string> paths;
+    for (int index = 1; index < argc; ++index) {
+        std::string argument = argv[index];
+        if ((argument == "--locale" || argument == "--symbol") && index + 1 < argc) {
+            (argument == "--locale" ? locale : symbol) = argv[++index];
+        } else if (argument == "-h" || argument == "--help") {
+            std::cout << usage;
+            return 0;
+        } else {
+            paths.push_back(argument);
+        }
+    }
+    if (paths.size() < 2) {
+        cerr << usage;
+        return 1;
+    }
+
+    try {
+        sable::FontList fonts(locale);
+        std::vector<std::string> sources;
+        for (auto path = paths.begin() + 1; path != paths.end(); ++path) {
+            if (fs::path(*path).extension() == ".tbl") {
+                std::ifstream table(*path, std::ios::binary);
+                if (!table) {
+                    cerr << *path << " could not be opened.\n";
+                    return 1;
+                }
+                fonts.loadTable(table, fs::path(*path).stem().string());
+            } else {
+                fonts.load(YAML::LoadFile(*path));
+            }
+            sources.push_back(fs::path(*path).filename().string());
+        }
+        auto names = fonts.getNames();
+        std::sort(names.begin(), names.end());
+        std::vector<const sable::Font*> built;
+        for (auto& name: names) {
+            built.push_back(&fonts.at(name));
+        }
+
+        // written to memory first, so a failure doesn't leave half a file behind.
+        std::ostringstream source;
+        std::string sourceList;
+        for (auto& name: sources) {
+            sourceList += (sourceList.empty() ? "" : ", ") + name;
+        }
+        sable::FontCodeGenerator::write(built, symbol, sourceList, source);
+        std::ofstream output(paths.front(), std::ios::binary);
+        if (!output || !(output << source.str())) {
+            cerr << paths.front() << " could not be written.\n";
+            return 1;
+        }
+    } catch (sable::FontError &e) {
+        cerr << "Error in input mapping file:\n" << e.what() << std::endl;
+        return 1;
+    } catch (YAML::Exception &e) {
+        cerr << "Error in input mapping file:\n" << e.what() << std::endl;
+        return 1;
+    } catch (std::runtime_error &e) {
+        cerr << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
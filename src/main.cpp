@@ -1,6 +1,9 @@
 #include <iostream>
+#include <fstream>
+#include <chrono>
 #include <cxxopts.hpp>
 #include "project/project.h"
+#include "data/mapper.h"
 #include "project/exceptions.h"
 #include "wrapper/filesystem.h"
 
@@ -14,6 +17,17 @@ int main(int argc, char * argv[])
             ("s,no-assembly", "Run without running Asar assembly.")
             ("a,no-script", "Run without updating the script.")
             ("p,project", "Project directory - defaults to working directory.", cxxopts::value<std::string>(), "DIR")
+            ("serve", "Answer JSON-RPC requests from an editor on standard input instead of building.")
+            ("check-fonts", "Build every font in the input mappings and report any errors instead of building.")
+            ("benchmark-compression", "Print how well each block compression codec does on the script instead of building.")
+            ("check", "Report every error and warning in the script, sorted by file and line, without writing anything.")
+            ("measure", "Print the size and width of every block and the ROM size the text needs without writing anything.")
+            ("optimize-dictionary", "Print suggested digraph and noun entries for unused font codes instead of building.")
+            ("stats", "Write glyph, digraph, noun, command and block statistics for the script to a JSON file, or CSV if its name ends in .csv.", cxxopts::value<std::string>(), "FILE")
+            ("dump", "Write the text in a ROM back out as a script instead of building.", cxxopts::value<std::string>(), "ROM")
+            ("dump-address", "Address of a block to dump instead of every table - can be used more than once.", cxxopts::value<std::vector<std::string>>(), "ADDRESS")
+            ("dump-type", "Font used to decode dumped text - defaults to the default mode.", cxxopts::value<std::string>(), "FONT")
+            ("dump-output", "File to write dumped text to - defaults to standard output.", cxxopts::value<std::string>(), "FILE")
             ("v,verbose", "Run with increased verbosity.")
             ("q,quiet", "Run with reduced verbosity.")
             ("no-pause", "Run without pausing at end of output.")
@@ -31,6 +45,7 @@ int main(int argc, char * argv[])
         } else if (options.count("q") > 0) {
             verbosity--;
         }
+        int exitCode = 0;
         bool isCurrentDirNotProject = options.count("project") > 0;
         fs::path starting_path = isCurrentDirNotProject ? options["project"].as<std::string>() : fs::current_path().string();
         if (showHelp) {
@@ -38,12 +53,73 @@ int main(int argc, char * argv[])
         } else {
             try {
                 sable::Project project = sable::Project::from(starting_path.string());
-                if (project) {
+                if (project && options.count("dump") > 0) {
+                    std::vector<int> addresses;
+                    if (options.count("dump-address") > 0) {
+                        for (auto& address: options["dump-address"].as<std::vector<std::string>>()) {
+                            auto value = sable::util::strToHex(address);
+                            if (value.second < 0) {
+                                throw sable::ConfigError(address + " is not a hex address.");
+                            }
+                            addresses.push_back(value.first);
+                        }
+                    }
+                    std::string mode = options.count("dump-type") > 0 ? options["dump-type"].as<std::string>() : "";
+                    std::ofstream outputFile;
+                    if (options.count("dump-output") > 0) {
+                        outputFile.open(options["dump-output"].as<std::string>(), std::ios::binary);
+                    }
+                    std::ostream& output = outputFile.is_open() ? outputFile : cout;
+                    auto start = std::chrono::steady_clock::now();
+                    auto size = project.dumpText(options["dump"].as<std::string>(), addresses, output, mode);
+                    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+                    if (verbosity > 0) {
+                        cerr << "Dumped " << size << " bytes in " << elapsed.count() * 1000 << " ms ("
+                             << (elapsed.count() > 0 ? size / elapsed.count() / 1000000 : 0) << " MB/s).\n";
+                    }
+                } else if (project && options.count("serve") > 0) {
+                    project.serve(std::cin, cout);
+                    // the output is for the editor, so there's no pause or trailing new line.
+                    return 0;
+                } else if (project && options.count("check-fonts") > 0) {
+                    if (project.checkFonts(cerr)) {
+                        cout << "All fonts are valid.\n";
+                    }
+                } else if (project && options.count("optimize-dictionary") > 0) {
+                    project.optimizeDictionary(cout);
+                } else if (project && options.count("check") > 0) {
+                    if (project.checkText(cout) > 0) {
+                        exitCode = 1;
+                    }
+                } else if (project && options.count("measure") > 0) {
+                    if (!project.measureText(cout)) {
+                        exitCode = 1;
+                    }
+                } else if (project && options.count("benchmark-compression") > 0) {
+                    project.benchmarkCompression(cout);
+                } else if (project) {
                     if (!options.count("a")) {
-                        project.parseText();
+                        std::shared_ptr<sable::ParseStats> stats;
+                        if (options.count("stats") > 0) {
+                            stats = std::make_shared<sable::ParseStats>();
+                        }
+                        project.parseText(stats);
                         if (verbosity > 1) {
                             cout << "Script parsing completed.\n";
                         }
+                        if (stats) {
+                            auto statsPath = options["stats"].as<std::string>();
+                            std::ofstream statsFile(statsPath);
+                            if (!statsFile) {
+                                cerr << "Could not open " << statsPath << " for writing.\n";
+                            } else if (fs::path(statsPath).extension() == ".csv") {
+                                stats->writeCsv(statsFile);
+                            } else {
+                                stats->writeJson(statsFile);
+                            }
+                        }
+                    } else if (options.count("stats") > 0) {
+                        cerr << "Statistics are only collected when the script is parsed.\n";
                     }
                     if (!options.count("s")) {
                         project.writePatchData();
@@ -69,7 +145,7 @@ int main(int argc, char * argv[])
             }
             cout << std::endl;
         }
-        return 0;
+        return exitCode;
     }  catch (cxxopts::option_not_exists_exception &e) {
         cerr << e.what() << std::endl;
         return 1;
@@ -0,0 +1,133 @@
+#include "asmwriter.h"
+
+namespace sable {
+
+AsmWriter::AsmWriter() : m_Output{nullptr}, m_BufferSize{0}
+{
+
+}
+
+AsmWriter::AsmWriter(std::ostream &output, std::size_t bufferSize)
+    : m_Output{&output}, m_BufferSize{bufferSize}
+{
+    m_Buffer.reserve(bufferSize);
+}
+
+AsmWriter::~AsmWriter()
+{
+    flush();
+}
+
+void AsmWriter::reserve(std::size_t count)
+{
+    if (m_Output != nullptr && m_Buffer.size() + count > m_BufferSize) {
+        flush();
+    }
+}
+
+AsmWriter &AsmWriter::append(std::string_view text)
+{
+    reserve(text.size());
+    m_Buffer.append(text);
+    return *this;
+}
+
+AsmWriter &AsmWriter::append(char c)
+{
+    reserve(1);
+    m_Buffer.push_back(c);
+    return *this;
+}
+
+AsmWriter &AsmWriter::newLine()
+{
+    return append('\n');
+}
+
+AsmWriter &AsmWriter::hex(std::uint64_t value, int minDigits)
+{
+    char digits[16];
+    auto result = std::to_chars(std::begin(digits), std::end(digits), value, 16);
+    int length = result.ptr - digits;
+    int padding = minDigits > length ? minDigits - length : 0;
+    reserve(1 + padding + length);
+    m_Buffer.push_back('$');
+    m_Buffer.append(padding, '0');
+    m_Buffer.append(digits, length);
+    return *this;
+}
+
+AsmWriter &AsmWriter::binary(std::uint64_t value, int width)
+{
+    char digits[65];
+    int length = width * 8;
+    digits[0] = '%';
+    for (int bit = 0; bit < length; ++bit) {
+        digits[length - bit] = (value >> bit) & 1 ? '1' : '0';
+    }
+    return append(std::string_view(digits, length + 1));
+}
+
+AsmWriter &AsmWriter::define(std::string_view label)
+{
+    return append('!').append(label);
+}
+
+AsmWriter &AsmWriter::label(std::string_view name)
+{
+    return append(name).append(":\n");
+}
+
+AsmWriter &AsmWriter::org(std::string_view target)
+{
+    return append("ORG ").append(target).newLine();
+}
+
+AsmWriter &AsmWriter::orgDefine(std::string_view label)
+{
+    return append("ORG ").define(label).newLine();
+}
+
+AsmWriter &AsmWriter::data(int width)
+{
+    switch (width) {
+    case 1:
+        return append("db ");
+    case 2:
+        return append("dw ");
+    case 3:
+        return append("dl ");
+    default:
+        throw std::logic_error("Unsupported address size " + std::to_string(width));
+    }
+}
+
+AsmWriter &AsmWriter::include(const fs::path &file, const fs::path &basePath, bool isBin)
+{
+    append(isBin ? "incbin " :"incsrc ");
+
+    if (basePath.empty() || file.string().find_first_of(basePath.string()) != 0) {
+        return append(file.generic_string());
+    }
+    // can't use fs::relative because g++ 7 doesn't support it.
+#ifdef NO_FS_RELATIVE
+    return append(file.generic_string().substr(basePath.generic_string().length() + 1));
+#else
+    return append(fs::relative(file, basePath).generic_string());
+#endif
+}
+
+void AsmWriter::flush()
+{
+    if (m_Output != nullptr && !m_Buffer.empty()) {
+        m_Output->write(m_Buffer.data(), m_Buffer.size());
+        m_Buffer.clear();
+    }
+}
+
+const std::string &AsmWriter::str() const
+{
+    return m_Buffer;
+}
+
+}
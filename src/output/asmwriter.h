@@ -0,0 +1,112 @@
+#ifndef SABLE_ASMWRITER_H
+#define SABLE_ASMWRITER_H
+
+#include <charconv>
+#include <cstdint>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "wrapper/filesystem.h"
+
+namespace sable {
+
+// Builds Asar source in a reusable buffer which is written out in large chunks.
+// Without an output stream, everything is kept in the buffer until it is read with str().
+class AsmWriter
+{
+public:
+    static constexpr std::size_t DEFAULT_BUFFER_SIZE = 0x10000;
+
+    AsmWriter();
+    explicit AsmWriter(std::ostream& output, std::size_t bufferSize = DEFAULT_BUFFER_SIZE);
+    AsmWriter(const AsmWriter&) = delete;
+    AsmWriter& operator=(const AsmWriter&) = delete;
+    ~AsmWriter();
+
+    AsmWriter& append(std::string_view text);
+    AsmWriter& append(char c);
+    AsmWriter& newLine();
+
+    // "$" followed by at least minDigits hex digits.
+    AsmWriter& hex(std::uint64_t value, int minDigits);
+    // "%" followed by exactly width * 8 binary digits.
+    AsmWriter& binary(std::uint64_t value, int width);
+    template<typename I>
+    std::enable_if_t<std::is_integral_v<I>, AsmWriter&> decimal(I value)
+    {
+        char digits[24];
+        auto result = std::to_chars(std::begin(digits), std::end(digits), value);
+        return append(std::string_view(digits, result.ptr - digits));
+    }
+    template<typename I>
+    std::enable_if_t<std::is_integral_v<I>, AsmWriter&> number(I value, int width, int base = 16)
+    {
+        if (base == 16) {
+            if (width > 4 || width <= 0) {
+                // Asar does support 4-byte data even though the SNES doesn't really.
+                throw std::runtime_error(std::string("Unsupported width ") +  std::to_string(width));
+            }
+            auto unsignedValue = static_cast<std::uint64_t>(static_cast<std::make_unsigned_t<I>>(value));
+            if (width < 4) {
+                unsignedValue &= (1ULL << (width * 8)) - 1;
+            }
+            return hex(unsignedValue, width * 2);
+        } else if (base == 10) {
+            return decimal(value);
+        } else if (base == 2) {
+            if (width > 4 || width <= 0) {
+                throw std::runtime_error(std::string("Unsupported width ") +  std::to_string(width));
+            }
+            return binary(static_cast<std::make_unsigned_t<I>>(value), width);
+        }
+        throw std::runtime_error(std::string("Unsupported base ") +  std::to_string(base));
+    }
+
+    AsmWriter& define(std::string_view label);
+    template<typename I>
+    std::enable_if_t<std::is_integral_v<I>, AsmWriter&> assignment(
+        std::string_view label,
+        I value,
+        int width,
+        int base = 16,
+        std::string_view baseLabel = ""
+    )
+    {
+        define(label).append(" = ");
+        if (!baseLabel.empty()) {
+            define(baseLabel);
+            if (value != 0) {
+                append('+').number(value, width, base);
+            }
+            return *this;
+        }
+        return number(value, width, base);
+    }
+    AsmWriter& label(std::string_view name);
+    AsmWriter& org(std::string_view target);
+    AsmWriter& orgDefine(std::string_view label);
+    template<typename I>
+    std::enable_if_t<std::is_integral_v<I>, AsmWriter&> org(I address)
+    {
+        return append("ORG ").number(address, 3).newLine();
+    }
+    // db, dw or dl depending on the width.
+    AsmWriter& data(int width);
+    AsmWriter& include(const fs::path &file, const fs::path &basePath, bool isBin);
+
+    void flush();
+    const std::string& str() const;
+private:
+    std::ostream* m_Output;
+    std::size_t m_BufferSize;
+    std::string m_Buffer;
+
+    void reserve(std::size_t count);
+};
+
+}
+
+#endif // SABLE_ASMWRITER_H
@@ -0,0 +1,57 @@
+#include "filewriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <vector>
+
+namespace sable {
+
+bool hasContents(const fs::path &file, const unsigned char *data, std::size_t size)
+{
+    if (!fs::is_regular_file(file) || fs::file_size(file) != size) {
+        return false;
+    }
+    std::ifstream input(file.string(), std::ios::binary);
+    constexpr std::size_t chunkSize = 0x10000;
+    std::vector<char> buffer(std::min(size, chunkSize));
+    for (std::size_t position = 0; position < size; position += buffer.size()) {
+        std::size_t count = std::min(buffer.size(), size - position);
+        if (!input.read(buffer.data(), count) || std::memcmp(buffer.data(), data + position, count) != 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool writeIfChanged(const fs::path &file, const unsigned char *data, std::size_t size)
+{
+    if (hasContents(file, data, size)) {
+        return false;
+    }
+    fs::path temporary = file;
+    temporary += ".tmp";
+    {
+        std::ofstream output(temporary.string(), std::ios::binary | std::ios::trunc);
+        if (!output || !output.write(reinterpret_cast<const char*>(data), size) || !output.flush()) {
+            output.close();
+            fs::remove(temporary);
+            throw std::runtime_error("Could not write " + file.string());
+        }
+    }
+    try {
+        fs::rename(temporary, file);
+    } catch (std::exception&) {
+        fs::remove(temporary);
+        throw std::runtime_error("Could not write " + file.string());
+    }
+    return true;
+}
+
+bool writeIfChanged(const fs::path &file, const std::string &data)
+{
+    return writeIfChanged(file, reinterpret_cast<const unsigned char*>(data.data()), data.size());
+}
+
+}
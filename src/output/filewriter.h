@@ -0,0 +1,23 @@
+#ifndef FILEWRITER_H
+#define FILEWRITER_H
+
+#include <cstddef>
+#include <string>
+
+#include "wrapper/filesystem.h"
+
+namespace sable {
+
+// Returns true if file exists and holds exactly size bytes matching data.
+bool hasContents(const fs::path& file, const unsigned char* data, std::size_t size);
+
+// Writes data to a temporary file next to file and renames it into place, so an
+// interrupted run never leaves a truncated file behind. A file which already holds
+// the same data is left alone, keeping its modification time.
+// Returns true if the file was written.
+bool writeIfChanged(const fs::path& file, const unsigned char* data, std::size_t size);
+bool writeIfChanged(const fs::path& file, const std::string& data);
+
+}
+
+#endif // FILEWRITER_H
@@ -2,29 +2,64 @@
 
 #include <stdexcept>
 #ifndef _WIN32
+#include <cerrno>
 #include <cstdio>
 #include <cstdlib>
 #include <cstring>
+#include <vector>
 #include <unistd.h>
 #include <fcntl.h>
+#include <poll.h>
 #else
 #include <windows.h>
 #endif
 
+namespace {
+    constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+#ifndef _WIN32
+    std::mutex& redirectMutex()
+    {
+        static std::mutex mutex;
+        return mutex;
+    }
+#endif
+}
+
 #ifndef _WIN32
 OutputCapture::OutputCapture(std::ostream& sink)
-    : OutputCapture(sink, O_NONBLOCK)
+    : OutputCapture(sink, 0)
 {
 
 }
 
 OutputCapture::OutputCapture(std::ostream &sink, int flags)
-    : out{sink}, buffer{0}, saved_stdout{dup(STDOUT_FILENO)}
+    : out{sink}, lock{redirectMutex()}, saved_stdout{-1}
 {
-    if(pipe2(out_pipe, flags) != 0 ) {
+    if(pipe2(out_pipe, flags | O_CLOEXEC) != 0 ) {
         auto errnoS = std::string{std::strerror(errno)};
         throw std::runtime_error("failed to capture output: " + errnoS);
     }
+    captured.reserve(BUFFER_SIZE);
+    drain = std::thread([this, fd = out_pipe[0]] {
+        std::vector<char> buffer(BUFFER_SIZE);
+        while (true) {
+            auto size = read(fd, buffer.data(), buffer.size());
+            if (size > 0) {
+                captured.append(buffer.data(), size);
+            } else if (size == 0) {
+                break;
+            } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                pollfd waiting{fd, POLLIN, 0};
+                poll(&waiting, 1, -1);
+            } else if (errno != EINTR) {
+                break;
+            }
+        }
+        close(fd);
+    });
+    std::fflush(stdout);
+    saved_stdout = dup(STDOUT_FILENO);
     dup2(out_pipe[1], STDOUT_FILENO);
     close(out_pipe[1]);
 }
@@ -40,22 +75,28 @@ OutputCapture::~OutputCapture()
 
 void OutputCapture::write()
 {
+    if (flushed && !needWrite) {
+        out << captured << std::flush;
+    }
     needWrite = true;
 }
 
 void OutputCapture::flush()
 {
+    if (flushed) {
+        return;
+    }
+    flushed = true;
 #ifndef _WIN32
-    fflush(stdout);
+    std::fflush(stdout);
+    // putting stdout back closes the last write end of the pipe, which ends the drain.
     dup2(saved_stdout, STDOUT_FILENO);
+    close(saved_stdout);
+    drain.join();
+    lock.unlock();
 
-    while(read(out_pipe[0], buffer, 101) > 0) {
-        if (needWrite) {
-            out << buffer;
-        }
-    }
     if (needWrite) {
-        out << std::flush;
+        out << captured << std::flush;
     }
 #else
     DWORD errCode = GetLastError();
@@ -72,15 +113,19 @@ void OutputCapture::flush()
         0,
         nullptr
     );
+    captured = errMsg;
+    if (errCode == ERROR_MOD_NOT_FOUND) {
+        captured += "Make sure that asar.dll is in the same folder as sable.\n";
+    }
 
     if (needWrite) {
-        out << std::string(errMsg);
-        if (errCode == ERROR_MOD_NOT_FOUND) {
-            out << "Make sure that asar.dll is in the same folder as sable.\n";
-        }
-        out << std::flush;
+        out << captured << std::flush;
     }
     LocalFree(errMsg);
 #endif
 }
 
+const std::string &OutputCapture::str() const
+{
+    return captured;
+}
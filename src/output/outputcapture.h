@@ -2,26 +2,43 @@
 #define OUTPUTCAPTURE_H
 
 #include <iostream>
+#include <mutex>
+#include <string>
+#ifndef _WIN32
+#include <thread>
+#endif
 
 // Asar will output an error if it fails to load its DLL from any one of the paths
 // This class captures that output and outputs only if all paths failed.
+//
+// stdout is redirected into a pipe which a background thread drains as it fills,
+// so a lot of output can't block whatever is writing it. The redirect affects the
+// whole process, so only one capture can be active at a time, and a second one
+// waits for the first to be flushed.
 class OutputCapture
 {
     std::ostream &out;
+    std::string captured;
 #ifndef _WIN32
-    char buffer[101];
+    std::unique_lock<std::mutex> lock;
     int saved_stdout;
     int out_pipe[2];
+    std::thread drain;
 #endif
     bool needWrite = false;
+    bool flushed = false;
 public:
     OutputCapture(std::ostream& sink);
 #ifndef _WIN32
     OutputCapture(std::ostream& sink, int flags);
 #endif
     ~OutputCapture();
+    // writes the output to the sink once capturing stops, or right away if it already has.
     void write();
+    // stops capturing, and writes the output to the sink if write() was called.
     void flush();
+    // everything captured, which is only complete after flush().
+    const std::string& str() const;
 };
 
 #endif // OUTPUTCAPTURE_H
@@ -0,0 +1,313 @@
+#include "patchcache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+
+#include "rompatcher.h"
+#include "filewriter.h"
+
+namespace sable {
+
+namespace {
+    const std::string MAGIC = "SABLEPC2";
+
+    // 64-bit FNV-1a, which doesn't change between builds or platforms like std::hash can.
+    class Hash
+    {
+        std::uint64_t m_Value = 0xcbf29ce484222325ull;
+    public:
+        void add(const void* data, std::size_t size)
+        {
+            auto* bytes = static_cast<const unsigned char*>(data);
+            for (std::size_t index = 0; index < size; ++index) {
+                m_Value = (m_Value ^ bytes[index]) * 0x100000001b3ull;
+            }
+        }
+        void add(std::string_view text)
+        {
+            add(static_cast<std::uint64_t>(text.size()));
+            add(text.data(), text.size());
+        }
+        void add(std::uint64_t value)
+        {
+            unsigned char bytes[8];
+            for (auto& byte: bytes) {
+                byte = value & 0xFF;
+                value >>= 8;
+            }
+            add(bytes, sizeof(bytes));
+        }
+        std::string hex() const
+        {
+            std::ostringstream output;
+            output << std::hex;
+            output.width(16);
+            output.fill('0');
+            output << m_Value;
+            return output.str();
+        }
+    };
+
+    std::optional<std::string> readFile(const fs::path& file)
+    {
+        std::ifstream input(file.string(), std::ios::binary);
+        if (!input) {
+            return std::nullopt;
+        }
+        return std::string(std::istreambuf_iterator<char>(input), {});
+    }
+
+    bool startsWith(std::string_view text, std::string_view prefix)
+    {
+        return text.size() >= prefix.size() && std::equal(prefix.begin(), prefix.end(), text.begin(), [] (char lhs, char rhs) {
+            return std::tolower(static_cast<unsigned char>(lhs)) == rhs;
+        });
+    }
+
+    std::string_view trim(std::string_view text)
+    {
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.front()))) {
+            text.remove_prefix(1);
+        }
+        while (!text.empty() && std::isspace(static_cast<unsigned char>(text.back()))) {
+            text.remove_suffix(1);
+        }
+        return text;
+    }
+
+    // splits a line of asm into its statements, which are separated by " : ", and drops its comment.
+    std::vector<std::string_view> statements(std::string_view line)
+    {
+        std::vector<std::string_view> result;
+        bool quoted = false;
+        std::size_t start = 0;
+        for (std::size_t index = 0; index < line.size(); ++index) {
+            if (line[index] == '"') {
+                quoted = !quoted;
+            } else if (quoted) {
+                continue;
+            } else if (line[index] == ';') {
+                line = line.substr(0, index);
+                break;
+            } else if (line.compare(index, 3, " : ") == 0) {
+                result.push_back(trim(line.substr(start, index - start)));
+                start = index + 3;
+            }
+        }
+        result.push_back(trim(line.substr(start)));
+        return result;
+    }
+
+    // the file named at the start of an incsrc, incbin or table statement's arguments.
+    std::string_view fileArgument(std::string_view arguments, bool isBinary)
+    {
+        arguments = trim(arguments);
+        if (!arguments.empty() && arguments.front() == '"') {
+            auto end = arguments.find('"', 1);
+            return end == std::string_view::npos ? std::string_view() : arguments.substr(1, end - 1);
+        }
+        auto name = arguments.substr(0, std::min(arguments.find_first_of(" \t,"), arguments.size()));
+        // incbin can be followed by a range of the file to include, like file.bin:10-20.
+        if (auto range = name.rfind(':'); isBinary && range != std::string_view::npos && range > 1) {
+            name = name.substr(0, range);
+        }
+        return name;
+    }
+}
+
+PatchCache::PatchCache(const fs::path &directory): m_Directory{directory}
+{
+}
+
+std::optional<std::vector<fs::path>> PatchCache::dependencies(const fs::path &patchFile)
+{
+    // files read by Asar functions aren't followed.
+    static constexpr std::string_view fileFunctions[] = {"readfile", "canreadfile", "filesize", "getfilestatus"};
+
+    std::vector<fs::path> files;
+    std::set<fs::path> seen;
+    auto patchDir = fs::absolute(patchFile).parent_path();
+    // Asar looks next to the file with the include first, then next to the patch.
+    auto resolve = [&patchDir] (const fs::path& includingDir, std::string_view name) -> std::optional<fs::path> {
+        if (name.empty() || name.find_first_of("!<>") != std::string_view::npos) {
+            return std::nullopt;
+        }
+        fs::path file{std::string(name)};
+        for (auto& candidate: {includingDir / file, patchDir / file}) {
+            if (fs::is_regular_file(candidate)) {
+                return fs::canonical(candidate);
+            }
+        }
+        return std::nullopt;
+    };
+
+    std::vector<std::pair<fs::path, bool>> pending{{fs::canonical(patchFile), false}};
+    while (!pending.empty()) {
+        auto [file, isBinary] = pending.back();
+        pending.pop_back();
+        if (!seen.insert(file).second) {
+            continue;
+        }
+        files.push_back(file);
+        if (isBinary) {
+            continue;
+        }
+        auto contents = readFile(file);
+        if (!contents) {
+            return std::nullopt;
+        }
+        std::vector<std::pair<fs::path, bool>> included;
+        std::string_view rest(*contents);
+        while (!rest.empty()) {
+            auto end = rest.find('\n');
+            auto line = rest.substr(0, end);
+            rest.remove_prefix(end == std::string_view::npos ? rest.size() : end + 1);
+            for (auto statement: statements(line)) {
+                std::string lowered(statement);
+                std::transform(lowered.begin(), lowered.end(), lowered.begin(), [] (unsigned char c) {
+                    return std::tolower(c);
+                });
+                for (auto function: fileFunctions) {
+                    if (lowered.find(function) != std::string::npos) {
+                        return std::nullopt;
+                    }
+                }
+                bool binary = startsWith(statement, "incbin ");
+                if (!binary && !startsWith(statement, "incsrc ") && !startsWith(statement, "table ")) {
+                    continue;
+                }
+                auto arguments = statement.substr(statement.find(' '));
+                auto path = resolve(file.parent_path(), fileArgument(arguments, binary));
+                if (!path) {
+                    return std::nullopt;
+                }
+                included.emplace_back(*path, binary);
+            }
+        }
+        // the includes are followed in the order they appear.
+        pending.insert(pending.end(), included.rbegin(), included.rend());
+    }
+    return files;
+}
+
+std::optional<std::string> PatchCache::key(const RomPatcher &rom, const fs::path &patchFile)
+{
+    auto files = dependencies(patchFile);
+    if (!files) {
+        return std::nullopt;
+    }
+    Hash hash;
+    hash.add(static_cast<std::uint64_t>(rom.m_MapType));
+    hash.add(static_cast<std::uint64_t>(rom.m_HeaderSize));
+    hash.add(static_cast<std::uint64_t>(rom.m_RomSize));
+    hash.add(std::string_view(reinterpret_cast<const char*>(rom.m_data.data()), rom.m_data.size()));
+    for (auto& file: *files) {
+        auto contents = readFile(file);
+        if (!contents) {
+            return std::nullopt;
+        }
+        hash.add(file.generic_string());
+        hash.add(*contents);
+    }
+    return hash.hex();
+}
+
+bool PatchCache::load(const std::string &name, const std::string &key, RomPatcher &rom) const
+{
+    auto contents = readFile(m_Directory / (name + ".cache"));
+    if (!contents) {
+        return false;
+    }
+    std::string_view rest(*contents);
+    // a file which ends early or was written by another version is a miss, not an error.
+    bool valid = true;
+    auto readBytes = [&rest, &valid] (std::size_t size) {
+        if (size > rest.size()) {
+            valid = false;
+            size = rest.size();
+        }
+        auto bytes = rest.substr(0, size);
+        rest.remove_prefix(size);
+        return bytes;
+    };
+    auto readNumber = [&readBytes] () {
+        std::uint32_t value = 0;
+        auto bytes = readBytes(4);
+        for (std::size_t byte = 0; byte < bytes.size(); ++byte) {
+            value |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[byte])) << (byte * 8);
+        }
+        return value;
+    };
+    auto readString = [&readBytes, &readNumber] () {
+        return std::string(readBytes(readNumber()));
+    };
+    if (readBytes(MAGIC.size()) != MAGIC || readString() != key || !valid) {
+        return false;
+    }
+    int romSize = readNumber();
+    auto data = readBytes(readNumber());
+    std::vector<AsarMessage> log;
+    for (auto count = readNumber(); valid && count > 0; --count) {
+        auto& message = log.emplace_back();
+        auto kind = readBytes(1);
+        message.kind = static_cast<AsarMessage::Kind>(kind.empty() ? 0 : kind.front());
+        message.text = readString();
+        message.file = readString();
+        message.line = static_cast<int>(readNumber());
+    }
+    std::vector<patch::Range> written;
+    for (auto count = readNumber(); valid && count > 0; --count) {
+        auto offset = readNumber();
+        written.push_back({offset, readNumber()});
+    }
+    if (!valid || data.size() != rom.m_data.size()) {
+        return false;
+    }
+    rom.m_data.assign(data.begin(), data.end());
+    rom.m_RomSize = romSize;
+    rom.m_Log = std::move(log);
+    rom.m_Written = std::move(written);
+    rom.m_AState = RomPatcher::AsarState::Success;
+    return true;
+}
+
+void PatchCache::store(const std::string &name, const std::string &key, const RomPatcher &rom) const
+{
+    std::string output = MAGIC;
+    auto writeNumber = [&output] (std::uint32_t value) {
+        for (int byte = 0; byte < 4; ++byte) {
+            output.push_back(static_cast<char>((value >> (byte * 8)) & 0xFF));
+        }
+    };
+    auto writeString = [&output, &writeNumber] (const std::string& value) {
+        writeNumber(value.size());
+        output.append(value);
+    };
+    writeString(key);
+    writeNumber(rom.m_RomSize);
+    writeNumber(rom.m_data.size());
+    output.append(rom.m_data.begin(), rom.m_data.end());
+    writeNumber(rom.m_Log.size());
+    for (auto& message: rom.m_Log) {
+        output.push_back(static_cast<char>(message.kind));
+        writeString(message.text);
+        writeString(message.file);
+        writeNumber(static_cast<std::uint32_t>(message.line));
+    }
+    writeNumber(rom.m_Written.size());
+    for (auto& range: rom.m_Written) {
+        writeNumber(range.offset);
+        writeNumber(range.length);
+    }
+    fs::create_directories(m_Directory);
+    writeIfChanged(m_Directory / (name + ".cache"), output);
+}
+
+}
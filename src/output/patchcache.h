@@ -0,0 +1,40 @@
+#ifndef PATCHCACHE_H
+#define PATCHCACHE_H
+
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "wrapper/filesystem.h"
+
+namespace sable {
+
+struct RomPatcher;
+
+// The last ROM Asar patched successfully for each output ROM, so a build where
+// neither the base ROM nor any file the patch includes has changed can reuse it
+// instead of assembling again.
+class PatchCache
+{
+    fs::path m_Directory;
+public:
+    explicit PatchCache(const fs::path& directory);
+    // A key for applying the patch at patchFile to the loaded and expanded ROM. It
+    // covers the ROM, its mapper and every file reachable through incsrc, incbin
+    // and table. Returns nullopt if the patch uses a file which can't be followed,
+    // like one named with a define, since a cached result couldn't be trusted.
+    static std::optional<std::string> key(const RomPatcher& rom, const fs::path& patchFile);
+    // The files the patch at patchFile reads, starting with itself, or nullopt if
+    // one can't be followed.
+    static std::optional<std::vector<fs::path>> dependencies(const fs::path& patchFile);
+    // Replaces the ROM, the ranges written to it and Asar's messages with the ones
+    // stored for name if they were stored with the same key. Returns false if they
+    // weren't.
+    bool load(const std::string& name, const std::string& key, RomPatcher& rom) const;
+    // Stores the patched ROM and its messages, replacing whatever name had before.
+    void store(const std::string& name, const std::string& key, const RomPatcher& rom) const;
+};
+
+}
+
+#endif // PATCHCACHE_H
@@ -0,0 +1,308 @@
+#include "patchwriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace sable {
+
+namespace patch {
+
+namespace {
+    constexpr std::size_t IPS_MAX_OFFSET = 0x1000000;
+    constexpr std::size_t IPS_MAX_RECORD = 0xFFFF;
+    // a record starting here would be read as the end of the patch.
+    constexpr std::size_t IPS_EOF_OFFSET = 0x454F46;
+    // runs shorter than this are cheaper to write as part of a normal record.
+    constexpr std::size_t IPS_MIN_RUN = 9;
+    constexpr std::size_t BPS_MIN_RUN = 4;
+
+    enum BpsAction {
+        SourceRead, TargetRead, SourceCopy, TargetCopy
+    };
+
+    std::size_t runLength(const std::vector<unsigned char>& data, std::size_t position, std::size_t end)
+    {
+        std::size_t length = 1;
+        while (position + length < end && data[position + length] == data[position]) {
+            ++length;
+        }
+        return length;
+    }
+
+    void writeBigEndian(std::ostream& output, std::size_t value, int bytes)
+    {
+        while (bytes-- > 0) {
+            output.put(static_cast<char>((value >> (bytes * 8)) & 0xFF));
+        }
+    }
+
+    class IpsWriter {
+        std::ostream& output;
+        const std::vector<unsigned char>& target;
+    public:
+        IpsWriter(std::ostream& out, const std::vector<unsigned char>& data): output{out}, target{data} {}
+
+        void literal(std::size_t offset, std::size_t length)
+        {
+            while (length > 0) {
+                if (offset == IPS_EOF_OFFSET) {
+                    // start one byte earlier instead.
+                    literal(offset - 1, 2);
+                    ++offset;
+                    --length;
+                    continue;
+                }
+                std::size_t count = std::min(length, IPS_MAX_RECORD);
+                writeBigEndian(output, offset, 3);
+                writeBigEndian(output, count, 2);
+                output.write(reinterpret_cast<const char*>(target.data() + offset), count);
+                offset += count;
+                length -= count;
+            }
+        }
+
+        void run(std::size_t offset, std::size_t length)
+        {
+            if (offset == IPS_EOF_OFFSET) {
+                literal(offset - 1, 2);
+                ++offset;
+                --length;
+            }
+            if (length == 0) {
+                return;
+            }
+            writeBigEndian(output, offset, 3);
+            writeBigEndian(output, 0, 2);
+            writeBigEndian(output, length, 2);
+            output.put(static_cast<char>(target[offset]));
+        }
+
+        void range(std::size_t start, std::size_t end)
+        {
+            if (end > IPS_MAX_OFFSET) {
+                throw std::runtime_error("IPS patches can't change data past 16 MB.");
+            }
+            std::size_t literalStart = start;
+            for (std::size_t position = start; position < end; ) {
+                std::size_t length = std::min(runLength(target, position, end), IPS_MAX_RECORD);
+                if (length >= IPS_MIN_RUN) {
+                    literal(literalStart, position - literalStart);
+                    run(position, length);
+                    literalStart = position + length;
+                }
+                position += length;
+            }
+            literal(literalStart, end - literalStart);
+        }
+    };
+
+    void writeNumber(std::string& output, std::uint64_t value)
+    {
+        while (true) {
+            unsigned char bits = value & 0x7F;
+            value >>= 7;
+            if (value == 0) {
+                output.push_back(0x80 | bits);
+                break;
+            }
+            output.push_back(bits);
+            --value;
+        }
+    }
+
+    void writeAction(std::string& output, BpsAction action, std::size_t length)
+    {
+        writeNumber(output, ((length - 1) << 2) | action);
+    }
+
+    void writeCrc(std::string& output, std::uint32_t crc)
+    {
+        for (int byte = 0; byte < 4; ++byte) {
+            output.push_back((crc >> (byte * 8)) & 0xFF);
+        }
+    }
+}
+
+Format parseFormat(const std::string &name)
+{
+    if (name == "ips") {
+        return Format::IPS;
+    } else if (name == "bps") {
+        return Format::BPS;
+    }
+    throw std::runtime_error("ips or bps.");
+}
+
+std::string getExtension(Format format)
+{
+    switch (format) {
+    case Format::IPS:
+        return ".ips";
+    case Format::BPS:
+        return ".bps";
+    default:
+        throw std::logic_error("Undefined patch format.");
+    }
+}
+
+std::vector<Range> merge(std::vector<Range> ranges)
+{
+    std::sort(ranges.begin(), ranges.end(), [] (const Range& lhs, const Range& rhs) {
+        return lhs.offset < rhs.offset;
+    });
+    std::vector<Range> merged;
+    for (auto& range: ranges) {
+        if (!merged.empty() && range.offset <= merged.back().offset + merged.back().length) {
+            merged.back().length = std::max(merged.back().length, range.offset + range.length - merged.back().offset);
+        } else {
+            merged.push_back(range);
+        }
+    }
+    return merged;
+}
+
+std::vector<Range> diff(
+    const unsigned char *base,
+    std::size_t baseSize,
+    const unsigned char *target,
+    std::size_t targetSize,
+    std::size_t mergeGap
+) {
+    std::vector<Range> ranges;
+    auto addChange = [&ranges, mergeGap] (std::size_t start, std::size_t end) {
+        if (!ranges.empty() && start - (ranges.back().offset + ranges.back().length) < mergeGap) {
+            ranges.back().length = end - ranges.back().offset;
+        } else {
+            ranges.push_back({start, end - start});
+        }
+    };
+    std::size_t common = std::min(baseSize, targetSize);
+    std::size_t position = 0;
+    while (position < common) {
+        // skip over matching data a word at a time.
+        while (position + sizeof(std::uint64_t) <= common) {
+            std::uint64_t lhs, rhs;
+            std::memcpy(&lhs, base + position, sizeof(lhs));
+            std::memcpy(&rhs, target + position, sizeof(rhs));
+            if (lhs != rhs) {
+                break;
+            }
+            position += sizeof(std::uint64_t);
+        }
+        while (position < common && base[position] == target[position]) {
+            ++position;
+        }
+        if (position == common) {
+            break;
+        }
+        std::size_t start = position;
+        while (position < common && base[position] != target[position]) {
+            ++position;
+        }
+        addChange(start, position);
+    }
+    if (targetSize > baseSize) {
+        addChange(baseSize, targetSize);
+    }
+    return ranges;
+}
+
+void writeIps(std::ostream &output, const std::vector<unsigned char> &base, const std::vector<unsigned char> &target)
+{
+    output.write("PATCH", 5);
+    IpsWriter writer(output, target);
+    for (auto& range: diff(base.data(), base.size(), target.data(), target.size())) {
+        writer.range(range.offset, range.offset + range.length);
+    }
+    output.write("EOF", 3);
+    if (target.size() < base.size()) {
+        // the truncation extension supported by most patchers.
+        writeBigEndian(output, target.size(), 3);
+    }
+}
+
+void writeBps(std::ostream &output, const std::vector<unsigned char> &base, const std::vector<unsigned char> &target)
+{
+    std::string patch = "BPS1";
+    writeNumber(patch, base.size());
+    writeNumber(patch, target.size());
+    // no metadata.
+    writeNumber(patch, 0);
+
+    std::size_t outputOffset = 0, targetRelativeOffset = 0;
+    auto targetRead = [&] (std::size_t start, std::size_t end) {
+        if (start < end) {
+            writeAction(patch, TargetRead, end - start);
+            patch.append(reinterpret_cast<const char*>(target.data() + start), end - start);
+        }
+    };
+    for (auto& range: diff(base.data(), base.size(), target.data(), target.size())) {
+        if (range.offset > outputOffset) {
+            writeAction(patch, SourceRead, range.offset - outputOffset);
+        }
+        std::size_t end = range.offset + range.length;
+        std::size_t literalStart = range.offset;
+        for (std::size_t position = range.offset; position < end; ) {
+            std::size_t length = runLength(target, position, end);
+            if (length >= BPS_MIN_RUN) {
+                // write the first byte, then copy it forward over the rest of the run.
+                targetRead(literalStart, position + 1);
+                writeAction(patch, TargetCopy, length - 1);
+                std::int64_t relative = static_cast<std::int64_t>(position) - static_cast<std::int64_t>(targetRelativeOffset);
+                writeNumber(patch, (static_cast<std::uint64_t>(relative < 0 ? -relative : relative) << 1) | (relative < 0 ? 1 : 0));
+                targetRelativeOffset = position + length - 1;
+                literalStart = position + length;
+            }
+            position += length;
+        }
+        targetRead(literalStart, end);
+        outputOffset = end;
+    }
+    if (outputOffset < target.size()) {
+        writeAction(patch, SourceRead, target.size() - outputOffset);
+    }
+    writeCrc(patch, crc32(base.data(), base.size()));
+    writeCrc(patch, crc32(target.data(), target.size()));
+    writeCrc(patch, crc32(reinterpret_cast<const unsigned char*>(patch.data()), patch.size()));
+    output.write(patch.data(), patch.size());
+}
+
+void write(Format format, std::ostream &output, const std::vector<unsigned char> &base, const std::vector<unsigned char> &target)
+{
+    switch (format) {
+    case Format::IPS:
+        writeIps(output, base, target);
+        break;
+    case Format::BPS:
+        writeBps(output, base, target);
+        break;
+    default:
+        throw std::logic_error("Undefined patch format.");
+    }
+}
+
+std::uint32_t crc32(const unsigned char *data, std::size_t size, std::uint32_t crc)
+{
+    static const auto table = [] () {
+        std::array<std::uint32_t, 256> values{};
+        for (std::uint32_t index = 0; index < values.size(); ++index) {
+            std::uint32_t value = index;
+            for (int bit = 0; bit < 8; ++bit) {
+                value = (value & 1) ? 0xEDB88320 ^ (value >> 1) : value >> 1;
+            }
+            values[index] = value;
+        }
+        return values;
+    }();
+    crc = ~crc;
+    for (std::size_t index = 0; index < size; ++index) {
+        crc = table[(crc ^ data[index]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+}
+
+}
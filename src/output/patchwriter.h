@@ -0,0 +1,49 @@
+#ifndef PATCHWRITER_H
+#define PATCHWRITER_H
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace sable {
+
+namespace patch {
+
+enum class Format {
+    IPS, BPS
+};
+
+struct Range {
+    std::size_t offset;
+    std::size_t length;
+};
+
+Format parseFormat(const std::string& name);
+std::string getExtension(Format format);
+
+// Finds the ranges where target differs from base, comparing 8 bytes at a time.
+// Ranges closer together than mergeGap are joined, and anything past the end of base counts as changed.
+std::vector<Range> diff(
+    const unsigned char* base,
+    std::size_t baseSize,
+    const unsigned char* target,
+    std::size_t targetSize,
+    std::size_t mergeGap = 8
+);
+
+// Sorts ranges and joins the ones which overlap or touch.
+std::vector<Range> merge(std::vector<Range> ranges);
+
+// IPS offsets are limited to 24 bits, so target can't be larger than 16 MB.
+void writeIps(std::ostream& output, const std::vector<unsigned char>& base, const std::vector<unsigned char>& target);
+void writeBps(std::ostream& output, const std::vector<unsigned char>& base, const std::vector<unsigned char>& target);
+void write(Format format, std::ostream& output, const std::vector<unsigned char>& base, const std::vector<unsigned char>& target);
+
+std::uint32_t crc32(const unsigned char* data, std::size_t size, std::uint32_t crc = 0);
+
+}
+
+}
+
+#endif // PATCHWRITER_H
@@ -1,4 +1,5 @@
 #include "rompatcher.h"
+#include "filewriter.h"
 #include "asar/asardll.h"
 #include <fstream>
 #include <algorithm>
@@ -6,13 +7,14 @@
 #include <iomanip>
 #include <bitset>
 #include <cmath>
+#include <optional>
 #include "wrapper/filesystem.h"
 
 #include "data/addresslist.h"
 #include "data/optionhelpers.h"
 
 #include "outputcapture.h"
-#include "formatter.h"
+#include "asmwriter.h"
 
 
 bool sable::RomPatcher::succeeded(AsarState state)
@@ -26,7 +28,7 @@ bool sable::RomPatcher::wasRun(AsarState state)
 }
 
 sable::RomPatcher::RomPatcher(const util::MapperType& mapper)
-    : m_MapType(mapper), m_AState(AsarState::NotRun)
+    : m_RomSize(0), m_HeaderSize(0), m_MapType(mapper), m_AState(AsarState::NotRun)
 {
 
 }
@@ -38,7 +40,7 @@ sable::RomPatcher::~RomPatcher()
     }
 }
 
-bool sable::RomPatcher::loadRom(const std::string &file, const std::string &name, int header)
+bool sable::RomPatcher::loadRom(const std::string &file, const std::string &name, int header, bool keepBase)
 {
     if (!fs::exists(fs::path(file))) {
         return false;
@@ -80,6 +82,15 @@ bool sable::RomPatcher::loadRom(const std::string &file, const std::string &name
     m_RomSize = size - m_HeaderSize;
     m_data.resize(size);
     inFile.read((char*)&m_data[0], size);
+    m_Written.clear();
+    if (keepBase) {
+        m_Base = m_data;
+    } else {
+        m_Base.clear();
+    }
+    m_Source = std::to_string(size) + ' '
+            + std::to_string(fs::last_write_time(file).time_since_epoch().count()) + ' '
+            + fs::canonical(file).string();
 
     inFile.close();
     return true;
@@ -88,6 +99,8 @@ bool sable::RomPatcher::loadRom(const std::string &file, const std::string &name
 void sable::RomPatcher::clear()
 {
     m_data.clear();
+    m_Base.clear();
+    m_Written.clear();
 }
 
 bool sable::RomPatcher::expand(int size, const util::Mapper& mapper)
@@ -100,6 +113,9 @@ bool sable::RomPatcher::expand(int size, const util::Mapper& mapper)
     }
     auto oldsize = m_RomSize;
     m_RomSize = size;
+    if (m_RomSize > oldsize) {
+        m_Written.push_back({static_cast<std::size_t>(m_HeaderSize + oldsize), static_cast<std::size_t>(m_RomSize - oldsize)});
+    }
     m_data.resize(m_HeaderSize + m_RomSize, 0);
     util::Mapper oldMapper(m_MapType, m_HeaderSize != 0, true, util::NORMAL_ROM_MAX_SIZE);
     if (oldsize <= util::NORMAL_ROM_MAX_SIZE && m_RomSize > util::NORMAL_ROM_MAX_SIZE) {
@@ -133,6 +149,7 @@ bool sable::RomPatcher::expand(int size, const util::Mapper& mapper)
         *(newHeader+0x17) = ceil(log((int)(m_RomSize/1024)) / log(2));
         *(oldHeader+0x15) |= modeMask;
         *(newHeader+0x15) |= modeMask;
+        m_Written.push_back({static_cast<std::size_t>(oldHeader - m_data.begin()) + 0x15, 3});
     }
     return true;
 }
@@ -144,21 +161,55 @@ auto sable::RomPatcher::applyPatchFile(const std::string &path, const std::strin
         throw std::logic_error("Could not open " + path + " patch file.");
     }
 
-    std::ostringstream sink;
-    OutputCapture buffer{sink};
+    m_Log.clear();
     if (format == "asm") {
-        if (asar_init()) {
-            if (asar_patch(path.c_str(), (char*)&m_data[m_HeaderSize], m_RomSize, &m_RomSize)) {
-                m_AState = AsarState::Success;
-            } else {
-                m_AState = AsarState::Error;
+        // loading the library is the only time Asar writes to stdout instead of its own lists.
+        std::ostringstream sink;
+        bool initialized;
+        {
+            OutputCapture buffer{sink};
+            initialized = asar_init();
+            if (!initialized) {
+                buffer.write();
             }
-        } else {
+        }
+        if (!initialized) {
             m_AState = AsarState::InitFailed;
-            buffer.write();
-            buffer.flush();
             throw std::runtime_error(std::string{"Failed to initialize Asar library: "} + sink.str());
         }
+        if (asar_patch(path.c_str(), (char*)&m_data[m_HeaderSize], m_RomSize, &m_RomSize)) {
+            m_AState = AsarState::Success;
+            int count;
+            auto* blocks = asar_getwrittenblocks(&count);
+            for (int i = 0; i < count; i++) {
+                m_Written.push_back({
+                    static_cast<std::size_t>(m_HeaderSize + blocks[i].pcoffset),
+                    static_cast<std::size_t>(blocks[i].numbytes)
+                });
+            }
+        } else {
+            m_AState = AsarState::Error;
+        }
+        // Asar's lists are only valid until the next patch, so they're copied.
+        int count;
+        auto* prints = asar_getprints(&count);
+        for (int i = 0; i < count; i++) {
+            m_Log.push_back({AsarMessage::Kind::Print, prints[i], "", -1});
+        }
+        auto copy = [this] (AsarMessage::Kind kind, const errordata* messages, int count) {
+            for (int i = 0; i < count; i++) {
+                m_Log.push_back({
+                    kind,
+                    messages[i].fullerrdata != nullptr ? messages[i].fullerrdata : "",
+                    messages[i].filename != nullptr ? messages[i].filename : "",
+                    messages[i].line
+                });
+            }
+        };
+        auto* warnings = asar_getwarnings(&count);
+        copy(AsarMessage::Kind::Warning, warnings, count);
+        auto* errors = asar_geterrors(&count);
+        copy(AsarMessage::Kind::Error, errors, count);
     } else {
         m_AState = AsarState::Error;
     }
@@ -168,111 +219,315 @@ auto sable::RomPatcher::applyPatchFile(const std::string &path, const std::strin
 
 unsigned char &sable::RomPatcher::at(int n)
 {
-    return m_data.at(n);
+    auto& byte = m_data.at(n);
+    m_Written.push_back({static_cast<std::size_t>(n), 1});
+    return byte;
 }
 
 bool sable::RomPatcher::getMessages(std::back_insert_iterator<std::vector<std::string> > v)
 {
-    int count;
+    AsarMessage::Kind kind;
     if (m_AState == AsarState::Error) {
-        auto* error = asar_geterrors(&count);
-        for (int i = 0; i < count; i++){
-            *(v++) = error[i].fullerrdata;
-        }
+        kind = AsarMessage::Kind::Error;
     } else if (m_AState == AsarState::Success) {
-        auto* prints = asar_getprints(&count);
-        for (int i = 0; i < count; i++){
-            *(v++) = prints[i];
-        }
+        kind = AsarMessage::Kind::Print;
     } else {
         return false;
     }
+    for (auto& message: m_Log) {
+        if (message.kind == kind) {
+            *(v++) = message.text;
+        }
+    }
     return true;
 }
 
+auto sable::RomPatcher::getLog() const -> const std::vector<AsarMessage>&
+{
+    return m_Log;
+}
+
 int sable::RomPatcher::getRealSize() const
 {
     return m_data.size();
 }
 
+const unsigned char *sable::RomPatcher::getRomData() const
+{
+    return m_data.data() + m_HeaderSize;
+}
+
+int sable::RomPatcher::getRomSize() const
+{
+    return m_RomSize;
+}
+
+namespace {
+    const std::string RECORD_HEADER = "sable written ranges 1";
+
+    // the modification time and size which identify an output ROM as the one a record describes.
+    std::string describeOutput(const std::string& file)
+    {
+        std::error_code error;
+        auto size = fs::file_size(file, error);
+        auto time = fs::last_write_time(file, error);
+        if (error) {
+            return "";
+        }
+        return std::to_string(size) + ' ' + std::to_string(time.time_since_epoch().count());
+    }
+
+    std::optional<std::vector<sable::patch::Range>> readRecord(
+        const fs::path& record,
+        const std::string& source,
+        const std::string& output
+    ) {
+        std::ifstream input(record.string());
+        std::string line;
+        if (!input || !std::getline(input, line) || line != RECORD_HEADER) {
+            return std::nullopt;
+        }
+        std::string recordedSource, recordedOutput;
+        std::getline(input, recordedSource);
+        std::getline(input, recordedOutput);
+        if (!input || recordedSource != source || output.empty() || recordedOutput != output) {
+            return std::nullopt;
+        }
+        std::vector<sable::patch::Range> ranges;
+        for (sable::patch::Range range; input >> range.offset >> range.length; ) {
+            ranges.push_back(range);
+        }
+        if (!input.eof()) {
+            return std::nullopt;
+        }
+        return ranges;
+    }
+}
+
+std::size_t sable::RomPatcher::writeRom(const std::string &file, const fs::path &record) const
+{
+    auto written = patch::merge(m_Written);
+    auto previous = readRecord(record, m_Source, describeOutput(file));
+    // a record which can't be replaced mustn't be trusted next time.
+    std::error_code error;
+    fs::remove(record, error);
+
+    std::size_t count = 0;
+    if (previous && fs::file_size(file) == m_data.size()) {
+        // bytes the last build wrote which this one didn't go back to the loaded ROM's.
+        previous->insert(previous->end(), written.begin(), written.end());
+        std::fstream output(file, std::ios::in|std::ios::out|std::ios::binary);
+        for (auto& range: patch::merge(std::move(*previous))) {
+            if (range.offset >= m_data.size()) {
+                continue;
+            }
+            auto length = std::min(range.length, m_data.size() - range.offset);
+            output.seekp(range.offset);
+            output.write(reinterpret_cast<const char*>(m_data.data() + range.offset), length);
+            count += length;
+        }
+        if (!output) {
+            throw std::runtime_error(file + " could not be written.");
+        }
+    } else {
+        std::ofstream output(file, std::ios::out|std::ios::binary);
+        output.write(reinterpret_cast<const char*>(m_data.data()), m_data.size());
+        if (!output) {
+            throw std::runtime_error(file + " could not be written.");
+        }
+        count = m_data.size();
+    }
+
+    fs::create_directories(record.parent_path(), error);
+    std::ofstream output(record.string());
+    output << RECORD_HEADER << '\n' << m_Source << '\n' << describeOutput(file) << '\n';
+    for (auto& range: written) {
+        output << range.offset << ' ' << range.length << '\n';
+    }
+    if (!output) {
+        output.close();
+        fs::remove(record, error);
+    }
+    return count;
+}
+
+void sable::RomPatcher::writePatch(patch::Format format, std::ostream &output) const
+{
+    if (m_Base.empty()) {
+        throw std::logic_error("The ROM was loaded without keeping a copy to make patches against.");
+    }
+    patch::write(format, output, m_Base, m_data);
+}
+
 void sable::RomPatcher::writeParsedData(const sable::AddressList &addresses, const fs::path& includePath, std::ostream &mainText, std::ostream &textDefines)
 {
+    AsmWriter text(mainText), defines(textDefines);
+    std::string define;
     int predictedNextAddress = 0;
     for (auto& node: addresses) {
         if (node.isTable) {
-            textDefines << formatter::generateAssignment("def_table_" + node.label, node.address, 3) << '\n';
-            mainText  << "ORG " + formatter::generateDefine("def_table_" + node.label) + '\n';
+            define.assign("def_table_").append(node.label);
+            defines.assignment(define, node.address, 3).newLine();
+            text.orgDefine(define);
             const Table& t = addresses.getTable(node.label);
-            mainText << "table_" + node.label + ":\n";
+            text.append("table_").label(node.label);
             for (auto it : t) {
                 int size = 0;
-                std::string dataType;
-                if (t.getAddressSize() == 3) {
-                    dataType = "dl";
-                } else if(t.getAddressSize() == 2) {
-                    dataType = "dw";
-                } else {
-                    throw std::logic_error("Unsupported address size " + std::to_string(t.getAddressSize()));
-                }
+                text.data(t.getAddressSize());
                 if (it.address > 0) {
-                    mainText << dataType + ' ' + formatter::generateNumber(it.address, t.getAddressSize());
+                    text.number(it.address, t.getAddressSize());
                     size = it.size;
                 } else {
-                    mainText << dataType + ' ' + it.label;
-                    size = addresses.getFile(it.label).size;
+                    text.append(it.label);
+                    size = addresses.getSize(it.label);
                 }
                 if (t.getStoreWidths()) {
-                    mainText << ", " << std::dec << size;
+                    text.append(", ").decimal(size);
                 }
-                mainText << '\n';
+                text.newLine();
             }
         } else {
-            auto file = addresses.getFile(node.label);
+            define.assign("def_").append(node.label);
+            if (auto alias = addresses.findAlias(node.label); alias != nullptr) {
+                // the data is already in the ROM under another label, so only the label is assigned.
+                defines.assignment(define, node.address, 3).newLine();
+                if (options::isEnabled(alias->exportWidth)) {
+                    defines.assignment(define + "_length", alias->size, 3, 10).newLine();
+                }
+                text.append(node.label).append(" = ").define(define).append(" ; same data as ").append(alias->target).newLine();
+                continue;
+            }
+            auto& file = addresses.getFile(node.label);
             if (node.label.front() == '$') {
-                mainText  << "ORG " + formatter::generateNumber(node.address, 3) << '\n';
+                text.org(node.address);
             } else {
                 if (predictedNextAddress == 0 ||
                     predictedNextAddress != node.address ||
                     options::isEnabled(file.exportAddress)
                 ) {
-                    textDefines << formatter::generateAssignment("def_" + node.label, node.address, 3) + '\n';
-                    mainText  << "ORG " + formatter::generateDefine("def_" + node.label) + '\n';
+                    defines.assignment(define, node.address, 3).newLine();
+                    text.orgDefine(define);
                 }
                 if (options::isEnabled(file.exportWidth)) {
-                    textDefines <<
-                        formatter::generateAssignment(
-                            "def_" + node.label + "_length",
-                            file.size,
-                            3,
-                            10
-                        ) + '\n'
-                    ;
+                    defines.assignment(define + "_length", file.size, 3, 10).newLine();
                 }
-                mainText << node.label + ":\n";
+                text.label(node.label);
             }
 
-            mainText << formatter::generateInclude(includePath / file.files , fs::path(), true) + '\n';
+            text.include(includePath / file.files , fs::path(), true).newLine();
             if (file.printpc) {
-                mainText << "print pc\n";
+                text.append("print pc\n");
             }
             predictedNextAddress = node.address + file.size;
         }
-        mainText << '\n';
+        text.newLine();
     }
 }
 
 void sable::RomPatcher::writeInclude(const std::string include, std::ostream &mainFile, const fs::path &includePath)
 {
-    mainFile << formatter::generateInclude(includePath / include, fs::path(), false) << '\n';
+    AsmWriter(mainFile).include(includePath / include, fs::path(), false).newLine();
 }
 
 void sable::RomPatcher::writeIncludes(sable::ConstStringIterator start, sable::ConstStringIterator end, std::ostream &mainFile, const fs::path& includePath)
 {
+    AsmWriter output(mainFile);
     for (auto it = start; it != end; ++it) {
-        mainFile << formatter::generateInclude(includePath / *it, fs::path(), false) << '\n';
+        output.include(includePath / *it, fs::path(), false).newLine();
     }
 }
 
+void sable::RomPatcher::writeWidthTable(const std::vector<int> &widths, const fs::path &file)
+{
+    std::vector<unsigned char> data(widths.begin(), widths.end());
+    try {
+        writeIfChanged(file, data.data(), data.size());
+    } catch (std::runtime_error&) {
+        throw std::runtime_error("Could not write width table to " + file.string());
+    }
+}
+
+void sable::RomPatcher::writeDecompressor(compression::Codec codec, std::ostream &output)
+{
+    if (codec != compression::Codec::LZ) {
+        throw std::logic_error("No decompressor for codec " + compression::getCodecName(codec));
+    }
+    output <<
+        "; Decompresses a block compressed with Sable's lz codec.\n"
+        "; In:  [$00] - 24-bit pointer to the compressed block.\n"
+        ";      [$03] - 24-bit pointer to the output buffer.\n"
+        "; Uses $06-$0B as scratch space. A, X and Y are not preserved.\n"
+        "sable_decompress_lz:\n"
+        "    php\n"
+        "    rep #$30\n"
+        "    ldy #$0000\n"
+        "    lda [$00],y\n"
+        "    sta $06\n"
+        "    iny\n"
+        "    iny\n"
+        "    ldx #$0000\n"
+        ".next:\n"
+        "    cpx $06\n"
+        "    bcs .done\n"
+        "    sep #$20\n"
+        "    lda [$00],y\n"
+        "    iny\n"
+        "    cmp #$80\n"
+        "    bcs .copy\n"
+        "    rep #$20\n"
+        "    and #$007F\n"
+        "    inc a\n"
+        "    sta $08\n"
+        ".literal:\n"
+        "    sep #$20\n"
+        "    lda [$00],y\n"
+        "    iny\n"
+        "    phy\n"
+        "    txy\n"
+        "    sta [$03],y\n"
+        "    ply\n"
+        "    inx\n"
+        "    rep #$20\n"
+        "    dec $08\n"
+        "    bne .literal\n"
+        "    bra .next\n"
+        ".copy:\n"
+        "    rep #$20\n"
+        "    and #$007F\n"
+        "    clc\n"
+        "    adc #$0003\n"
+        "    sta $08\n"
+        "    sep #$20\n"
+        "    lda [$00],y\n"
+        "    iny\n"
+        "    rep #$20\n"
+        "    and #$00FF\n"
+        "    inc a\n"
+        "    sta $0A\n"
+        "    phy\n"
+        "    txa\n"
+        "    sec\n"
+        "    sbc $0A\n"
+        "    tay\n"
+        ".copy_byte:\n"
+        "    sep #$20\n"
+        "    lda [$03],y\n"
+        "    phy\n"
+        "    txy\n"
+        "    sta [$03],y\n"
+        "    ply\n"
+        "    iny\n"
+        "    inx\n"
+        "    rep #$20\n"
+        "    dec $08\n"
+        "    bne .copy_byte\n"
+        "    ply\n"
+        "    bra .next\n"
+        ".done:\n"
+        "    plp\n"
+        "    rtl\n";
+}
+
 std::string sable::RomPatcher::getMapperDirective(const util::MapperType& mapper)
 {
     std::string value;
@@ -295,11 +550,6 @@ std::string sable::RomPatcher::getMapperDirective(const util::MapperType& mapper
     return value;
 }
 
-//int sable::RomPatcher::getRomSize() const
-//{
-//    return m_RomSize;
-//}
-
 //unsigned char &sable::RomPatcher::atROMAddr(int n)
 //{
 //    int addr = util::ROMToPC(m_MapType, n);
@@ -11,53 +11,98 @@
 #include "data/addresslist.h"
 #include "data/table.h"
 #include "data/mapper.h"
+#include "data/compression.h"
 #include "font/font.h"
+#include "output/asmwriter.h"
+#include "output/patchwriter.h"
 
 namespace sable {
 
 typedef std::vector<std::string>::const_iterator ConstStringIterator;
 
+// Something Asar printed, warned about or failed on while applying a patch.
+struct AsarMessage {
+    enum class Kind {Print, Warning, Error} kind;
+    // the whole message, with its file and line if it has them.
+    std::string text;
+    std::string file;
+    int line;
+};
+
 struct RomPatcher
 {
     enum class AsarState {NotRun, Success, Error, InitFailed};
 private:
     std::vector<unsigned char> m_data;
+    // the ROM as it was loaded, which patches are made against. Only kept when asked for.
+    std::vector<unsigned char> m_Base;
+    // the ranges of m_data which may differ from the file that was loaded.
+    std::vector<patch::Range> m_Written;
+    // the loaded file's size, modification time and path, so an output ROM made
+    // from another one isn't treated as the same build.
+    std::string m_Source;
     int m_RomSize;
     int m_HeaderSize;
     sable::util::MapperType m_MapType;
     AsarState m_AState;
+    std::vector<AsarMessage> m_Log;
+    friend class PatchCache;
 public:
     static bool succeeded(AsarState state);
     static bool wasRun(AsarState state);
     RomPatcher(const util::MapperType& mapper = util::MapperType::LOROM);
     ~RomPatcher();
-    bool loadRom(const std::string& file, const std::string& name, int header = 0);
+    // keepBase keeps a copy of the ROM as it was loaded, which writePatch needs.
+    bool loadRom(const std::string& file, const std::string& name, int header = 0, bool keepBase = false);
     void clear();
     //~RomPatcher();
     bool expand(int size, const util::Mapper& mapper);
     AsarState applyPatchFile(const std::string& path, const std::string& format = "asm");
     unsigned char& at(int n);
+    // the errors if the patch failed, otherwise the prints.
     bool getMessages(std::back_insert_iterator<std::vector<std::string>> v);
+    // every print, warning and error from the last patch, in that order.
+    const std::vector<AsarMessage>& getLog() const;
     int getRealSize() const;
+    // the loaded ROM without its copier header.
+    const unsigned char* getRomData() const;
+    int getRomSize() const;
+    // record lists the ranges of the ROM that were written the last time file was.
+    // If file is still the ROM that build wrote, only those ranges and the ones this
+    // one wrote are written to it, otherwise it's written in full. The record is then
+    // replaced with this build's ranges. Returns the number of bytes written.
+    std::size_t writeRom(const std::string& file, const fs::path& record) const;
+    void writePatch(patch::Format format, std::ostream& output) const;
 
     void writeParsedData(const AddressList& addresses, const fs::path& includePath, std::ostream& mainText, std::ostream& textDefines);
     void writeInclude(const std::string include, std::ostream& mainFile, const fs::path& includePath = fs::path());
     void writeIncludes(ConstStringIterator start, ConstStringIterator end, std::ostream& mainFile, const fs::path& includePath = fs::path());
+    void writeDecompressor(compression::Codec codec, std::ostream& output);
+    // With a width directory, each font's width table is written there as a binary file
+    // which gets included at its width address instead of being written out as db lines.
     template<class Fl>
-    void writeFontData(Fl list, std::ostream& output)
+    void writeFontData(Fl list, std::ostream& output, const fs::path& widthDir = fs::path())
     {
+        AsmWriter writer(output);
+        std::vector<int> widths;
         for (auto& fontIt: list) {
-            auto font = fontIt.second;
+            auto& font = fontIt.second;
             if (!font.getFontWidthLocation().empty()) {
-                output << "\n"
-                          "ORG " + font.getFontWidthLocation();
-                std::vector<int> widths;
+                writer.append("\nORG ").append(font.getFontWidthLocation());
+                widths.clear();
 
                 for (int pIdx = 0; pIdx < font.getNumberOfPages(); pIdx++) {
                                 widths.reserve(font.getMaxEncodedValue(pIdx));
                     font.getFontWidths(pIdx, std::back_insert_iterator(widths));
                 }
 
+                if (!widthDir.empty()) {
+                    std::string fileName = fontIt.first + "_widths.bin";
+                    writeWidthTable(widths, widthDir / fileName);
+                    writer.append("\nincbin ").append(fileName).newLine();
+                    continue;
+                }
+
                 int column = 0;
                 int skipCount = 0;
                 for (auto it = widths.begin(); it != widths.end(); ++it) {
@@ -67,27 +112,26 @@ public:
                         column = 0;
                     } else {
                         if (skipCount > 0) {
-                            output << "\n"
-                                      "skip " << std::dec << skipCount;
+                            writer.append("\nskip ").decimal(skipCount);
                             skipCount = 0;
                         }
                         if (column == 0) {
-                            output << "\n"
-                                      "db ";
+                            writer.append("\ndb ");
                         } else {
-                            output << ", ";
+                            writer.append(", ");
                         }
-                        output << "$" << std::hex << std::setw(2) << std::setfill('0') << width;
+                        writer.hex(width, 2);
                         column++;
                         if (column ==16) {
                             column = 0;
                         }
                     }
                 }
-                output << '\n' ;
+                writer.newLine();
             }
         }
     }
+    void writeWidthTable(const std::vector<int>& widths, const fs::path& file);
 
     std::string getMapperDirective(const util::MapperType& mapper);
 //    int getRomSize() const;
@@ -0,0 +1,329 @@
+#include "dictionary.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <set>
+#include <tuple>
+#include <unordered_set>
+
+#include "unicode.h"
+#include "font/normalize.h"
+#include "font/codenotfound.h"
+
+namespace sable {
+
+namespace {
+    constexpr std::size_t CANDIDATES_PER_ROUND = 8;
+
+    struct Token {
+        int word, rest;
+        std::vector<int> chars;
+    };
+
+    struct Segment {
+        std::vector<Token> tokens;
+        std::size_t count;
+    };
+
+    struct Candidate {
+        std::size_t estimate;
+        bool isNoun;
+        int first, second;
+        bool operator<(const Candidate& other) const {
+            return std::tie(isNoun, first, second) < std::tie(other.isNoun, other.first, other.second);
+        }
+    };
+
+    std::uint64_t pairKey(int first, int second)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(first)) << 32) |
+               static_cast<std::uint32_t>(second);
+    }
+
+    class Interner {
+        std::unordered_map<std::string, int> ids;
+    public:
+        std::vector<std::string> values;
+        int get(const std::string& value)
+        {
+            if (auto it = ids.find(value); it != ids.end()) {
+                return it->second;
+            }
+            values.push_back(value);
+            return ids[value] = values.size() - 1;
+        }
+    };
+
+    struct Dictionary {
+        bool useDigraphs;
+        std::unordered_set<std::uint64_t> digraphs;
+        std::unordered_map<int, std::size_t> nouns;
+
+        bool hasDigraph(int first, int second) const
+        {
+            return useDigraphs && digraphs.find(pairKey(first, second)) != digraphs.end();
+        }
+    };
+
+    struct Statistics {
+        std::unordered_map<std::uint64_t, std::size_t> pairs;
+        std::unordered_map<int, std::pair<std::size_t, std::size_t>> words;
+    };
+
+    // mirrors the segmentation done by TextParser::parseLine.
+    std::size_t encode(const Segment& segment, const Dictionary& dict, Statistics* stats)
+    {
+        std::size_t cost = 0;
+        bool skipFirst = false;
+        int lastSingle = -1;
+        auto single = [&] (int ch) {
+            ++cost;
+            if (stats != nullptr) {
+                if (lastSingle != -1) {
+                    stats->pairs[pairKey(lastSingle, ch)] += segment.count;
+                }
+                lastSingle = ch;
+            }
+        };
+        for (std::size_t index = 0; index < segment.tokens.size(); ++index) {
+            const Token& token = segment.tokens[index];
+            std::size_t start = skipFirst ? 1 : 0;
+            int word = skipFirst ? token.rest : token.word;
+            skipFirst = false;
+            if (start >= token.chars.size()) {
+                continue;
+            }
+            if (auto noun = dict.nouns.find(word); noun != dict.nouns.end()) {
+                cost += noun->second;
+                lastSingle = -1;
+                continue;
+            }
+            std::size_t tokenStart = cost;
+            for (std::size_t ch = start; ch < token.chars.size(); ++ch) {
+                if (ch + 1 < token.chars.size()) {
+                    if (dict.hasDigraph(token.chars[ch], token.chars[ch + 1])) {
+                        ++cost;
+                        ++ch;
+                        lastSingle = -1;
+                        continue;
+                    }
+                } else if (index + 1 < segment.tokens.size() &&
+                           dict.hasDigraph(token.chars[ch], segment.tokens[index + 1].chars.front())) {
+                    ++cost;
+                    skipFirst = true;
+                    lastSingle = -1;
+                    continue;
+                }
+                single(token.chars[ch]);
+            }
+            if (stats != nullptr && token.chars.size() - start > 1) {
+                auto& [count, total] = stats->words[word];
+                count += segment.count;
+                total += (cost - tokenStart) * segment.count;
+            }
+        }
+        return cost;
+    }
+
+    std::size_t encode(const std::vector<Segment>& segments, const Dictionary& dict, Statistics* stats = nullptr)
+    {
+        std::size_t total = 0;
+        for (auto& segment: segments) {
+            total += encode(segment, dict, stats) * segment.count;
+        }
+        return total;
+    }
+}
+
+DictionaryOptimizer::DictionaryOptimizer(const Font &font, int page, const std::string &locale)
+    : m_Font{font}, m_Page{page}, m_Locale{locale}
+{
+    m_Font.getPage(page);
+}
+
+void DictionaryOptimizer::addLine(const std::string &line)
+{
+    std::string segment;
+    for (std::size_t index = 0; index < line.size(); ++index) {
+        char c = line[index];
+        if (c == '#' || c == '@') {
+            break;
+        } else if (c == '[') {
+            // commands break up the text, so nothing can be merged across them.
+            addSegment(std::move(segment));
+            segment = "";
+            index = line.find(']', index);
+            if (index == std::string::npos) {
+                break;
+            }
+        } else if (c != '\r') {
+            segment += c;
+        }
+    }
+    addSegment(std::move(segment));
+}
+
+void DictionaryOptimizer::addSegment(std::string &&segment)
+{
+    if (!segment.empty()) {
+        m_Segments[normalize(segment)]++;
+    }
+}
+
+DictionaryOptimizer::Result DictionaryOptimizer::optimize(std::size_t maxEntries) const
+{
+    auto locale = icu::Locale::createCanonical(m_Locale.c_str());
+    Interner chars, words;
+    std::vector<Segment> segments;
+    segments.reserve(m_Segments.size());
+    for (auto& [text, count]: m_Segments) {
+        Segment segment{{}, count};
+        for (BreakIterator wordIt(true, text, locale); !wordIt.done(); ++wordIt) {
+            std::string word = *wordIt;
+            Token token{words.get(word), -1, {}};
+            std::string rest;
+            for (BreakIterator charIt(false, word, locale); !charIt.done(); ++charIt) {
+                if (!token.chars.empty()) {
+                    rest += *charIt;
+                }
+                token.chars.push_back(chars.get(*charIt));
+            }
+            token.rest = words.get(rest);
+            segment.tokens.push_back(std::move(token));
+        }
+        segments.push_back(std::move(segment));
+    }
+
+    Dictionary dict;
+    dict.useDigraphs = m_Font.getHasDigraphs();
+    const auto& page = m_Font.getPage(m_Page);
+    for (auto [glyphId, glyph]: page.getGlyphs()) {
+        std::string id(glyphId);
+        std::vector<int> glyphChars;
+        for (BreakIterator charIt(false, id, locale); !charIt.done(); ++charIt) {
+            glyphChars.push_back(chars.get(*charIt));
+        }
+        if (glyphChars.size() == 2) {
+            dict.digraphs.insert(pairKey(glyphChars[0], glyphChars[1]));
+        }
+    }
+    for (auto& [id, noun]: page.getNouns()) {
+        dict.nouns[words.get(id)] = noun.codes.size();
+    }
+
+    std::vector<int> widths;
+    auto widthOf = [&] (int ch) {
+        if (widths.size() <= static_cast<std::size_t>(ch)) {
+            widths.resize(chars.values.size(), 0);
+        }
+        if (widths[ch] == 0) {
+            try {
+                widths[ch] = m_Font.getWidth(m_Page, chars.values[ch]);
+            } catch (CodeNotFound&) {
+                widths[ch] = -1;
+            }
+        }
+        return widths[ch];
+    };
+
+    // command codes are left alone even behind a command prefix, so End can't be mistaken for a glyph.
+    auto usedCodes = m_Font.getUsedCodes(m_Page);
+    usedCodes.insert(m_Font.getEndValue());
+    for (auto& [id, command]: m_Font.getCommands()) {
+        usedCodes.insert(command.code);
+    }
+    unsigned int nextCode = 0;
+    auto maxCode = m_Font.getMaxEncodedValue(m_Page);
+    auto takeCode = [&] () -> std::optional<unsigned int> {
+        for (; maxCode >= 0 && nextCode <= static_cast<unsigned int>(maxCode); ++nextCode) {
+            if (usedCodes.find(nextCode) == usedCodes.end()) {
+                return nextCode++;
+            }
+        }
+        return std::nullopt;
+    };
+
+    std::size_t byteWidth = m_Font.getByteWidth();
+    std::size_t current = encode(segments, dict);
+    Result result{{}, current * byteWidth, 0};
+    std::set<Candidate> rejected;
+    std::optional<unsigned int> code = takeCode();
+    while (code && (maxEntries == 0 || result.entries.size() < maxEntries)) {
+        Statistics stats;
+        encode(segments, dict, &stats);
+
+        std::vector<Candidate> candidates;
+        if (dict.useDigraphs) {
+            for (auto& [key, count]: stats.pairs) {
+                int first = key >> 32, second = key & 0xFFFFFFFF;
+                if (widthOf(first) > 0 && widthOf(second) > 0) {
+                    candidates.push_back({count, false, first, second});
+                }
+            }
+        }
+        for (auto& [word, usage]: stats.words) {
+            if (usage.second > usage.first) {
+                candidates.push_back({usage.second - usage.first, true, word, -1});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [] (const Candidate& lhs, const Candidate& rhs) {
+            return lhs.estimate > rhs.estimate;
+        });
+
+        bool accepted = false;
+        std::size_t tried = 0;
+        for (auto& candidate: candidates) {
+            if (tried == CANDIDATES_PER_ROUND) {
+                break;
+            }
+            if (rejected.find(candidate) != rejected.end()) {
+                continue;
+            }
+            ++tried;
+            Entry entry{"", *code, 0, candidate.isNoun, 0};
+            if (candidate.isNoun) {
+                entry.text = words.values[candidate.first];
+                for (BreakIterator charIt(false, entry.text, locale); !charIt.done(); ++charIt) {
+                    auto width = widthOf(chars.get(*charIt));
+                    if (width < 0) {
+                        entry.width = -1;
+                        break;
+                    }
+                    entry.width += width;
+                }
+                if (entry.width < 0) {
+                    rejected.insert(candidate);
+                    continue;
+                }
+                dict.nouns[candidate.first] = 1;
+            } else {
+                entry.text = chars.values[candidate.first] + chars.values[candidate.second];
+                entry.width = widthOf(candidate.first) + widthOf(candidate.second);
+                dict.digraphs.insert(pairKey(candidate.first, candidate.second));
+            }
+            std::size_t next = encode(segments, dict);
+            if (next < current) {
+                entry.savings = (current - next) * byteWidth;
+                result.entries.push_back(std::move(entry));
+                current = next;
+                accepted = true;
+                break;
+            }
+            if (candidate.isNoun) {
+                dict.nouns.erase(candidate.first);
+            } else {
+                dict.digraphs.erase(pairKey(candidate.first, candidate.second));
+            }
+            rejected.insert(candidate);
+        }
+        if (!accepted) {
+            break;
+        }
+        code = takeCode();
+    }
+    result.optimizedSize = current * byteWidth;
+    return result;
+}
+
+}
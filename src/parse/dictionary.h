@@ -0,0 +1,45 @@
+#ifndef DICTIONARY_H
+#define DICTIONARY_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "font/font.h"
+
+namespace sable {
+
+// Picks digraphs and single-code nouns for the unused codes of a font page
+// which save the most space over the script lines it has been given.
+class DictionaryOptimizer
+{
+public:
+    struct Entry {
+        std::string text;
+        unsigned int code;
+        int width;
+        bool isNoun;
+        std::size_t savings;
+    };
+    struct Result {
+        std::vector<Entry> entries;
+        std::size_t originalSize;
+        std::size_t optimizedSize;
+    };
+
+    DictionaryOptimizer(const Font& font, int page, const std::string& locale);
+
+    void addLine(const std::string& line);
+    Result optimize(std::size_t maxEntries = 0) const;
+private:
+    const Font& m_Font;
+    int m_Page;
+    std::string m_Locale;
+    std::unordered_map<std::string, std::size_t> m_Segments;
+
+    void addSegment(std::string&& segment);
+};
+
+}
+
+#endif // DICTIONARY_H
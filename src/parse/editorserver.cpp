@@ -0,0 +1,241 @@
+#include "editorserver.h"
+
+#include <sstream>
+
+#include "json.h"
+#include "data/tokenizer.h"
+
+namespace sable {
+
+namespace {
+    constexpr int PARSE_ERROR = -32700;
+    constexpr int INVALID_REQUEST = -32600;
+    constexpr int METHOD_NOT_FOUND = -32601;
+    constexpr int INVALID_PARAMS = -32602;
+
+    struct RequestError : std::runtime_error {
+        int code;
+        RequestError(int c, const std::string& message): std::runtime_error(message), code{c} {}
+    };
+
+    using json::quote;
+
+    // ids are echoed back with the same type they came in with.
+    std::string writeId(const YAML::Node& id)
+    {
+        if (!id || id.IsNull()) {
+            return "null";
+        }
+        if (id.IsScalar() && id.Tag() != "!" && util::parseInt(id.Scalar())) {
+            return id.Scalar();
+        }
+        return quote(id.IsScalar() ? id.Scalar() : "");
+    }
+
+    std::string response(const std::string& id, const std::string& result)
+    {
+        return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"result\":" + result + '}';
+    }
+
+    std::string errorResponse(const std::string& id, int code, const std::string& message)
+    {
+        return "{\"jsonrpc\":\"2.0\",\"id\":" + id + ",\"error\":{\"code\":" + std::to_string(code) +
+               ",\"message\":" + quote(message) + "}}";
+    }
+
+    struct Diagnostic {
+        int line;
+        const char* severity;
+        std::string message;
+    };
+}
+
+EditorServer::EditorServer(
+    FontList &&fonts,
+    const std::string &defaultMode,
+    const std::string &locale,
+    const util::Mapper &mapper
+) : m_Parser(std::move(fonts), defaultMode, locale, options::ExportWidth::Off, options::ExportAddress::Off),
+    m_Mapper{mapper},
+    m_DefaultMode{defaultMode},
+    m_Done{false}
+{
+}
+
+void EditorServer::run(std::istream &input, std::ostream &output)
+{
+    for (std::string request; !m_Done && std::getline(input, request); ) {
+        if (request.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        if (auto reply = handle(request); !reply.empty()) {
+            // editors wait on each reply, so it can't sit in a buffer.
+            output << reply << std::endl;
+        }
+    }
+}
+
+std::string EditorServer::handle(const std::string &request)
+{
+    YAML::Node message;
+    try {
+        message = YAML::Load(request);
+    } catch (YAML::Exception &e) {
+        return errorResponse("null", PARSE_ERROR, "Parse error: " + e.msg);
+    }
+    if (!message.IsMap()) {
+        return errorResponse("null", INVALID_REQUEST, "Request must be an object.");
+    }
+    bool isNotification = !message["id"];
+    std::string id = writeId(message["id"]);
+    try {
+        if (!message["method"] || !message["method"].IsScalar()) {
+            throw RequestError(INVALID_REQUEST, "Request is missing a method.");
+        }
+        auto method = message["method"].Scalar();
+        std::string result;
+        if (method == "initialize") {
+            result = initialize();
+        } else if (method == "encode") {
+            result = encode(message["params"]);
+        } else if (method == "shutdown") {
+            result = "null";
+        } else if (method == "exit") {
+            m_Done = true;
+            result = "null";
+        } else {
+            throw RequestError(METHOD_NOT_FOUND, "Method \"" + method + "\" not found.");
+        }
+        return isNotification ? "" : response(id, result);
+    } catch (RequestError &e) {
+        return isNotification ? "" : errorResponse(id, e.code, e.what());
+    }
+}
+
+bool EditorServer::isDone() const
+{
+    return m_Done;
+}
+
+std::string EditorServer::initialize() const
+{
+    std::string result = "{\"defaultMode\":" + quote(m_DefaultMode) + ",\"fonts\":[";
+    bool first = true;
+    for (auto& name: m_Parser.getFonts().getNames()) {
+        if (!first) {
+            result += ',';
+        }
+        first = false;
+        result += quote(name);
+    }
+    return result + "]}";
+}
+
+std::string EditorServer::encode(const YAML::Node &params)
+{
+    if (!params || !params.IsMap() || !params["text"] || !params["text"].IsScalar()) {
+        throw RequestError(INVALID_PARAMS, "encode needs a text parameter.");
+    }
+    // the text doesn't go anywhere, but the parser still needs a valid address.
+    int address = m_Mapper.ToRom(0);
+    if (auto value = params["address"]; value && value.IsScalar()) {
+        auto number = util::parseInt(value.Scalar());
+        auto hex = util::strToHex(value.Scalar());
+        if (number) {
+            address = *number;
+        } else if (hex.second >= 0) {
+            address = hex.first;
+        } else {
+            throw RequestError(INVALID_PARAMS, "address must be a number or a hex address.");
+        }
+    }
+    auto settings = m_Parser.getDefaultSetting(address);
+    try {
+        if (auto type = params["type"]; type && type.IsScalar() && type.Scalar() != "default") {
+            if (!m_Parser.getFonts().contains(type.Scalar())) {
+                throw RequestError(INVALID_PARAMS, "Font \"" + type.Scalar() + "\" was not defined");
+            }
+            settings.mode = type.Scalar();
+            settings.maxWidth = m_Parser.getFonts().at(settings.mode).getMaxWidth();
+        }
+        if (auto page = params["page"]; page && page.IsScalar()) {
+            auto value = util::parseInt(page.Scalar());
+            if (!value || *value < 0 || *value >= m_Parser.getFonts().at(settings.mode).getNumberOfPages()) {
+                throw RequestError(INVALID_PARAMS, "page is not a page of font \"" + settings.mode + "\".");
+            }
+            settings.page = *value;
+        }
+    } catch (FontError &e) {
+        throw RequestError(INVALID_PARAMS, e.what());
+    }
+
+    std::istringstream input(params["text"].Scalar());
+    std::vector<unsigned char> data;
+    std::vector<Diagnostic> diagnostics;
+    std::ostringstream lines, blocks;
+    static const char* hex = "0123456789ABCDEF";
+    int line = 0, blockLine = 1;
+    bool keepReading = false;
+    auto lastRead = TextParser::Metadata::No;
+    // the same loop Parser::processFile uses, except that errors don't stop it.
+    while (input || keepReading) {
+        keepReading = false;
+        bool hasLine = input.peek() != std::char_traits<char>::eof();
+        std::size_t lineStart = data.size();
+        TextParser::Result rs {false, 0, settings.label, TextParser::Metadata::No};
+        if (hasLine) {
+            ++line;
+        }
+        try {
+            rs = m_Parser.parseLine(input, settings, data, lastRead, m_Mapper);
+        } catch (FontError &e) {
+            throw RequestError(INVALID_PARAMS, e.what());
+        } catch (std::runtime_error &e) {
+            diagnostics.push_back({std::max(line, 1), "error", e.what()});
+        }
+        if (hasLine) {
+            if (line > 1) {
+                lines << ',';
+            }
+            lines << "{\"line\":" << line << ",\"width\":" << rs.length << ",\"maxWidth\":" << settings.maxWidth << ",\"bytes\":\"";
+            for (std::size_t index = lineStart; index < data.size(); ++index) {
+                lines << hex[data[index] >> 4] << hex[data[index] & 0xF];
+            }
+            lines << "\"}";
+        }
+        if (settings.maxWidth > 0 && rs.length > settings.maxWidth) {
+            diagnostics.push_back({
+                line,
+                "warning",
+                "Line is longer than the specified max width of " + std::to_string(settings.maxWidth) + " pixels."
+            });
+        }
+        lastRead = rs.metadata;
+        if (!rs.endOfBlock || data.empty()) {
+            keepReading |= (!data.empty() || lastRead == TextParser::Metadata::Yes);
+            continue;
+        }
+        if (blocks.tellp() > 0) {
+            blocks << ',';
+        }
+        blocks << "{\"line\":" << blockLine << ",\"label\":" << quote(rs.label) << ",\"size\":" << data.size() << '}';
+        data.clear();
+        blockLine = line + 1;
+        if (rs.label == settings.label) {
+            settings.label = "";
+        }
+    }
+
+    std::string result = "{\"lines\":[" + lines.str() + "],\"blocks\":[" + blocks.str() + "],\"diagnostics\":[";
+    for (std::size_t index = 0; index < diagnostics.size(); ++index) {
+        if (index > 0) {
+            result += ',';
+        }
+        result += "{\"line\":" + std::to_string(diagnostics[index].line) +
+                  ",\"severity\":" + quote(diagnostics[index].severity) +
+                  ",\"message\":" + quote(diagnostics[index].message) + '}';
+    }
+    return result + "]}";
+}
+
+}
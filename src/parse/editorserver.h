@@ -0,0 +1,53 @@
+#ifndef EDITORSERVER_H
+#define EDITORSERVER_H
+
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include <yaml-cpp/yaml.h>
+
+#include "textparser.h"
+#include "data/mapper.h"
+
+namespace sable {
+
+// Answers JSON-RPC 2.0 requests from editor plugins, one JSON object per line.
+// The fonts and parser stay loaded between requests, so each one only costs
+// the encoding of the text it sends.
+//
+// Methods:
+//   initialize - returns the font names and the default mode.
+//   encode     - params: text, and optionally type, page and address.
+//                Returns the width and encoded bytes of each line, the size of
+//                each block, and any errors or width warnings.
+//   shutdown   - returns null.
+//   exit       - stops the server.
+class EditorServer
+{
+public:
+    EditorServer(
+        FontList&& fonts,
+        const std::string& defaultMode,
+        const std::string& locale,
+        const util::Mapper& mapper
+    );
+
+    // handles requests from input until it ends or an exit notification comes in.
+    void run(std::istream& input, std::ostream& output);
+    // returns the response to one request, or an empty string for notifications.
+    std::string handle(const std::string& request);
+    bool isDone() const;
+private:
+    TextParser m_Parser;
+    util::Mapper m_Mapper;
+    std::string m_DefaultMode;
+    bool m_Done;
+
+    std::string initialize() const;
+    std::string encode(const YAML::Node& params);
+};
+
+}
+
+#endif // EDITORSERVER_H
@@ -0,0 +1,44 @@
+#include "json.h"
+
+namespace sable {
+
+namespace json {
+
+std::string quote(std::string_view value)
+{
+    static const char* hex = "0123456789abcdef";
+    std::string result = "\"";
+    result.reserve(value.size() + 2);
+    for (unsigned char c: value) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (c < 0x20) {
+                result += "\\u00";
+                result += hex[c >> 4];
+                result += hex[c & 0xF];
+            } else {
+                result += static_cast<char>(c);
+            }
+        }
+    }
+    return result + '"';
+}
+
+}
+
+}
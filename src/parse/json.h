@@ -0,0 +1,18 @@
+#ifndef JSON_H
+#define JSON_H
+
+#include <string>
+#include <string_view>
+
+namespace sable {
+
+namespace json {
+
+// The value in double quotes, escaped to be a JSON string.
+std::string quote(std::string_view value);
+
+}
+
+}
+
+#endif // JSON_H
@@ -1,10 +1,16 @@
 #ifndef FILEPARSER_H
 #define FILEPARSER_H
 
+#include <algorithm>
 #include <vector>
 #include <istream>
+#include <sstream>
 
 #include "data/mapper.h"
+#include "data/blockindex.h"
+#include "data/compression.h"
+#include "data/options.h"
+#include "data/optionhelpers.h"
 #include "block.h"
 #include "textparser.h"
 #include "result.h"
@@ -15,9 +21,66 @@ namespace sable {
 template <class Derived>
 class Parser : public TextParser {
     Blocks textRanges;
+    BlockIndex writtenBlocks;
+    options::Deduplicate deduplicate = options::Deduplicate::Off;
+    std::size_t deduplicatedBytes = 0;
+    options::CompressBlocks compressBlocks = options::CompressBlocks::On;
+    std::shared_ptr<TokenCache> tokenCache;
 public:
     using TextParser::TextParser;
 
+    void setDeduplication(options::Deduplicate value)
+    {
+        deduplicate = value;
+    }
+
+    // blocks are compressed with their font's codec unless this is turned off.
+    void setCompression(options::CompressBlocks value)
+    {
+        compressBlocks = value;
+    }
+
+    // files are only lexed the first time the cache sees them.
+    void setTokenCache(std::shared_ptr<TokenCache> cache)
+    {
+        tokenCache = std::move(cache);
+    }
+
+    std::size_t getDeduplicatedBytes() const
+    {
+        return deduplicatedBytes;
+    }
+
+    // Called instead of write() when a block's data already exists at address.
+    // Handlers that don't override this just write the data out again.
+    void alias(
+        std::string label,
+        const std::string&,
+        const std::vector<unsigned char>& data,
+        int address,
+        bool printpc,
+        options::ExportWidth exportWidth,
+        options::ExportAddress exportAddress
+    ) {
+        static_cast<Derived*>(this)->write(
+            label + ".bin",
+            label,
+            data,
+            address,
+            0,
+            data.size(),
+            printpc,
+            exportWidth,
+            exportAddress
+        );
+    }
+
+    // Called with the width of each block's widest line before the block is written.
+    // Handlers that don't need it leave it alone.
+    void measure(int)
+    {
+    }
+
     parse::FileResult processFile(
         std::istream& input,
         const util::Mapper& mapper,
@@ -26,20 +89,46 @@ public:
         int nextAddress,
         int startingDirIndex
     ) {
+        if (!tokenCache) {
+            return processFile(lex(input), mapper, currentDir, fileKey, nextAddress, startingDirIndex);
+        }
+        auto tokens = tokenCache->find(fileKey);
+        if (!tokens) {
+            tokens = tokenCache->add(fileKey, lex(input));
+        }
+        return processFile(*tokens, mapper, currentDir, fileKey, nextAddress, startingDirIndex);
+    }
+
+    // the same stream can be processed by several parsers, e.g. one for each font or ROM.
+    parse::FileResult processFile(
+        const TokenStream& tokens,
+        const util::Mapper& mapper,
+        const std::string& currentDir,
+        const std::string& fileKey,
+        int nextAddress,
+        int startingDirIndex
+    ) {
+        TokenStream::Reader input(tokens);
         int dirIndex = startingDirIndex;
         auto settings = getDefaultSetting(nextAddress);
+        int expectedAddress = settings.currentAddress;
 
         int line = 0;
 
         std::vector<unsigned char> data;
+        // the widest line of the block being read.
+        int blockWidth = 0;
         bool keepReading = false;
         Metadata lastRead = Metadata::No;
         while (input || keepReading) {
             keepReading = false;
             TextParser::Result rs {false, 0, settings.label};
             try {
-                rs = parseLine(input, settings, std::back_inserter(data), lastRead, mapper);
+                rs = parseLine(input, settings, data, lastRead, mapper);
                 line++;
+            } catch (FontError &e) {
+                // a font is built the first time it's used, and a bad definition isn't the script's fault.
+                throw;
             } catch (std::runtime_error &e) {
                 static_cast<Derived*>(this)->report(
                     fileKey,
@@ -47,6 +136,8 @@ public:
                     std::string(e.what()),
                     line + 1
                 );
+                // the line was still read, so the ones after it keep their numbers.
+                line++;
             }
             if (settings.maxWidth > 0 && rs.length > settings.maxWidth) {
                 static_cast<Derived*>(this)->report(
@@ -57,25 +148,83 @@ public:
                 );
             }
             lastRead = rs.metadata;
+            blockWidth = std::max(blockWidth, rs.length);
             if (!rs.endOfBlock || data.empty()) {
                 keepReading |= (!data.empty() || lastRead == Metadata::Yes);
                 continue;
             }
+            auto& fl = getFonts();
+            auto font = fl.find(settings.mode);
+            if (font == fl.end()) {
+                data = {};
+                blockWidth = 0;
+                continue;
+            }
+            if (auto* stats = getStats(); stats) {
+                stats->addBlock(settings.mode, data.size(), blockWidth);
+            }
+            static_cast<Derived*>(this)->measure(blockWidth);
+            blockWidth = 0;
+            bool autoPlaced = settings.currentAddress == expectedAddress;
+            auto codec = options::isEnabled(compressBlocks) ? font->second.getCompression() : compression::Codec::None;
+            if (codec != compression::Codec::None) {
+                data = compression::compress(codec, data);
+                // the decompressor can't follow a block into the next bank.
+                int lastByte = settings.currentAddress + static_cast<int>(data.size()) - 1;
+                if (!data.empty() && (lastByte & 0xFF0000) != (settings.currentAddress & 0xFF0000)) {
+                    // only a block placed automatically can be moved, since code may expect one with an address there.
+                    if (autoPlaced) {
+                        settings.currentAddress = mapper.skipToNextBank(settings.currentAddress);
+                    } else {
+                        std::ostringstream message;
+                        message << "compressed block \"" << (rs.label.empty() ? settings.label : rs.label)
+                                << "\" is " << data.size() << " bytes and doesn't fit in the bank at $"
+                                << std::hex << std::uppercase << settings.currentAddress << ".";
+                        static_cast<Derived*>(this)->report(fileKey, error::Levels::Error, message.str(), line);
+                    }
+                }
+            }
+            // the next bank only matters if the block actually reaches it.
+            int blockEnd = settings.currentAddress + data.size();
+            int nextBank = (blockEnd & 0xFF0000) != (settings.currentAddress & 0xFF0000)
+                    ? mapper.skipToNextBank(settings.currentAddress)
+                    : settings.currentAddress;
             Block bl(
                 settings.currentAddress,
-                mapper.skipToNextBank(settings.currentAddress),
+                nextBank,
                 std::move(data)
             );
 
             data = {};
-
-            if (auto& fl = getFonts(); fl.find(settings.mode) == fl.end()) {
-                continue;
-            }
             if (rs.label.empty()) {
                 rs.label = currentDir + '_' + std::to_string(dirIndex++);
             }
 
+            // only blocks placed automatically can be moved onto existing data.
+            if (options::isEnabled(deduplicate) &&
+                !settings.printpc &&
+                autoPlaced
+            ) {
+                // compressed data has to be read from its start.
+                if (auto match = writtenBlocks.find(bl.data);
+                    match && (codec == compression::Codec::None || match->offset == 0)) {
+                    static_cast<Derived*>(this)->alias(
+                        rs.label,
+                        match->label,
+                        bl.data,
+                        match->address,
+                        settings.printpc,
+                        settings.exportWidth,
+                        settings.exportAddress
+                    );
+                    deduplicatedBytes += bl.data.size();
+                    if (rs.label == settings.label) {
+                        settings.label = "";
+                    }
+                    continue;
+                }
+            }
+
             for (auto b: bl.bankBounds) {
                 auto baseOutputFileName = rs.label + b.fileSuffix + ".bin";
 
@@ -112,7 +261,11 @@ public:
 
                 settings.printpc = false;
             }
+            if (options::isEnabled(deduplicate) && !bl.bankSplit()) {
+                writtenBlocks.add(rs.label, bl.bankBounds.front().address, bl.data);
+            }
             settings.currentAddress = bl.getNextAddress();
+            expectedAddress = settings.currentAddress;
             if (rs.label == settings.label) {
                 settings.label = "";
             }
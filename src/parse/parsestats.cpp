@@ -0,0 +1,160 @@
+#include "parsestats.h"
+
+#include <type_traits>
+
+#include "json.h"
+
+namespace sable {
+
+namespace {
+    template<class Map>
+    void writeJsonCounts(std::ostream& out, const Map& counts)
+    {
+        out << '{';
+        bool first = true;
+        for (auto& [key, count]: counts) {
+            if (!first) {
+                out << ',';
+            }
+            first = false;
+            if constexpr (std::is_same_v<typename Map::key_type, std::string>) {
+                out << json::quote(key);
+            } else {
+                out << '"' << key << '"';
+            }
+            out << ':' << count;
+        }
+        out << '}';
+    }
+
+    std::string quoteCsv(const std::string& value)
+    {
+        if (value.find_first_of(",\"\r\n") == std::string::npos) {
+            return value;
+        }
+        std::string result = "\"";
+        for (char c: value) {
+            if (c == '"') {
+                result += '"';
+            }
+            result += c;
+        }
+        return result + '"';
+    }
+
+    template<class Map>
+    void writeCsvCounts(std::ostream& out, const std::string& font, const std::string& page, const char* kind, const Map& counts)
+    {
+        for (auto& [key, count]: counts) {
+            out << quoteCsv(font) << ',' << page << ',' << kind << ',';
+            if constexpr (std::is_same_v<typename Map::key_type, std::string>) {
+                out << quoteCsv(key);
+            } else {
+                out << key;
+            }
+            out << ',' << count << '\n';
+        }
+    }
+}
+
+void ParseStats::addGlyph(const std::string &mode, int page, const std::string &text)
+{
+    m_Fonts[mode].pages[page].glyphs[text]++;
+}
+
+void ParseStats::addDigraph(const std::string &mode, int page, const std::string &text, bool found)
+{
+    auto& stats = m_Fonts[mode].pages[page];
+    (found ? stats.digraphs : stats.digraphMisses)[text]++;
+}
+
+void ParseStats::addNoun(const std::string &mode, int page, const std::string &text)
+{
+    m_Fonts[mode].pages[page].nouns[text]++;
+}
+
+void ParseStats::addCommand(const std::string &mode, const std::string &name)
+{
+    m_Fonts[mode].commands[name]++;
+}
+
+void ParseStats::addPageSwitch(const std::string &mode, int page)
+{
+    m_Fonts[mode].pageSwitches[page]++;
+}
+
+void ParseStats::addBlock(const std::string &mode, std::size_t bytes, int width)
+{
+    auto& stats = m_Fonts[mode];
+    stats.blockBytes[bytes]++;
+    stats.blockWidths[width]++;
+}
+
+auto ParseStats::getFonts() const -> const std::map<std::string, FontStats>&
+{
+    return m_Fonts;
+}
+
+bool ParseStats::empty() const
+{
+    return m_Fonts.empty();
+}
+
+void ParseStats::writeJson(std::ostream &out) const
+{
+    out << "{\"fonts\":{";
+    bool firstFont = true;
+    for (auto& [name, font]: m_Fonts) {
+        if (!firstFont) {
+            out << ',';
+        }
+        firstFont = false;
+        out << json::quote(name) << ":{\"pages\":{";
+        bool firstPage = true;
+        for (auto& [number, page]: font.pages) {
+            if (!firstPage) {
+                out << ',';
+            }
+            firstPage = false;
+            out << '"' << number << "\":{\"glyphs\":";
+            writeJsonCounts(out, page.glyphs);
+            out << ",\"nouns\":";
+            writeJsonCounts(out, page.nouns);
+            out << ",\"digraphs\":";
+            writeJsonCounts(out, page.digraphs);
+            out << ",\"digraphMisses\":";
+            writeJsonCounts(out, page.digraphMisses);
+            out << '}';
+        }
+        out << "},\"commands\":";
+        writeJsonCounts(out, font.commands);
+        out << ",\"pageSwitches\":";
+        writeJsonCounts(out, font.pageSwitches);
+        out << ",\"blockBytes\":";
+        writeJsonCounts(out, font.blockBytes);
+        out << ",\"blockWidths\":";
+        writeJsonCounts(out, font.blockWidths);
+        out << '}';
+    }
+    out << "}}\n";
+}
+
+void ParseStats::writeCsv(std::ostream &out) const
+{
+    out << "font,page,kind,key,count\n";
+    for (auto& [name, font]: m_Fonts) {
+        for (auto& [number, page]: font.pages) {
+            auto pageNumber = std::to_string(number);
+            writeCsvCounts(out, name, pageNumber, "glyph", page.glyphs);
+            writeCsvCounts(out, name, pageNumber, "noun", page.nouns);
+            writeCsvCounts(out, name, pageNumber, "digraph", page.digraphs);
+            writeCsvCounts(out, name, pageNumber, "digraph_miss", page.digraphMisses);
+        }
+        writeCsvCounts(out, name, "", "command", font.commands);
+        writeCsvCounts(out, name, "", "page_switch", font.pageSwitches);
+        writeCsvCounts(out, name, "", "block_bytes", font.blockBytes);
+        writeCsvCounts(out, name, "", "block_width", font.blockWidths);
+    }
+}
+
+}
@@ -0,0 +1,60 @@
+#ifndef PARSESTATS_H
+#define PARSESTATS_H
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+
+namespace sable {
+
+// Counts what TextParser encodes, so it can be decided which glyphs need cheap
+// codes, which belong on another page and what's worth adding as a digraph or noun.
+// A parser only records anything once it's given one of these, and one collector
+// shouldn't be shared between parsers running on different threads.
+class ParseStats
+{
+public:
+    typedef std::map<std::string, std::size_t> Counts;
+    struct Page {
+        Counts glyphs;
+        Counts nouns;
+        // pairs of characters which were encoded as a digraph.
+        Counts digraphs;
+        // pairs of characters which could have been a digraph, but weren't in the font.
+        Counts digraphMisses;
+    };
+    struct FontStats {
+        std::map<int, Page> pages;
+        // commands, extras and raw codes in brackets, plus the new lines and
+        // end codes added automatically.
+        Counts commands;
+        // how many times each page was switched to.
+        std::map<int, std::size_t> pageSwitches;
+        // how many blocks had each number of bytes before compression, and each
+        // width in pixels of their widest line.
+        std::map<std::size_t, std::size_t> blockBytes;
+        std::map<int, std::size_t> blockWidths;
+    };
+
+    void addGlyph(const std::string& mode, int page, const std::string& text);
+    void addDigraph(const std::string& mode, int page, const std::string& text, bool found);
+    void addNoun(const std::string& mode, int page, const std::string& text);
+    void addCommand(const std::string& mode, const std::string& name);
+    void addPageSwitch(const std::string& mode, int page);
+    void addBlock(const std::string& mode, std::size_t bytes, int width);
+
+    const std::map<std::string, FontStats>& getFonts() const;
+    bool empty() const;
+
+    void writeJson(std::ostream& out) const;
+    // one row per count, with the columns font, page, kind, key and count.
+    // page is left empty for counts which aren't for one page.
+    void writeCsv(std::ostream& out) const;
+private:
+    std::map<std::string, FontStats> m_Fonts;
+};
+
+}
+
+#endif // PARSESTATS_H
@@ -0,0 +1,259 @@
+#include "textdumper.h"
+
+#include <algorithm>
+
+#include "unicode.h"
+#include "data/mapper.h"
+
+namespace sable {
+
+namespace {
+    // brackets are checked for hex values, then commands, then glyphs and extras.
+    bool canBracket(const std::string& id, const std::unordered_set<std::string>& commands)
+    {
+        if (id.empty() || id.find(']') != std::string::npos || commands.find(id) != commands.end()) {
+            return false;
+        }
+        try {
+            return util::strToHex(id).second < 0;
+        } catch (std::runtime_error&) {
+            return false;
+        }
+    }
+
+    // prefers whichever name sorts first so the output doesn't depend on hash order.
+    template<class Map, class Value>
+    void keepFirst(Map& map, unsigned int code, Value&& value, const std::string& name)
+    {
+        if (auto it = map.find(code); it == map.end() || name < it->second.name) {
+            map[code] = std::forward<Value>(value);
+        }
+    }
+}
+
+TextDumper::TextDumper(const Font &font, const std::string &locale)
+    : m_ByteWidth{font.getByteWidth()},
+      m_CommandValue{font.getCommandValue()},
+      m_EndValue{font.getEndValue()},
+      m_HasDigraphs{font.getHasDigraphs()},
+      m_EndName{"End"}
+{
+    for (auto& [name, node]: font.getCommands()) {
+        m_BracketNames.insert(name);
+        keepFirst(m_Commands, node.code, Command{name, node.page, node.isNewLine}, name);
+    }
+    if (auto end = m_Commands.find(m_EndValue); end != m_Commands.end()) {
+        m_EndName = end->second.name;
+    }
+    auto icuLocale = icu::Locale::createCanonical(locale.c_str());
+    m_Pages.resize(font.getNumberOfPages());
+    std::unordered_set<std::string> glyphIds;
+    for (int index = 0; index < font.getNumberOfPages(); ++index) {
+        auto& source = font.getPage(index);
+        auto& page = m_Pages[index];
+        std::vector<std::pair<std::string, std::string>> digraphs;
+        for (auto [glyphId, node]: source.getGlyphs()) {
+            std::string id(glyphId);
+            glyphIds.insert(id);
+            Glyph glyph;
+            std::vector<std::string> chars;
+            for (BreakIterator charIt(false, id, icuLocale); !charIt.done(); ++charIt) {
+                chars.push_back(*charIt);
+            }
+            if (chars.size() == 1 && id.find_first_of("[@#\r\n") == std::string::npos) {
+                glyph.kind = Glyph::Kind::Single;
+            } else if (chars.size() == 2 && m_HasDigraphs) {
+                glyph.kind = Glyph::Kind::Digraph;
+                digraphs.emplace_back(chars[0], chars[1]);
+            } else {
+                glyph.kind = Glyph::Kind::Bracketed;
+            }
+            glyph.text = id;
+            glyph.first = chars.empty() ? "" : chars.front();
+            if (page.glyphs.size() <= node.code) {
+                page.glyphs.resize(node.code + 1);
+            }
+            auto& current = page.glyphs[node.code];
+            if (current.kind == Glyph::Kind::Missing ||
+                glyph.kind < current.kind ||
+                (glyph.kind == current.kind && glyph.text < current.text)) {
+                current = std::move(glyph);
+            }
+        }
+        std::unordered_map<std::string, std::vector<unsigned int>> singles, firsts;
+        for (unsigned int code = 0; code < page.glyphs.size(); ++code) {
+            auto& glyph = page.glyphs[code];
+            if (glyph.kind == Glyph::Kind::Missing) {
+                continue;
+            }
+            if (glyph.kind == Glyph::Kind::Single) {
+                singles[glyph.text].push_back(code);
+            }
+            if (glyph.kind != Glyph::Kind::Bracketed) {
+                firsts[glyph.first].push_back(code);
+            }
+            if (!canBracket(glyph.text, m_BracketNames)) {
+                // an empty bracket form means the code gets written in hex instead.
+                glyph.bracketed.clear();
+            } else {
+                glyph.bracketed = '[' + glyph.text + ']';
+            }
+        }
+        for (auto& [first, second]: digraphs) {
+            for (unsigned int lastCode: singles[first]) {
+                for (unsigned int code: firsts[second]) {
+                    page.merges.insert((static_cast<std::uint64_t>(lastCode) << 32) | code);
+                }
+            }
+        }
+        for (auto& [id, node]: source.getNouns()) {
+            page.hasNouns = true;
+            if (node.codes.empty()) {
+                continue;
+            }
+            bool hasGlyphs = std::all_of(node.codes.begin(), node.codes.end(), [&page] (int code) {
+                return code >= 0 && static_cast<std::size_t>(code) < page.glyphs.size() && page.glyphs[code].kind != Glyph::Kind::Missing;
+            });
+            if (!hasGlyphs) {
+                page.nouns[node.codes.front()].push_back({node.codes, id});
+            }
+        }
+        for (auto& [first, nouns]: page.nouns) {
+            std::sort(nouns.begin(), nouns.end(), [] (const Noun& lhs, const Noun& rhs) {
+                return lhs.codes.size() != rhs.codes.size() ? lhs.codes.size() > rhs.codes.size() : lhs.text < rhs.text;
+            });
+        }
+    }
+    // an extra with the same name as a glyph would be read back as the glyph.
+    for (auto& [name, value]: font.getExtras()) {
+        auto it = m_Extras.find(value);
+        if (canBracket(name, m_BracketNames) &&
+            glyphIds.find(name) == glyphIds.end() &&
+            (it == m_Extras.end() || name < it->second)) {
+            m_Extras[value] = name;
+        }
+    }
+}
+
+TextDumper::Result TextDumper::dump(const unsigned char *data, std::size_t size, std::string &output, Style style) const
+{
+    std::size_t position = 0;
+    int pageIndex = 0;
+    // the code of the last character written as-is, which could merge with the next one into a digraph.
+    std::int64_t last = -1;
+    bool exact = true;
+    while (position + m_ByteWidth <= size) {
+        unsigned int code = read(data + position);
+        std::size_t next = position + m_ByteWidth;
+        const Command* command = nullptr;
+        if (m_CommandValue == -1) {
+            if (code == m_EndValue) {
+                output.append("[").append(m_EndName).append("]");
+                return {next, true, exact};
+            }
+            if (auto it = m_Commands.find(code); it != m_Commands.end()) {
+                command = &it->second;
+            }
+        } else if (code == static_cast<unsigned int>(m_CommandValue) && next + m_ByteWidth <= size) {
+            unsigned int value = read(data + next);
+            if (value == m_EndValue) {
+                output.append("[").append(m_EndName).append("]");
+                return {next + m_ByteWidth, true, exact};
+            }
+            if (auto it = m_Commands.find(value); it != m_Commands.end()) {
+                command = &it->second;
+                next += m_ByteWidth;
+            }
+        }
+        if (style == Style::Codes) {
+            appendCode(code, output);
+            position += m_ByteWidth;
+            continue;
+        }
+        if (command != nullptr) {
+            last = -1;
+            if (command->name == "NewLine") {
+                output.push_back('\n');
+            } else {
+                output.append("[").append(command->name).append("]");
+                if (command->isNewLine) {
+                    output.push_back('\n');
+                }
+            }
+            if (command->page >= 0 && static_cast<std::size_t>(command->page) < m_Pages.size()) {
+                pageIndex = command->page;
+            }
+            position = next;
+            continue;
+        }
+
+        auto& page = m_Pages[pageIndex];
+        if (auto nouns = page.nouns.empty() ? page.nouns.end() : page.nouns.find(code); nouns != page.nouns.end()) {
+            auto match = std::find_if(nouns->second.begin(), nouns->second.end(), [&] (const Noun& noun) {
+                if (position + noun.codes.size() * m_ByteWidth > size) {
+                    return false;
+                }
+                for (std::size_t index = 0; index < noun.codes.size(); ++index) {
+                    if (read(data + position + index * m_ByteWidth) != static_cast<unsigned int>(noun.codes[index])) {
+                        return false;
+                    }
+                }
+                return true;
+            });
+            if (match != nouns->second.end()) {
+                output.append(match->text);
+                last = -1;
+                exact = false;
+                position += match->codes.size() * m_ByteWidth;
+                continue;
+            }
+        }
+
+        position = next;
+        if (code < page.glyphs.size() && page.glyphs[code].kind != Glyph::Kind::Missing) {
+            auto& glyph = page.glyphs[code];
+            bool merges = last >= 0 && !page.merges.empty() && page.merges.find((static_cast<std::uint64_t>(last) << 32) | code) != page.merges.end();
+            if (glyph.kind == Glyph::Kind::Bracketed || merges) {
+                if (glyph.bracketed.empty()) {
+                    appendCode(code, output);
+                } else {
+                    output.append(glyph.bracketed);
+                }
+                last = -1;
+            } else {
+                output.append(glyph.text);
+                last = glyph.kind == Glyph::Kind::Single ? code : -1;
+                exact &= !page.hasNouns;
+            }
+            continue;
+        }
+        last = -1;
+        if (auto extra = m_Extras.find(code); extra != m_Extras.end()) {
+            output.append("[").append(extra->second).append("]");
+        } else {
+            appendCode(code, output);
+        }
+    }
+    return {position, false, exact};
+}
+
+unsigned int TextDumper::read(const unsigned char *data) const
+{
+    unsigned int code = 0;
+    for (int index = m_ByteWidth - 1; index >= 0; --index) {
+        code = (code << 8) | data[index];
+    }
+    return code;
+}
+
+void TextDumper::appendCode(unsigned int code, std::string &output) const
+{
+    static constexpr const char* digits = "0123456789ABCDEF";
+    output.push_back('[');
+    for (int shift = (m_ByteWidth * 2 - 1) * 4; shift >= 0; shift -= 4) {
+        output.push_back(digits[(code >> shift) & 0xF]);
+    }
+    output.push_back(']');
+}
+
+}
@@ -0,0 +1,78 @@
+#ifndef TEXTDUMPER_H
+#define TEXTDUMPER_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "font/font.h"
+
+namespace sable {
+
+// Turns encoded text back into script lines which TextParser encodes to the same bytes.
+// The font is indexed by code once, so decoding is a table lookup per code.
+class TextDumper
+{
+public:
+    enum class Style {
+        // glyphs, nouns and command names wherever they round-trip.
+        Script,
+        // every code in hex brackets, for blocks which don't round-trip as a script.
+        Codes
+    };
+    struct Result {
+        // bytes read, including the end code.
+        std::size_t length;
+        bool ended;
+        // false if the script has words which might be read back as nouns,
+        // so it should be checked with TextParser before it's used.
+        bool exact;
+    };
+
+    TextDumper(const Font& font, const std::string& locale);
+
+    // reads codes from data until the font's end code, appending the script to output.
+    Result dump(const unsigned char* data, std::size_t size, std::string& output, Style style = Style::Script) const;
+private:
+    struct Glyph {
+        enum class Kind {
+            Missing, Single, Digraph, Bracketed
+        } kind = Kind::Missing;
+        std::string text, bracketed, first;
+    };
+    struct Noun {
+        std::vector<int> codes;
+        std::string text;
+    };
+    struct Page {
+        std::vector<Glyph> glyphs;
+        // nouns which can't be written as their glyphs, longest first.
+        std::unordered_map<int, std::vector<Noun>> nouns;
+        bool hasNouns = false;
+        // pairs of codes which would be read back as a digraph if both were written as-is.
+        std::unordered_set<std::uint64_t> merges;
+    };
+    struct Command {
+        std::string name;
+        int page;
+        bool isNewLine;
+    };
+
+    int m_ByteWidth, m_CommandValue;
+    unsigned int m_EndValue;
+    bool m_HasDigraphs;
+    std::string m_EndName;
+    std::vector<Page> m_Pages;
+    std::unordered_map<unsigned int, Command> m_Commands;
+    std::unordered_map<unsigned int, std::string> m_Extras;
+    std::unordered_set<std::string> m_BracketNames;
+
+    unsigned int read(const unsigned char* data) const;
+    void appendCode(unsigned int code, std::string& output) const;
+};
+
+}
+
+#endif // TEXTDUMPER_H
@@ -2,8 +2,9 @@
 #include <sstream>
 #include <iostream>
 #include <map>
-#include <array>
 #include <algorithm>
+#include <list>
+#include <unordered_map>
 
 #include <unicode/uchar.h>
 #ifdef ICU_DATA_NEEDED
@@ -12,134 +13,237 @@
 
 #include "unicode.h"
 #include "data/optionhelpers.h"
+#include "data/tokenizer.h"
 
-using sable::TextParser, sable::Font;
+using sable::TextParser, sable::Font, sable::TokenStream;
 
 struct TextParser::Impl {
 #ifdef ICU_DATA_NEEDED
     inline static bool icuDataDirSet = false;
 #endif
     std::string defaultFont;
-    std::map<std::string, sable::Font> fontList;
+    sable::FontList fontList;
     icu::Locale m_Locale;
     bool useDigraphs;
     int maxWidth;
+    // the line being parsed when reading straight from a stream.
+    sable::TokenStream lineTokens;
+    // only set when the parser is collecting statistics.
+    std::shared_ptr<sable::ParseStats> stats;
+    // what a line without settings or comments encoded to, so a line repeated with
+    // the same font, page and autoend setting can be copied instead of parsed again.
+    struct CachedLine {
+        std::vector<unsigned char> data;
+        int length;
+        int page;
+        bool finished, printNewLine;
+        // how much of data comes before the first text run, which needs a valid address.
+        std::size_t textOffset;
+    };
+    // the most recently used line is first.
+    std::list<std::pair<std::string, CachedLine>> lineCache;
+    std::unordered_map<std::string_view, decltype(lineCache)::iterator> cachedLines;
+    std::size_t lineCacheSize = 1024;
+    LineCacheStats lineCacheStats{0, 0};
+    std::string lineKey;
     Impl(
         const std::string& defFont,
-        std::map<std::string, sable::Font>&& fList,
+        sable::FontList&& fList,
         icu::Locale&& locale
     )
-        : defaultFont{defFont}, fontList{fList}, m_Locale{locale} {}
+        : defaultFont{defFont}, fontList{std::move(fList)}, m_Locale{locale} {}
     ~Impl() {
 
     }
 
+    enum class Setting {
+        Unknown,
+        PrintPC,
+        Type,
+        Address,
+        Width,
+        Label,
+        Autoend,
+        Page,
+        EndOnLabel,
+        ExportWidth,
+        ExportAddress
+    };
+    static Setting findSetting(std::string_view name)
+    {
+        auto match = [&name] (std::string_view expected, Setting setting) {
+            return name == expected ? setting : Setting::Unknown;
+        };
+        if (name.size() < 2) {
+            return Setting::Unknown;
+        }
+        // a character or two is enough to narrow the name down to one setting.
+        switch (name.front()) {
+        case 'a':
+            return name[1] == 'd' ? match("address", Setting::Address) : match("autoend", Setting::Autoend);
+        case 'e':
+            if (name[1] == 'n') {
+                return match("end_on_label", Setting::EndOnLabel);
+            }
+            return name.size() == 14 ? match("export_address", Setting::ExportAddress) : match("export_width", Setting::ExportWidth);
+        case 'l':
+            return match("label", Setting::Label);
+        case 'p':
+            return name[1] == 'a' ? match("page", Setting::Page) : match("printpc", Setting::PrintPC);
+        case 't':
+            return match("type", Setting::Type);
+        case 'w':
+            return match("width", Setting::Width);
+        default:
+            return Setting::Unknown;
+        }
+    }
+    // directive is the rest of the line after the @ symbol.
     ParseSettings updateSettings(
         const ParseSettings &settings,
-        BreakIterator it,
+        std::string_view directive,
         const util::Mapper& mapper
     ) {
-        static const std::array<const char*, 10> SUPPORTED_SETTINGS{
-            "printpc",
-            "type",
-            "address",
-            "width",
-            "label",
-            "autoend",
-            "page",
-            "end_on_label",
-            "export_width",
-            "export_address"
-        };
         ParseSettings retVal = settings;
-        if (!it.done()) {
-            std::string name = "";
-            // Trying to mimic behavior of a stream WRT whitespace
-            for (++it; !it.done() && !u_isspace(it.ufront()) ; ++it) {
-                name += *it;
+        if (directive.empty() || util::isSpace(directive.front())) {
+            throw std::runtime_error("@ symbol found, but no setting specified.");
+        }
+        util::Tokenizer tokens(directive);
+        auto name = tokens.next();
+        auto setting = findSetting(name);
+        if (setting == Setting::Unknown) {
+            throw std::runtime_error("Unrecognized option \"" + std::string(name) + '\"');
+        } else if (setting == Setting::PrintPC) {
+            retVal.printpc = true;
+            return retVal;
+        }
+        auto optionView = tokens.next();
+        if (optionView.empty()) {
+            throw std::runtime_error("Option \"" + std::string(name) + "\" is missing a required value");
+        }
+        switch (setting) {
+        case Setting::Type:
+        {
+            std::string option(optionView);
+            if (option == "default") {
+                retVal.mode = defaultFont;
+            } else if (!fontList.contains(option)) {
+                throw std::runtime_error(option.insert(0, "Font \"") + "\" was not defined");
+            } else {
+                retVal.mode = option;
             }
-            if (name == "") {
-                throw std::runtime_error("@ symbol found, but no setting specified.");
+            if (retVal.maxWidth >= 0) {
+                retVal.maxWidth = fontList[retVal.mode].getMaxWidth();
             }
-            if (std::find(SUPPORTED_SETTINGS.begin(), SUPPORTED_SETTINGS.end(), name) == SUPPORTED_SETTINGS.end()) {
-                throw std::runtime_error(name.insert(0, "Unrecognized option \"") + '\"');
-            } else {
-                if (name == "printpc") {
-                    retVal.printpc = true;
+            break;
+        }
+        case Setting::Address:
+            if (optionView != "auto") {
+                auto result = util::strToHex(optionView);
+                int convertedAddress = mapper.ToPC(result.first);
+                if (result.second >= 0 && convertedAddress >= 0) {
+                    retVal.currentAddress = result.first;
+                } else if (convertedAddress == -2) {
+                    throw std::runtime_error("Invalid option \"" + std::string(optionView) + "\" for address: address is too large for the specified ROM size.");
                 } else {
-                    std::string option = "";
-                    if (!it.done()) {
-                        for (++it; !it.done() && !u_isspace(it.ufront()) ; ++it) {
-                            option += *it;
-                        }
-                    }
-                    if (option != "") {
-                        if (name == "type") {
-                            if (option == "default") {
-                                retVal.mode = defaultFont;
-                            } else if (fontList.find(option) == fontList.end()) {
-                                throw std::runtime_error(option.insert(0, "Font \"") + "\" was not defined");
-                            } else {
-                                retVal.mode = option;
-                            }
-                            if (retVal.maxWidth >= 0) {
-                                retVal.maxWidth = fontList[retVal.mode].getMaxWidth();
-                            }
-                        } else if (name == "address") {
-                            if (option != "auto") {
-                                auto result = util::strToHex(option);
-                                int convertedAddress = mapper.ToPC(result.first);
-                                if (result.second >= 0 && mapper.ToPC(result.first) >= 0) {
-                                    retVal.currentAddress = util::strToHex(option).first;
-                                } else {
-                                    if (convertedAddress == -2) {
-                                        throw std::runtime_error(option.insert(0, "Invalid option \"") + "\" for address: address is too large for the specified ROM size.");
-                                    } else {
-                                        // don't need to handle -2 case since it won't happen when given an SNES-style address to start with.
-                                        throw std::runtime_error(option.insert(0, "Invalid option \"") + "\" for address: must be auto or a SNES address.");
-                                    }
-                                }
-                            }
-                        } else if (name == "width") {
-                            if (option == "off") {
-                                retVal.maxWidth = -1;
-                            } else {
-                                if (!(std::istringstream(option) >> std::dec >> retVal.maxWidth)) {
-                                    throw std::runtime_error(option.insert(0, "Invalid option \"") + "\" for width: must be off or a decimal number.");
-                                }
-                            }
-                        } else if (name == "label") {
-                            retVal.label = option;
-                        } else if (name == "autoend") {
-                            retVal.autoend = options::parseBool<ParseSettings::Autoend>(name, option);
-                        } else if (name == "page") {
-                            try {
-                                int page = std::stoi(option);
-                                retVal.page = page;
-                            } catch (std::invalid_argument &e) {
-                                throw std::runtime_error(option.insert(0, "Page \"") + "\" is not a decimal integer.");
-                            }
-                        } else if (name == "end_on_label") {
-                            retVal.endOnLabel = options::parseBool<ParseSettings::EndOnLabel>(name, option);
-                        } else if (name == "export_width") {
-                            retVal.exportWidth = options::parseBool<sable::options::ExportWidth>(name, option);
-                        } else if (name == "export_address") {
-                            retVal.exportAddress = options::parseBool<sable::options::ExportAddress>(name, option);
-                        } else {
-                            // should be unreachable
-                            throw std::runtime_error(name.insert(0, "Unrecognized option \"") + '\"');
-                        }
-                    } else {
-                        throw std::runtime_error(name.insert(0, "Option \"") + "\" is missing a required value");
-                    }
+                    // don't need to handle -2 case since it won't happen when given an SNES-style address to start with.
+                    throw std::runtime_error("Invalid option \"" + std::string(optionView) + "\" for address: must be auto or a SNES address.");
                 }
             }
-        } else {
-            //probably unreachable
-            throw std::runtime_error("@ symbol found, but no setting specified.");
+            break;
+        case Setting::Width:
+            if (optionView == "off") {
+                retVal.maxWidth = -1;
+            } else if (auto width = util::parseInt(optionView)) {
+                retVal.maxWidth = *width;
+            } else {
+                throw std::runtime_error("Invalid option \"" + std::string(optionView) + "\" for width: must be off or a decimal number.");
+            }
+            break;
+        case Setting::Label:
+            retVal.label = optionView;
+            break;
+        case Setting::Autoend:
+            retVal.autoend = options::parseBool<ParseSettings::Autoend>(std::string(name), std::string(optionView));
+            break;
+        case Setting::Page:
+            if (auto page = util::parseInt(optionView)) {
+                retVal.page = *page;
+            } else {
+                throw std::runtime_error("Page \"" + std::string(optionView) + "\" is not a decimal integer.");
+            }
+            break;
+        case Setting::EndOnLabel:
+            retVal.endOnLabel = options::parseBool<ParseSettings::EndOnLabel>(std::string(name), std::string(optionView));
+            break;
+        case Setting::ExportWidth:
+            retVal.exportWidth = options::parseBool<sable::options::ExportWidth>(std::string(name), std::string(optionView));
+            break;
+        case Setting::ExportAddress:
+            retVal.exportAddress = options::parseBool<sable::options::ExportAddress>(std::string(name), std::string(optionView));
+            break;
+        default:
+            // should be unreachable
+            throw std::runtime_error("Unrecognized option \"" + std::string(name) + '\"');
         }
         return retVal;
     }
+    // builds lineKey for line, and returns false if the line can't be cached.
+    bool makeLineKey(const TokenStream& tokens, const TokenStream::Line& line, const ParseSettings& settings)
+    {
+        if (lineCacheSize == 0 || line.firstToken == line.lastToken) {
+            return false;
+        }
+        auto appendNumber = [this] (std::uint32_t value) {
+            lineKey.append(reinterpret_cast<const char*>(&value), sizeof(value));
+        };
+        lineKey.assign(settings.mode);
+        lineKey += '\0';
+        appendNumber(settings.page);
+        lineKey += static_cast<char>(settings.autoend);
+        for (auto index = line.firstToken; index < line.lastToken; ++index) {
+            const auto& token = tokens.token(index);
+            // settings and comments depend on more than the line itself.
+            if (token.type == TokenStream::Type::Directive || token.type == TokenStream::Type::Comment) {
+                return false;
+            }
+            auto text = tokens.text(token);
+            lineKey += static_cast<char>(token.type);
+            appendNumber(text.size());
+            lineKey.append(text);
+        }
+        return true;
+    }
+    const CachedLine* findLine()
+    {
+        auto it = cachedLines.find(lineKey);
+        if (it == cachedLines.end()) {
+            ++lineCacheStats.misses;
+            return nullptr;
+        }
+        ++lineCacheStats.hits;
+        lineCache.splice(lineCache.begin(), lineCache, it->second);
+        return &it->second->second;
+    }
+    void addLine(CachedLine&& line)
+    {
+        if (lineCache.size() >= lineCacheSize) {
+            cachedLines.erase(lineCache.back().first);
+            lineCache.pop_back();
+        }
+        lineCache.emplace_front(lineKey, std::move(line));
+        cachedLines.emplace(lineCache.front().first, lineCache.begin());
+    }
+    static void checkAddress(const ParseSettings& settings, const util::Mapper& mapper)
+    {
+        if (settings.currentAddress == 0) {
+            throw std::runtime_error("Attempted to parse text before address was set.");
+        } else if (mapper.ToPC(settings.currentAddress) == -1) {
+            std::ostringstream err;
+            err << "Attempted to begin parsing with invalid ROM address $" << std::hex << settings.currentAddress;
+            throw std::runtime_error(err.str());
+        }
+    }
     static void insertData(unsigned int code, int size, back_inserter bi)
     {
         while (size-- > 0) {
@@ -147,11 +251,72 @@ struct TextParser::Impl {
             code >>= 8;
         }
     }
+    // the tables to encode a font's text runs with, when statistics aren't being collected.
+    const sable::CompiledFont* compiledFont(const ParseSettings& settings) const
+    {
+        if (stats) {
+            return nullptr;
+        }
+        auto font = fontList.getCompiled(settings.mode);
+        return font != nullptr && settings.page >= 0 && static_cast<std::size_t>(settings.page) < font->pageCount ? font : nullptr;
+    }
+    // encodes a text run from firstChar the way the font's maps would, but straight from
+    // its compiled tables. Returns false, leaving everything as it was, if the run has
+    // anything the tables don't, so the maps can encode it or say what's wrong.
+    static bool encodeCompiled(
+        const sable::CompiledFont& font,
+        const TokenStream& tokens,
+        const TokenStream::Token& token,
+        std::uint32_t firstChar,
+        const TokenStream::Token* nextRun,
+        int page,
+        std::vector<unsigned char>& output,
+        int& length,
+        std::uint32_t& used
+    ) {
+        auto start = output.size();
+        auto insert = std::back_inserter(output);
+        if (auto noun = font.findNoun(page, tokens.textFrom(token, firstChar)); noun != nullptr) {
+            auto codes = font.pages[page].nounCodes + noun->firstCode;
+            for (auto code = codes; code != codes + noun->codeCount; ++code) {
+                insertData(*code, font.byteWidth, insert);
+            }
+            return true;
+        }
+        int runLength = 0;
+        std::uint32_t runUsed = 0;
+        for (auto charIndex = firstChar; charIndex < token.lastChar; ++charIndex) {
+            auto currentChar = tokens.character(token, charIndex);
+            bool lastChar = charIndex + 1 == token.lastChar;
+            const sable::CompiledFont::Glyph* glyph = nullptr;
+            if (font.hasDigraphs) {
+                if (!lastChar) {
+                    glyph = font.findDigraph(page, currentChar, tokens.character(token, charIndex + 1));
+                } else if (nextRun != nullptr) {
+                    glyph = font.findDigraph(page, currentChar, tokens.character(*nextRun, nextRun->firstChar));
+                }
+            }
+            if (glyph != nullptr) {
+                if (!lastChar) {
+                    ++charIndex;
+                } else {
+                    runUsed = 1;
+                }
+            } else if (glyph = font.findGlyph(page, currentChar); glyph == nullptr) {
+                output.resize(start);
+                return false;
+            }
+            runLength += font.getWidth(page, glyph->code);
+            insertData(glyph->code, font.byteWidth, insert);
+        }
+        length += runLength;
+        used = runUsed;
+        return true;
+    }
 };
 
 TextParser::TextParser(
-        std::map<std::string,
-        sable::Font>&& list,
+        FontList&& list,
         const std::string& defaultMode,
         const std::string& locale,
         options::ExportWidth defaultExportWidth,
@@ -180,15 +345,65 @@ TextParser::Result TextParser::parseLine(
         Metadata lastReadWasMetadata,
         const util::Mapper& mapper)
 {
+    std::vector<unsigned char> output;
+    auto result = parseLine(input, settings, output, lastReadWasMetadata, mapper);
+    std::copy(output.begin(), output.end(), insert);
+    return result;
+}
+
+TextParser::Result TextParser::parseLine(
+        std::istream &input,
+        ParseSettings & settings,
+        std::vector<unsigned char>& output,
+        Metadata lastReadWasMetadata,
+        const util::Mapper& mapper)
+{
+    auto& tokens = _pImpl->lineTokens;
+    tokens.clear();
+    tokens.append(input, _pImpl->m_Locale);
+    TokenStream::Reader reader(tokens);
+    auto result = parseLine(reader, settings, output, lastReadWasMetadata, mapper);
+    if (!reader) {
+        input.setstate(std::ios::failbit);
+    } else if (reader.eof()) {
+        input.setstate(std::ios::eofbit);
+    }
+    return result;
+}
+
+TextParser::Result TextParser::parseLine(
+        TokenStream::Reader &input,
+        ParseSettings & settings,
+        back_inserter insert,
+        Metadata lastReadWasMetadata,
+        const util::Mapper& mapper)
+{
+    std::vector<unsigned char> output;
+    auto result = parseLine(input, settings, output, lastReadWasMetadata, mapper);
+    std::copy(output.begin(), output.end(), insert);
+    return result;
+}
+
+TextParser::Result TextParser::parseLine(
+        TokenStream::Reader &input,
+        ParseSettings & settings,
+        std::vector<unsigned char>& output,
+        Metadata lastReadWasMetadata,
+        const util::Mapper& mapper)
+{
+    using Type = TokenStream::Type;
     int length = 0;
     bool finished = false;
-    std::string line{""};
-    std::istream& state = getline(input, line, '\n');
     auto label = settings.label;
     Metadata mt = Metadata::No;
+    auto insert = std::back_inserter(output);
 
-    auto insertCommand = [&insert = insert, &_pImpl = _pImpl, &font = _pImpl->fontList[settings.mode]] (std::string code)
+    auto* stats = _pImpl->stats.get();
+    auto insertCommand = [&insert = insert, &_pImpl = _pImpl, &font = _pImpl->fontList[settings.mode], stats, &settings] (std::string code)
     {
+        if (stats) {
+            stats->addCommand(settings.mode, code == "" ? "End" : code);
+        }
         if (font.getCommandValue() != -1) {
             _pImpl->insertData(font.getCommandValue(), font.getByteWidth(), insert);
         }
@@ -200,39 +415,59 @@ TextParser::Result TextParser::parseLine(
 
     };
 
-    if (!state.fail()) {
-        if (line.find('\r') != std::string::npos) {
-            line.erase(line.find('\r'), 1);
-        }
-
-        BreakIterator it(true, line, _pImpl->m_Locale);
+    if (const auto* line = input.next(); line != nullptr) {
+        const auto& tokens = input.stream();
         bool printNewLine = true;
-        bool finishedByComment = false;
-        std::string ref = *it;
-        while (!(it++.done()) && !finished && !finishedByComment) {
-            if (ref == "#") {
-                finishedByComment = true;
+        // characters at the start of the next text run which a digraph already used.
+        std::uint32_t used = 0;
+        // statistics count every glyph, so lines aren't copied while they're collected.
+        bool cacheable = stats == nullptr && _pImpl->makeLineKey(tokens, *line, settings);
+        const auto* cached = cacheable ? _pImpl->findLine() : nullptr;
+        auto start = output.size();
+        std::size_t textOffset = std::string::npos;
+        if (cached != nullptr) {
+            if (cached->textOffset == std::string::npos) {
+                output.insert(output.end(), cached->data.begin(), cached->data.end());
+            } else {
+                // the address is checked at the same point it would be while parsing.
+                output.insert(output.end(), cached->data.begin(), cached->data.begin() + cached->textOffset);
+                Impl::checkAddress(settings, mapper);
+                output.insert(output.end(), cached->data.begin() + cached->textOffset, cached->data.end());
+            }
+            length = cached->length;
+            settings.page = cached->page;
+            finished = cached->finished;
+            printNewLine = cached->printNewLine;
+        }
+        for (auto index = line->firstToken; cached == nullptr && index < line->lastToken && !finished; ++index) {
+            const auto& token = tokens.token(index);
+            if (token.type == Type::Comment) {
                 if (input.peek() == std::char_traits<char>::eof()) {
                      printNewLine = false;
                 }
                 mt = Metadata::Yes;
-            } else if (ref == "[") {
-                std::string temp;
-                {
-                    std::string bracketContents = "";
-                    for ( ; *it != "]" && !it.done(); ++it) {
-                        bracketContents += *it;
-                    }
-                    if (it.done()) {
-                        throw std::runtime_error("Closing bracket not found.");
-                    }
-                    temp = bracketContents;
-                    ref = *(++it);
-                }
+            } else if (token.type == Type::Unclosed) {
+                throw std::runtime_error("Closing bracket not found.");
+            } else if (token.type == Type::Bracket) {
+                std::string temp(tokens.text(token));
                 {
                     unsigned int code;
                     int bytes;
+                    bool isGlyph = false;
                     std::tie(code, bytes) = util::strToHex(temp);
+                    // glyphs and extras can be found in compiled tables without missing the commands first.
+                    auto compiled = bytes < 0 ? _pImpl->compiledFont(settings) : nullptr;
+                    if (compiled != nullptr && compiled->findCommand(temp) == nullptr) {
+                        if (auto glyph = compiled->findGlyph(settings.page, temp); glyph != nullptr) {
+                            bytes = compiled->byteWidth;
+                            code = glyph->code;
+                            length += compiled->getWidth(settings.page, glyph->code);
+                            isGlyph = true;
+                        } else if (auto extra = compiled->findExtra(temp); extra != nullptr) {
+                            bytes = compiled->byteWidth;
+                            code = extra->value;
+                        }
+                    }
                     if (bytes < 0) {
                         bytes = _pImpl->fontList[settings.mode].getByteWidth();
                         try {
@@ -251,12 +486,16 @@ TextParser::Result TextParser::parseLine(
                                     );
                                 }
                                 settings.page = codeStruct.page;
+                                if (stats) {
+                                    stats->addPageSwitch(settings.mode, settings.page);
+                                }
                             }
                             printNewLine = !codeStruct.isNewLine;
                         } catch (CodeNotFound &e) {
                             try {
                                 std::tie(code, std::ignore) = _pImpl->fontList[settings.mode].getTextCode(settings.page, temp);
                                 length += _pImpl->fontList[settings.mode].getWidth(settings.page, temp);
+                                isGlyph = true;
                             } catch (CodeNotFound &e) {
                                 try {
                                     code = _pImpl->fontList[settings.mode].getExtraValue(temp);
@@ -282,21 +521,31 @@ TextParser::Result TextParser::parseLine(
 
                     if (!finished) {
                          _pImpl->insertData(code, bytes, insert);
+                         if (stats) {
+                             if (isGlyph) {
+                                 stats->addGlyph(settings.mode, settings.page, temp);
+                             } else {
+                                 stats->addCommand(settings.mode, temp);
+                             }
+                         }
                     }
                 }
-            } else if (ref == "@") {
+            } else if (token.type == Type::Directive) {
                 mt = Metadata::Yes;
-                auto startPoint = --it;
-                settings = _pImpl->updateSettings(settings, it, mapper);
+                auto lastPage = settings.page;
+                settings = _pImpl->updateSettings(settings, tokens.text(token).substr(1), mapper);
                 if (!(settings.page < _pImpl->fontList[settings.mode].getNumberOfPages())) {
                     throw std::runtime_error(
                         std::string("Page ") + std::to_string(settings.page) + " not found in font " + settings.mode
                     );
                 }
+                if (stats && settings.page != lastPage) {
+                    stats->addPageSwitch(settings.mode, settings.page);
+                }
                 if (settings.label != label) {
                     finished |= options::isEnabled(settings.endOnLabel);
                 }
-                if (it.atStart() && (state.peek() != std::char_traits<char>::eof())) {
+                if (token.startsLine && (input.peek() != std::char_traits<char>::eof())) {
                     return Result{
                         finished,
                         length,
@@ -304,41 +553,47 @@ TextParser::Result TextParser::parseLine(
                         mt
                     };
                 }
-                while (!it.done()) {
-                    ++it;
-                }
             } else {
-                if (settings.currentAddress == 0) {
-                    throw std::runtime_error("Attempted to parse text before address was set.");
-                } else if (mapper.ToPC(settings.currentAddress) == -1) {
-                    std::ostringstream err;
-                    err << "Attempted to begin parsing with invalid ROM address $" << std::hex << settings.currentAddress;
-                    throw std::runtime_error(err.str());
+                if (textOffset == std::string::npos) {
+                    textOffset = output.size() - start;
+                }
+                Impl::checkAddress(settings, mapper);
+                auto firstChar = token.firstChar + used;
+                used = 0;
+                // a digraph can use the first character of the next text run.
+                const TokenStream::Token* nextRun = nullptr;
+                if (index + 1 < line->lastToken && tokens.token(index + 1).type == Type::Text) {
+                    nextRun = &tokens.token(index + 1);
+                    auto first = tokens.character(*nextRun, nextRun->firstChar);
+                    if (first == "[" || first == "@" || first == "#") {
+                        nextRun = nullptr;
+                    }
                 }
-                std::string contents = ref;
+                if (auto compiled = _pImpl->compiledFont(settings);
+                    compiled != nullptr &&
+                    Impl::encodeCompiled(*compiled, tokens, token, firstChar, nextRun, settings.page, output, length, used)
+                ) {
+                    continue;
+                }
+                std::string contents(tokens.textFrom(token, firstChar));
                 try {
                     auto noun = _pImpl->fontList[settings.mode].getNounData(settings.page, contents);
                     while (noun) {
                         _pImpl->insertData(*(noun++), _pImpl->fontList[settings.mode].getByteWidth(), insert);
                     }
+                    if (stats) {
+                        stats->addNoun(settings.mode, settings.page, contents);
+                    }
                 } catch (CodeNotFound &e) {
                     auto checkDigraphs = _pImpl->fontList[settings.mode].getHasDigraphs();
-                    std::string tmpStr = *it;
-                    BreakIterator charIt (false, contents, _pImpl->m_Locale);
-
-                    std::optional<BreakIterator> nextCharItr = std::nullopt;
-                    if (tmpStr != "") {
-                        nextCharItr = BreakIterator(false, tmpStr, _pImpl->m_Locale);
-                    }
-                    for ( ;!charIt.done(); ++charIt) {
-                        std::string currentChar = *charIt, nextChar = "";
-                        auto peek = charIt;
+                    for (auto charIndex = firstChar; charIndex < token.lastChar; ++charIndex) {
+                        std::string currentChar(tokens.character(token, charIndex)), nextChar = "";
+                        bool lastChar = charIndex + 1 == token.lastChar;
                         if (checkDigraphs) {
-                            if (!(++peek).done()) {
-                                nextChar = *peek;
-                            } else if (nextCharItr != std::nullopt &&
-                                (**nextCharItr != "[" && **nextCharItr != "@" && **nextCharItr != "#")) {
-                                nextChar = **nextCharItr;
+                            if (!lastChar) {
+                                nextChar = tokens.character(token, charIndex + 1);
+                            } else if (nextRun != nullptr) {
+                                nextChar = tokens.character(*nextRun, nextRun->firstChar);
                             }
                         }
                         unsigned int code;
@@ -346,40 +601,47 @@ TextParser::Result TextParser::parseLine(
 
                         std::tie<>(code, advance) = _pImpl->fontList[settings.mode].getTextCode(settings.page, currentChar, nextChar);
                         if (advance) {
-                            if (!peek.done()) {
-                                ++charIt;
+                            if (!lastChar) {
+                                ++charIndex;
                             } else {
-                                if (nextCharItr != std::nullopt && !nextCharItr->done()) {
-                                    ++(*nextCharItr);
-                                }
+                                used = 1;
                             }
                             length += _pImpl->fontList[settings.mode].getWidth(settings.page, currentChar + nextChar);
                         } else {
                             length += _pImpl->fontList[settings.mode].getWidth(settings.page, currentChar);
                         }
                         _pImpl->insertData(code, _pImpl->fontList[settings.mode].getByteWidth(), insert);
-                    }
-                    if (nextCharItr != std::nullopt) {
-                        ref = "";
-                        while (!nextCharItr->done()) {
-                            ref += **nextCharItr;
-                            ++(*nextCharItr);
+                        if (stats) {
+                            if (!nextChar.empty()) {
+                                stats->addDigraph(settings.mode, settings.page, currentChar + nextChar, advance);
+                            }
+                            stats->addGlyph(settings.mode, settings.page, advance ? currentChar + nextChar : currentChar);
                         }
                     }
                 }
             }
         }
 
+        if (cacheable && cached == nullptr) {
+            _pImpl->addLine(Impl::CachedLine{
+                std::vector<unsigned char>(output.begin() + start, output.end()),
+                length,
+                settings.page,
+                finished,
+                printNewLine,
+                textOffset
+            });
+        }
         if (printNewLine &&
                 !finished &&
-                state.peek() != std::char_traits<char>::eof() &&
-                !state.eof() &&
+                input.peek() != std::char_traits<char>::eof() &&
+                !input.eof() &&
                 input.peek() != '#'  &&
                 input.peek() != '@') {
             insertCommand("NewLine");
         }
         if (finished ||
-            (mt == Metadata::No && state.peek() == std::char_traits<char>::eof())
+            (mt == Metadata::No && input.peek() == std::char_traits<char>::eof())
         ) {
             if (options::isEnabled(settings.autoend)) {
                 insertCommand("");
@@ -391,7 +653,7 @@ TextParser::Result TextParser::parseLine(
         if (options::isEnabled(settings.autoend) && lastReadWasMetadata == Metadata::Yes) {
             insertCommand("");
         }
-    } // !state.fail()
+    } // line != nullptr
 
     return Result{
         finished,
@@ -401,11 +663,42 @@ TextParser::Result TextParser::parseLine(
     };
 }
 
-const std::map<std::string, sable::Font> &TextParser::getFonts() const
+TokenStream TextParser::lex(std::istream &input)
+{
+    TokenStream tokens;
+    while (tokens.append(input, _pImpl->m_Locale)) {}
+    return tokens;
+}
+
+const sable::FontList &TextParser::getFonts() const
 {
     return _pImpl->fontList;
 }
 
+void TextParser::setStats(std::shared_ptr<ParseStats> stats)
+{
+    _pImpl->stats = std::move(stats);
+}
+
+void TextParser::setLineCacheSize(std::size_t lines)
+{
+    _pImpl->lineCacheSize = lines;
+    while (_pImpl->lineCache.size() > lines) {
+        _pImpl->cachedLines.erase(_pImpl->lineCache.back().first);
+        _pImpl->lineCache.pop_back();
+    }
+}
+
+auto TextParser::getLineCacheStats() const -> LineCacheStats
+{
+    return _pImpl->lineCacheStats;
+}
+
+sable::ParseStats *TextParser::getStats() const
+{
+    return _pImpl->stats.get();
+}
+
 auto TextParser::getDefaultSetting(int address) const -> ParseSettings
 {
     auto def = _pImpl->defaultFont;
@@ -8,8 +8,11 @@
 #include <memory>
 
 #include "font/font.h"
+#include "font/fontlist.h"
 #include "data/options.h"
 #include "data/mapper.h"
+#include "tokenstream.h"
+#include "parsestats.h"
 
 namespace sable {
     typedef std::back_insert_iterator<std::vector<unsigned char>> back_inserter;
@@ -48,7 +51,7 @@ namespace sable {
         // these need to be defaulted externally for the pImpl idiom to work
         ~TextParser();
         TextParser(
-            std::map<std::string, sable::Font>&& list,
+            FontList&& list,
             const std::string& defaultMode,
             const std::string& locale,
             options::ExportWidth defaultExportWidth,
@@ -68,7 +71,43 @@ namespace sable {
                 Metadata lastReadWasMetadata,
                 const util::Mapper& mapper
         );
-        const std::map<std::string, sable::Font>& getFonts() const;
+        // encodes the next line of a script which was already lexed.
+        Result parseLine(
+                TokenStream::Reader &input,
+                ParseSettings &settings,
+                back_inserter insert,
+                Metadata lastReadWasMetadata,
+                const util::Mapper& mapper
+        );
+        // the same, but appends to output directly, which lets repeated lines be copied
+        // from the line cache. The inserter versions encode into a vector of their own.
+        Result parseLine(
+                std::istream &input,
+                ParseSettings &settings,
+                std::vector<unsigned char>& output,
+                Metadata lastReadWasMetadata,
+                const util::Mapper& mapper
+        );
+        Result parseLine(
+                TokenStream::Reader &input,
+                ParseSettings &settings,
+                std::vector<unsigned char>& output,
+                Metadata lastReadWasMetadata,
+                const util::Mapper& mapper
+        );
+        // splits a whole script into tokens, which can be encoded with any font.
+        TokenStream lex(std::istream& input);
+        const FontList& getFonts() const;
+        // everything encoded from then on is counted in stats, until it's set to nullptr.
+        void setStats(std::shared_ptr<ParseStats> stats);
+        ParseStats* getStats() const;
+        struct LineCacheStats {
+            std::size_t hits, misses;
+        };
+        // lines without settings or comments are only encoded once for each font, page
+        // and autoend setting, and copied after that. 0 turns the cache off.
+        void setLineCacheSize(std::size_t lines);
+        LineCacheStats getLineCacheStats() const;
         ParseSettings getDefaultSetting(int address) const;
     };
 }
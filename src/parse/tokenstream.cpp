@@ -0,0 +1,210 @@
+#include "tokenstream.h"
+
+#include "unicode.h"
+#include "font/normalize.h"
+
+namespace sable {
+
+namespace {
+    // the length of a UTF-16 range once it's converted to UTF-8.
+    std::uint32_t utf8Length(const icu::UnicodeString& text, int32_t start, int32_t end)
+    {
+        std::uint32_t length = 0;
+        for (int32_t index = start; index < end; index = text.moveIndex32(index, 1)) {
+            UChar32 c = text.char32At(index);
+            length += c < 0x80 ? 1 : c < 0x800 ? 2 : c < 0x10000 ? 3 : 4;
+        }
+        return length;
+    }
+}
+
+TokenStream::Reader::Reader(const TokenStream &stream): m_Stream{&stream}, m_Line{0}, m_Eof{false}, m_Failed{false}
+{
+}
+
+const TokenStream::Line *TokenStream::Reader::next()
+{
+    if (m_Eof || m_Line >= m_Stream->lines()) {
+        m_Eof = m_Failed = true;
+        return nullptr;
+    }
+    const auto& line = m_Stream->line(m_Line++);
+    // getline stops at the end of the text when the last line has no newline.
+    m_Eof = !line.terminated;
+    return &line;
+}
+
+int TokenStream::Reader::peek()
+{
+    if (m_Eof) {
+        m_Failed = true;
+        return std::char_traits<char>::eof();
+    }
+    int next = m_Line == 0 ? m_Stream->m_First : m_Stream->line(m_Line - 1).next;
+    m_Eof = next == std::char_traits<char>::eof();
+    return next;
+}
+
+const TokenStream &TokenStream::Reader::stream() const
+{
+    return *m_Stream;
+}
+
+bool TokenStream::Reader::eof() const
+{
+    return m_Eof;
+}
+
+TokenStream::Reader::operator bool() const
+{
+    return !m_Failed;
+}
+
+bool TokenStream::append(std::istream &input, const icu::Locale &locale)
+{
+    if (m_Lines.empty() && input) {
+        m_First = input.rdbuf()->sgetc();
+    }
+    std::string raw;
+    if (!std::getline(input, raw, '\n')) {
+        return false;
+    }
+    if (auto cr = raw.find('\r'); cr != std::string::npos) {
+        raw.erase(cr, 1);
+    }
+    // fonts are normalized when they're built, so once the line is too the lookups
+    // can use it as it is. Most scripts are already NFC, which is cheap to check.
+    if (!isNormalized(raw)) {
+        raw = normalize(raw);
+    }
+    if (!m_Words || m_LocaleName != locale.getName()) {
+        m_Words = createBreakIterator(true, locale);
+        m_Characters = createBreakIterator(false, locale);
+        m_LocaleName = locale.getName();
+    }
+
+    auto text = icu::UnicodeString::fromUTF8(raw);
+    std::string word;
+    auto segment = [&text, &word] (int32_t start, int32_t end) -> const std::string& {
+        word.clear();
+        return text.tempSubStringBetween(start, end).toUTF8String(word);
+    };
+    auto push = [this] (Type type, bool startsLine, std::uint32_t begin) {
+        m_Tokens.push_back({type, startsLine, begin, static_cast<std::uint32_t>(m_Text.size()), 0, 0});
+    };
+
+    Line line{static_cast<std::uint32_t>(m_Tokens.size()), 0, std::char_traits<char>::eof(), !input.eof()};
+    m_Words->setText(text);
+    int32_t start = m_Words->first();
+    for (int32_t end = m_Words->next(); end != icu::BreakIterator::DONE; start = end, end = m_Words->next()) {
+        auto begin = static_cast<std::uint32_t>(m_Text.size());
+        if (segment(start, end) == "#") {
+            push(Type::Comment, start == 0, begin);
+            break;
+        } else if (word == "[") {
+            auto type = Type::Unclosed;
+            for (start = end, end = m_Words->next(); end != icu::BreakIterator::DONE; start = end, end = m_Words->next()) {
+                if (segment(start, end) == "]") {
+                    type = Type::Bracket;
+                    break;
+                }
+                m_Text += word;
+            }
+            push(type, false, begin);
+            if (type == Type::Unclosed) {
+                break;
+            }
+        } else if (word.front() == '@') {
+            // the rest of the line belongs to the setting.
+            text.tempSubString(start).toUTF8String(m_Text);
+            push(Type::Directive, start == 0, begin);
+            break;
+        } else {
+            m_Text += word;
+            push(Type::Text, start == 0, begin);
+            auto& token = m_Tokens.back();
+            token.firstChar = m_CharEnds.size();
+            icu::UnicodeString characters(text, start, end - start);
+            m_Characters->setText(characters);
+            auto charEnd = begin;
+            int32_t charStart = m_Characters->first();
+            for (int32_t next = m_Characters->next(); next != icu::BreakIterator::DONE; charStart = next, next = m_Characters->next()) {
+                charEnd += utf8Length(characters, charStart, next);
+                m_CharEnds.push_back(charEnd);
+            }
+            token.lastChar = m_CharEnds.size();
+        }
+    }
+    line.lastToken = m_Tokens.size();
+    // looked at through the buffer, so the stream's state is left as getline left it.
+    if (!input.eof()) {
+        line.next = input.rdbuf()->sgetc();
+    }
+    m_Lines.push_back(line);
+    return true;
+}
+
+void TokenStream::clear()
+{
+    m_Text.clear();
+    m_Tokens.clear();
+    m_CharEnds.clear();
+    m_Lines.clear();
+    m_First = std::char_traits<char>::eof();
+}
+
+std::size_t TokenStream::lines() const
+{
+    return m_Lines.size();
+}
+
+const TokenStream::Line &TokenStream::line(std::size_t index) const
+{
+    return m_Lines[index];
+}
+
+const TokenStream::Token &TokenStream::token(std::size_t index) const
+{
+    return m_Tokens[index];
+}
+
+std::string_view TokenStream::text(const Token &token) const
+{
+    return std::string_view(m_Text).substr(token.begin, token.end - token.begin);
+}
+
+std::string_view TokenStream::character(const Token &token, std::uint32_t index) const
+{
+    std::uint32_t begin = index == token.firstChar ? token.begin : m_CharEnds[index - 1];
+    return std::string_view(m_Text).substr(begin, m_CharEnds[index] - begin);
+}
+
+std::string_view TokenStream::textFrom(const Token &token, std::uint32_t index) const
+{
+    std::uint32_t begin = index == token.firstChar ? token.begin : m_CharEnds[index - 1];
+    return std::string_view(m_Text).substr(begin, token.end - begin);
+}
+
+std::shared_ptr<const TokenStream> TokenCache::find(const std::string &file) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (auto it = m_Streams.find(file); it != m_Streams.end()) {
+        return it->second;
+    }
+    return nullptr;
+}
+
+std::shared_ptr<const TokenStream> TokenCache::add(const std::string &file, TokenStream &&tokens)
+{
+    auto stream = std::make_shared<const TokenStream>(std::move(tokens));
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Streams.insert_or_assign(file, stream).first->second;
+}
+
+std::size_t TokenCache::size() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Streams.size();
+}
+
+}
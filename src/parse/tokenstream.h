@@ -0,0 +1,113 @@
+#ifndef TOKENSTREAM_H
+#define TOKENSTREAM_H
+
+#include <cstdint>
+#include <istream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <unicode/brkiter.h>
+#include <unicode/locid.h>
+
+namespace sable {
+
+// A script split into the pieces TextParser encodes: text runs, bracketed codes,
+// settings and comments, one line at a time. Nothing in it depends on a font, so
+// a script can be lexed once and encoded with any number of fonts or settings
+// without running the Unicode segmentation again.
+class TokenStream
+{
+public:
+    enum class Type : std::uint8_t {
+        Text,
+        // the contents of a bracketed code, without the brackets.
+        Bracket,
+        // a [ without a closing bracket.
+        Unclosed,
+        // an @ setting, up to the end of the line.
+        Directive,
+        // a #, which ends the line.
+        Comment
+    };
+    struct Token {
+        Type type;
+        // a setting on a line of its own doesn't end the line.
+        bool startsLine;
+        // where the token's text is.
+        std::uint32_t begin, end;
+        // text runs: the range of their characters.
+        std::uint32_t firstChar, lastChar;
+    };
+    struct Line {
+        std::uint32_t firstToken, lastToken;
+        // the first character of the next line, or char_traits eof if this is the last one.
+        int next;
+        // whether the line ended with a newline rather than the end of the text.
+        bool terminated;
+    };
+
+    // reads the stream one line at a time, with the same end of file behaviour
+    // as calling getline and peek on the original text.
+    class Reader {
+        const TokenStream* m_Stream;
+        std::size_t m_Line;
+        bool m_Eof, m_Failed;
+    public:
+        explicit Reader(const TokenStream& stream);
+        // the next line, or nullptr once every line has been read.
+        const Line* next();
+        // the first character of the line after the one last read.
+        int peek();
+        const TokenStream& stream() const;
+        bool eof() const;
+        // false after reading or peeking past the end, like a failed istream.
+        explicit operator bool() const;
+    };
+
+    // appends the next line of input, and returns false if there wasn't one.
+    // characters and words are split with locale's rules.
+    bool append(std::istream& input, const icu::Locale& locale);
+    void clear();
+
+    std::size_t lines() const;
+    const Line& line(std::size_t index) const;
+    const Token& token(std::size_t index) const;
+    std::string_view text(const Token& token) const;
+    // one character of a text run, by its index in firstChar to lastChar.
+    std::string_view character(const Token& token, std::uint32_t index) const;
+    // the rest of a text run starting at character index.
+    std::string_view textFrom(const Token& token, std::uint32_t index) const;
+private:
+    std::string m_Text;
+    std::vector<Token> m_Tokens;
+    // where each character of a text run ends.
+    std::vector<std::uint32_t> m_CharEnds;
+    std::vector<Line> m_Lines;
+    // the first character of the first line.
+    int m_First = std::char_traits<char>::eof();
+
+    std::unique_ptr<icu::BreakIterator> m_Words, m_Characters;
+    std::string m_LocaleName;
+};
+
+// Token streams for files which were already lexed, by file name, so a script
+// encoded for several fonts or ROMs is only lexed once. Files are assumed not to
+// change while the cache is in use.
+class TokenCache
+{
+    mutable std::mutex m_Mutex;
+    std::map<std::string, std::shared_ptr<const TokenStream>> m_Streams;
+public:
+    // returns nullptr if the file hasn't been lexed yet.
+    std::shared_ptr<const TokenStream> find(const std::string& file) const;
+    std::shared_ptr<const TokenStream> add(const std::string& file, TokenStream&& tokens);
+    std::size_t size() const;
+};
+
+}
+
+#endif // TOKENSTREAM_H
@@ -1,19 +1,34 @@
 #include "unicode.h"
 
+#include <map>
+#include <utility>
+
+// creating an ICU iterator loads its rules, which costs far more than cloning one,
+// so each thread keeps one per locale to clone from.
+std::unique_ptr<icu::BreakIterator> createBreakIterator(bool word, const icu::Locale &locale)
+{
+    thread_local std::map<std::pair<std::string, bool>, std::unique_ptr<icu::BreakIterator>> prototypes;
+    auto& prototype = prototypes[std::make_pair(std::string(locale.getName()), word)];
+    if (!prototype) {
+        UErrorCode err = U_ZERO_ERROR;
+        if (word) {
+            prototype.reset(icu::BreakIterator::createWordInstance(locale, err));
+        } else {
+            prototype.reset(icu::BreakIterator::createCharacterInstance(locale, err));
+        }
+        if (U_FAILURE(err)) {
+            prototype.reset();
+            throw BoundsException("Failed to create iterator");
+        }
+    }
+    return std::unique_ptr<icu::BreakIterator>(prototype->clone());
+}
 
 BreakIterator::BreakIterator(bool word, const std::string &data, const icu::Locale &locale)
 {
     // needs to be explicitly initialized as utf8 on MSVC
     _u16Data = icu::UnicodeString::fromUTF8(data);
-    UErrorCode _err = U_ZERO_ERROR;
-    if (word) {
-        _itr.reset(icu::BreakIterator::createWordInstance(locale, _err));
-    } else {
-        _itr.reset(icu::BreakIterator::createCharacterInstance(locale, _err));
-    }
-    if (U_FAILURE(_err)) {
-        throw BoundsException("Failed to create iterator");
-    }
+    _itr = createBreakIterator(word, locale);
     _word = word;
 
     _itr->setText(_u16Data);
@@ -10,6 +10,9 @@ struct BoundsException : std::runtime_error {
     using std::runtime_error::runtime_error;
 };
 
+// a word or character iterator for locale, without any text set.
+std::unique_ptr<icu::BreakIterator> createBreakIterator(bool word, const icu::Locale& locale);
+
 class BreakIterator
 {
     icu::UnicodeString _u16Data;
@@ -121,6 +121,24 @@ bool sable::ProjectSerializer::validateConfig(const YAML::Node &configYML)
                            " must be a string with a valid value(on/off or true/false).\n";
             isValid = false;
         }
+        if (auto dedupeOption = configYML[Project::CONFIG_SECTION][Project::DEDUPLICATE_BLOCKS];
+                dedupeOption.IsDefined() && !dedupeOption.IsScalar()) {
+            errorString << Project::CONFIG_SECTION + std::string(" > ") + Project::DEDUPLICATE_BLOCKS +
+                           " must be a string with a valid value(on/off or true/false).\n";
+            isValid = false;
+        }
+        if (auto widthOption = configYML[Project::CONFIG_SECTION][Project::BINARY_FONT_WIDTHS];
+                widthOption.IsDefined() && !widthOption.IsScalar()) {
+            errorString << Project::CONFIG_SECTION + std::string(" > ") + Project::BINARY_FONT_WIDTHS +
+                           " must be a string with a valid value(on/off or true/false).\n";
+            isValid = false;
+        }
+        if (auto cacheOption = configYML[Project::CONFIG_SECTION][Project::CACHE_ASSEMBLY];
+                cacheOption.IsDefined() && !cacheOption.IsScalar()) {
+            errorString << Project::CONFIG_SECTION + std::string(" > ") + Project::CACHE_ASSEMBLY +
+                           " must be a string with a valid value(on/off or true/false).\n";
+            isValid = false;
+        }
     }
     if (!configYML[Project::ROMS].IsDefined()) {
         isValid = false;
@@ -151,6 +169,13 @@ bool sable::ProjectSerializer::validateConfig(const YAML::Node &configYML)
                     errorString << "rom " << romName << " does not have a valid header option - must be \"true\", \"false\", \"auto\", or not defined.\n";
                     isValid = false;
                 }
+                if (node["patches"].IsDefined() && (!node["patches"].IsSequence() ||
+                    std::any_of(node["patches"].begin(), node["patches"].end(), [] (const YAML::Node& format) {
+                        return !format.IsScalar() || (format.Scalar() != "ips" && format.Scalar() != "bps");
+                    }))) {
+                    errorString << "rom " << romName << " does not have a valid patches option - must be a sequence of \"ips\" and/or \"bps\".\n";
+                    isValid = false;
+                }
                 ++romindex;
             }
         }
@@ -277,6 +302,37 @@ Project ProjectSerializer::read(
     } else {
         pr.exportAllAddresses = options::ExportAddress::On;
     }
+
+    auto isExplicitlyEnabled = [] (std::string&& value) -> bool
+    {
+        std::string lower = value;
+        std::transform(value.begin(), value.end(), lower.begin(), [] (char c) {
+            return std::tolower(c);
+        });
+        return lower == "true" || lower == "on";
+    };
+
+    if (auto dedupeOption = config[Project::CONFIG_SECTION][Project::DEDUPLICATE_BLOCKS];
+        dedupeOption.IsDefined() && dedupeOption.IsScalar() &&
+        isExplicitlyEnabled(dedupeOption.as<std::string>())) {
+        pr.deduplicateBlocks = options::Deduplicate::On;
+    } else {
+        pr.deduplicateBlocks = options::Deduplicate::Off;
+    }
+    if (auto widthOption = config[Project::CONFIG_SECTION][Project::BINARY_FONT_WIDTHS];
+        widthOption.IsDefined() && widthOption.IsScalar() &&
+        isExplicitlyEnabled(widthOption.as<std::string>())) {
+        pr.binaryFontWidths = options::BinaryWidths::On;
+    } else {
+        pr.binaryFontWidths = options::BinaryWidths::Off;
+    }
+    if (auto cacheOption = config[Project::CONFIG_SECTION][Project::CACHE_ASSEMBLY];
+        cacheOption.IsDefined() && cacheOption.IsScalar() &&
+        isExplicitlyEnabled(cacheOption.as<std::string>())) {
+        pr.cacheAssembly = options::CacheAssembly::On;
+    } else {
+        pr.cacheAssembly = options::CacheAssembly::Off;
+    }
     return pr;
 }
 
@@ -311,6 +367,17 @@ bool convert<sable::ProjectSerializer::Rom>::decode(
     if (node["includes"].IsDefined() && node["includes"].IsSequence()) {
         rhs.includes = node["includes"].as<std::vector<std::string>>();
     }
+    if (node["patches"].IsDefined()) {
+        if (!node["patches"].IsSequence()) {
+            return false;
+        }
+        rhs.patches = node["patches"].as<std::vector<std::string>>();
+        for (auto& format: rhs.patches) {
+            if (format != "ips" && format != "bps") {
+                return false;
+            }
+        }
+    }
     return true;
 }
 
@@ -0,0 +1,293 @@
+#include "container.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <utility>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "data/tokenizer.h"
+#include "exceptions.h"
+
+namespace sable {
+namespace files {
+
+Container::Mapping::~Mapping()
+{
+#ifndef _WIN32
+    if (data != nullptr && size > 0) {
+        munmap(const_cast<char*>(data), size);
+    }
+#endif
+}
+
+Container::Container(const fs::path &file, const util::Mapper &mapper): m_Path{file}
+{
+    map();
+    parse(mapper);
+}
+
+const fs::path &Container::getPath() const
+{
+    return m_Path;
+}
+
+void Container::map()
+{
+    auto fail = [this] () {
+        return ParseError(fs::absolute(m_Path).string() + " could not be opened.");
+    };
+#ifndef _WIN32
+    int fd = open(m_Path.string().c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        throw fail();
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        close(fd);
+        throw fail();
+    }
+    if (info.st_size == 0) {
+        m_Mapping.data = "";
+    } else {
+        void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            close(fd);
+            throw fail();
+        }
+        // scripts are read from start to end.
+        madvise(data, info.st_size, MADV_SEQUENTIAL);
+        m_Mapping.data = static_cast<const char*>(data);
+        m_Mapping.size = info.st_size;
+    }
+    close(fd);
+#else
+    std::ifstream input(m_Path.string(), std::ios::binary);
+    if (!input) {
+        throw fail();
+    }
+    m_Mapping.contents.assign(std::istreambuf_iterator<char>(input), {});
+    m_Mapping.data = m_Mapping.contents.data();
+    m_Mapping.size = m_Mapping.contents.size();
+#endif
+}
+
+void Container::parse(const util::Mapper &mapper)
+{
+    enum class Body {None, Table, Script};
+    std::string_view rest(m_Mapping.data, m_Mapping.size);
+    int lineNumber = 0;
+    auto error = [this, &lineNumber] (const std::string& message) {
+        return ParseError(fs::absolute(m_Path).string() + ", line " + std::to_string(lineNumber) + ": " + message);
+    };
+
+    Body body = Body::None;
+    const char* bodyStart = m_Mapping.data;
+    int bodyLine = 0;
+    bool escaped = false;
+    std::vector<Script> scripts;
+    std::vector<std::string> tableFiles;
+
+    // ends the table or script whose lines run up to end.
+    auto finishBody = [&] (const char* end) {
+        std::string_view text(bodyStart, end - bodyStart);
+        if (body == Body::Table) {
+            std::istringstream tableText{std::string(text)};
+            auto& table = groups.back().table.emplace();
+            try {
+                tableFiles = table.getDataFromFile(tableText, mapper);
+            } catch (std::runtime_error &e) {
+                throw ParseError(
+                    fs::absolute(m_Path).string() + ", table for group " + groups.back().name +
+                    " starting at line " + std::to_string(bodyLine) + ", " + e.what()
+                );
+            }
+        } else if (body == Body::Script) {
+            if (escaped) {
+                auto& unescaped = m_Unescaped.emplace_back();
+                unescaped.reserve(text.size());
+                while (!text.empty()) {
+                    auto end = text.find('\n');
+                    auto line = text.substr(0, end == std::string_view::npos ? end : end + 1);
+                    text.remove_prefix(line.size());
+                    if (line.substr(0, 3) == "%%%") {
+                        line.remove_prefix(1);
+                    }
+                    unescaped.append(line);
+                }
+                text = unescaped;
+            }
+            scripts.back().text = text;
+        }
+        body = Body::None;
+        escaped = false;
+    };
+    // puts the scripts of the last group in the order a folder would have them.
+    auto finishGroup = [&] () {
+        if (groups.empty()) {
+            return;
+        }
+        auto& section = groups.back();
+        std::sort(scripts.begin(), scripts.end(), [] (const Script& lhs, const Script& rhs) {
+            return lhs.name < rhs.name;
+        });
+        auto find = [&scripts] (const std::string& name) {
+            auto it = std::lower_bound(scripts.begin(), scripts.end(), name, [] (const Script& script, const std::string& name) {
+                return script.name < name;
+            });
+            return it != scripts.end() && it->name == name ? it : scripts.end();
+        };
+        if (section.table) {
+            section.scripts.reserve(tableFiles.size());
+            for (auto& name: tableFiles) {
+                auto script = find(name);
+                if (script == scripts.end()) {
+                    throw ParseError(
+                        "In " + section.name + ": file " + name +
+                        " does not exist in " + fs::absolute(m_Path).string() + '.'
+                    );
+                }
+                section.scripts.push_back(*script);
+            }
+        } else {
+            section.scripts = std::move(scripts);
+        }
+        scripts.clear();
+        tableFiles.clear();
+    };
+
+    while (!rest.empty()) {
+        ++lineNumber;
+        const char* lineStart = rest.data();
+        auto newLine = rest.find('\n');
+        auto line = rest.substr(0, newLine);
+        rest.remove_prefix(newLine == std::string_view::npos ? rest.size() : newLine + 1);
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+
+        if (line.substr(0, 2) != "%%") {
+            if (body == Body::None && !util::Tokenizer(line).done()) {
+                throw error("Text found outside of a table or file.");
+            }
+            continue;
+        } else if (line.substr(0, 3) == "%%%") {
+            if (body != Body::Script) {
+                throw error("Text found outside of a file.");
+            }
+            escaped = true;
+            continue;
+        }
+
+        finishBody(lineStart);
+        util::Tokenizer tokens(line.substr(2));
+        auto directive = tokens.next();
+        auto name = std::string(tokens.rest());
+        while (!name.empty() && util::isSpace(name.back())) {
+            name.pop_back();
+        }
+        if (directive == "group") {
+            if (name.empty()) {
+                throw error("A group needs a name.");
+            }
+            finishGroup();
+            if (std::any_of(groups.begin(), groups.end(), [&name] (const Section& section) {
+                return section.name == name;
+            })) {
+                throw error("Group " + name + " is defined more than once.");
+            }
+            groups.push_back(Section{name, fs::absolute(m_Path), std::nullopt, {}});
+        } else if (directive == "table") {
+            if (groups.empty()) {
+                throw error("A table has to be in a group.");
+            } else if (groups.back().table) {
+                throw error("Group " + groups.back().name + " already has a table.");
+            }
+            body = Body::Table;
+        } else if (directive == "file") {
+            if (groups.empty()) {
+                throw error("A file has to be in a group.");
+            } else if (name.empty()) {
+                throw error("A file needs a name.");
+            } else if (std::any_of(scripts.begin(), scripts.end(), [&name] (const Script& script) {
+                return script.name == name;
+            })) {
+                throw error("File " + name + " is defined more than once in group " + groups.back().name + '.');
+            }
+            scripts.push_back(Script{name, {}});
+            body = Body::Script;
+        } else {
+            throw error("Unknown directive \"" + std::string(directive) + "\".");
+        }
+        bodyStart = rest.data();
+        bodyLine = lineNumber + 1;
+    }
+    finishBody(m_Mapping.data + m_Mapping.size);
+    finishGroup();
+}
+
+const std::optional<Table> &InputDirectory::Entry::table() const
+{
+    return folder != nullptr ? folder->table : section->table;
+}
+
+std::optional<Table> InputDirectory::Entry::takeTable()
+{
+    return std::exchange(folder != nullptr ? folder->table : section->table, std::nullopt);
+}
+
+InputDirectory::InputDirectory(const fs::path &directory, const util::Mapper &mapper)
+{
+    std::vector<fs::path> paths;
+    std::copy(fs::directory_iterator(directory), fs::directory_iterator(), std::back_inserter(paths));
+    std::sort(paths.begin(), paths.end());
+    for (auto& path: paths) {
+        if (fs::is_directory(path)) {
+            auto& folder = m_Folders.emplace_back(std::make_unique<Folder>(path, mapper));
+            m_Groups.push_back(Entry{folder->group.getName(), folder.get(), nullptr});
+        } else if (path.extension() == ".sable") {
+            auto& container = m_Containers.emplace_back(std::make_unique<Container>(path, mapper));
+            for (auto& section: container->groups) {
+                m_Groups.push_back(Entry{section.name, nullptr, &section});
+            }
+        }
+    }
+    // containers can put their groups anywhere among the folders.
+    std::stable_sort(m_Groups.begin(), m_Groups.end(), [] (const Entry& lhs, const Entry& rhs) {
+        return lhs.name < rhs.name;
+    });
+    for (std::size_t index = 1; index < m_Groups.size(); ++index) {
+        if (m_Groups[index].name == m_Groups[index - 1].name) {
+            throw ParseError("Group " + m_Groups[index].name + " is defined more than once in " + fs::absolute(directory).string() + '.');
+        }
+    }
+}
+
+auto InputDirectory::begin() const -> std::vector<Entry>::const_iterator
+{
+    return m_Groups.cbegin();
+}
+
+auto InputDirectory::end() const -> std::vector<Entry>::const_iterator
+{
+    return m_Groups.cend();
+}
+
+auto InputDirectory::begin() -> std::vector<Entry>::iterator
+{
+    return m_Groups.begin();
+}
+
+auto InputDirectory::end() -> std::vector<Entry>::iterator
+{
+    return m_Groups.end();
+}
+
+} // namespace files
+} // namespace sable
@@ -0,0 +1,116 @@
+#ifndef SABLE_FILES_CONTAINER_H
+#define SABLE_FILES_CONTAINER_H
+
+#include <deque>
+#include <istream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "data/table.h"
+#include "data/mapper.h"
+#include "project/folder.h"
+#include "wrapper/filesystem.h"
+
+namespace sable {
+
+namespace files {
+
+// A .sable file, which holds the scripts of any number of groups so a large
+// project doesn't need a file for each one. Lines starting with %% are directives:
+//   %%group name   starts a group, like a folder in the input directory.
+//   %%table        the lines up to the next directive are the group's table.txt.
+//   %%file name    the lines up to the next directive are the script called name.
+// A script line which really starts with %% is written with an extra % in front.
+//
+// The file is memory mapped, and scripts are read straight out of the mapping.
+class Container
+{
+public:
+    struct Script {
+        std::string name;
+        std::string_view text;
+    };
+    struct Section {
+        std::string name;
+        // the container the group is in.
+        fs::path path;
+        std::optional<Table> table;
+        // in table order if there is a table, otherwise sorted by name like a folder.
+        std::vector<Script> scripts;
+    };
+
+    Container(const fs::path& file, const util::Mapper& mapper);
+    Container(const Container&) = delete;
+    Container& operator=(const Container&) = delete;
+
+    const fs::path& getPath() const;
+    std::vector<Section> groups;
+private:
+    // the file's contents, which every script's text points into.
+    struct Mapping {
+        const char* data = nullptr;
+        std::size_t size = 0;
+#ifdef _WIN32
+        std::string contents;
+#endif
+        ~Mapping();
+    };
+    fs::path m_Path;
+    Mapping m_Mapping;
+    // scripts which had escaped lines, with the escapes taken out.
+    std::deque<std::string> m_Unescaped;
+
+    void map();
+    void parse(const util::Mapper& mapper);
+};
+
+// Reads a script out of its container without copying it.
+class ScriptStream : public std::istream
+{
+    struct Buffer : std::streambuf {
+        explicit Buffer(std::string_view text)
+        {
+            auto* start = const_cast<char*>(text.data());
+            setg(start, start, start + text.size());
+        }
+    } m_Buffer;
+public:
+    explicit ScriptStream(std::string_view text): std::istream(nullptr), m_Buffer(text)
+    {
+        rdbuf(&m_Buffer);
+    }
+};
+
+// Every group of a project's input directory, from its folders and .sable
+// containers, sorted by name.
+class InputDirectory
+{
+public:
+    struct Entry {
+        std::string name;
+        // one of these is set.
+        Folder* folder;
+        Container::Section* section;
+        const std::optional<Table>& table() const;
+        // moves the table out for parsing, leaving the group without one.
+        std::optional<Table> takeTable();
+    };
+    InputDirectory(const fs::path& directory, const util::Mapper& mapper);
+
+    std::vector<Entry>::const_iterator begin() const;
+    std::vector<Entry>::const_iterator end() const;
+    std::vector<Entry>::iterator begin();
+    std::vector<Entry>::iterator end();
+private:
+    std::vector<std::unique_ptr<Folder>> m_Folders;
+    std::vector<std::unique_ptr<Container>> m_Containers;
+    std::vector<Entry> m_Groups;
+};
+
+} // namespace files
+} // namespace sable
+
+#endif // SABLE_FILES_CONTAINER_H
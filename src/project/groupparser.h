@@ -5,9 +5,11 @@
 #include <fstream>
 #include <utility>
 #include <optional>
+#include <functional>
 
 #include "group.h"
 #include "folder.h"
+#include "container.h"
 #include "handler.h"
 
 namespace sable {
@@ -16,6 +18,9 @@ template<typename Hl = Handler>
 class GroupParser {
     Hl& handler;
 public:
+    // called for a file in a group's table which doesn't exist, instead of stopping with a ParseError.
+    std::function<void(const std::string& group, const fs::path& file)> onMissingFile;
+
     GroupParser(Hl& handler_): handler{handler_} {}
 
     auto processGroup(
@@ -28,6 +33,10 @@ public:
 
         for (auto file: group) {
             if (!fs::exists(file)) {
+                if (onMissingFile) {
+                    onMissingFile(group.getName(), file);
+                    continue;
+                }
                 throw ParseError(
                     "In " + group.getName()
                     + ": file " + file.string()
@@ -45,6 +54,40 @@ public:
 
         handler.setNextAddress(nextAddtess);
     }
+
+    // the same as processGroup, for a group in a .sable container.
+    auto processSection(
+        const files::Container::Section& section,
+        const util::Mapper& mapper,
+        const std::string& currentDir,
+        int dirIndex
+    ) {
+        int nextAddress = handler.getNextAddress(currentDir);
+
+        for (auto& script: section.scripts) {
+            files::ScriptStream input(script.text);
+
+            auto r = handler.processFile(input, mapper, currentDir, (section.path / script.name).string(), nextAddress, dirIndex);
+
+            dirIndex = r.dirIndex;
+            nextAddress = r.address;
+        }
+
+        handler.setNextAddress(nextAddress);
+    }
+
+    // parses a group from a project's input directory, starting from its table if it has one.
+    void processEntry(files::InputDirectory::Entry& group, const util::Mapper& mapper, int dirIndex = 0)
+    {
+        if (auto table = group.takeTable()) {
+            handler.addresses.addTable(group.name, std::move(*table));
+        }
+        if (group.folder != nullptr) {
+            processGroup(group.folder->group, mapper, group.name, dirIndex);
+        } else {
+            processSection(*group.section, mapper, group.name, dirIndex);
+        }
+    }
 };
 }
 
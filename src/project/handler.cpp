@@ -1,18 +1,15 @@
 #include "groupparser.h"
+#include "output/filewriter.h"
 
 namespace sable {
 
-void outputFile(const std::string &file, const std::vector<unsigned char>& data, size_t length, size_t start)
+bool outputFile(const fs::path &file, const std::vector<unsigned char>& data, size_t length, size_t start)
 {
-    std::ofstream output(
-        file,
-        std::ios::binary | std::ios::out
-    );
-    if (!output) {
-        throw ASMError("Could not open " + file + " for writing");
+    try {
+        return writeIfChanged(file, data.data() + start, length);
+    } catch (std::runtime_error &e) {
+        throw ASMError(std::string(e.what()) + " for writing");
     }
-    output.write(reinterpret_cast<const char*>(&data[start]), length);
-    output.close();
 }
 
 void Handler::report(std::string file, error::Levels l, std::string msg, int line)
@@ -45,7 +42,23 @@ void Handler::write(
 ) {
     addresses.addAddress({address, label, false});
     addresses.addFile(label, fileName, length, printpc, exportWidth, exportAddress);
-    outputFile((baseDir / fileName).string(), data, length, start);
+    if (outputFile(baseDir / fileName, data, length, start)) {
+        ++changedFiles;
+    }
+    outputs.insert(fs::path(fileName).generic_string());
+}
+
+void Handler::alias(
+        std::string label,
+        const std::string &target,
+        const std::vector<unsigned char> &data,
+        int address,
+        bool printpc,
+        options::ExportWidth exportWidth,
+        options::ExportAddress exportAddress
+) {
+    // no file is written, so the address is only exported as a label.
+    addresses.addAlias(label, address, {target, data.size(), exportWidth});
 }
 
 AddressList Handler::done()
@@ -54,14 +67,30 @@ AddressList Handler::done()
     return addresses;
 }
 
-int Handler::getNextAddress(const std::string & dir) const
+std::size_t Handler::removeStaleFiles()
 {
-    return addresses.getNextAddress(dir);
-}
-
-void Handler::setNextAddress(int nextAddress)
-{
-    addresses.setNextAddress(nextAddress);
+    if (!fs::exists(baseDir)) {
+        return 0;
+    }
+    std::vector<fs::path> stale, directories;
+    for (auto it = fs::recursive_directory_iterator(baseDir); it != fs::recursive_directory_iterator(); ++it) {
+        if (fs::is_directory(it->path())) {
+            directories.push_back(it->path());
+        } else if (outputs.find(fs::relative(it->path(), baseDir).generic_string()) == outputs.end()) {
+            stale.push_back(it->path());
+        }
+    }
+    for (auto& file: stale) {
+        fs::remove(file);
+    }
+    // deepest first, so a directory's children are gone before it's checked.
+    std::sort(directories.rbegin(), directories.rend());
+    for (auto& dir: directories) {
+        if (fs::is_empty(dir)) {
+            fs::remove(dir);
+        }
+    }
+    return stale.size();
 }
 
 }
@@ -1,6 +1,9 @@
 #ifndef HANDLER_H
 #define HANDLER_H
 
+#include <set>
+#include <string>
+
 #include "parse/parse.h"
 #include "data/addresslist.h"
 #include "data/options.h"
@@ -12,14 +15,36 @@
 
 namespace sable {
 
-struct Handler: sable::Parser<Handler>
+// A parser which places its blocks with an AddressList, which is everything
+// GroupParser needs from the parser it drives.
+template<class Derived>
+struct AddressedParser: Parser<Derived>
 {
     AddressList addresses;
+
+    using Parser<Derived>::Parser;
+
+    int getNextAddress(const std::string & dir) const
+    {
+        return addresses.getNextAddress(dir);
+    }
+
+    void setNextAddress(int nextAddress)
+    {
+        addresses.setNextAddress(nextAddress);
+    }
+};
+
+struct Handler: AddressedParser<Handler>
+{
     fs::path baseDir;
     std::ostream& output;
+    // files written (or already up to date) during this run, relative to baseDir.
+    std::set<std::string> outputs;
+    std::size_t changedFiles = 0;
 
     template<typename ...Args>
-    Handler(fs::path dir_, std::ostream& out, Args&& ...args): baseDir{dir_}, output{out}, sable::Parser<Handler>(std::forward<Args>(args)...) {
+    Handler(fs::path dir_, std::ostream& out, Args&& ...args): AddressedParser<Handler>(std::forward<Args>(args)...), baseDir{dir_}, output{out} {
 
     }
     void report(
@@ -41,10 +66,20 @@ struct Handler: sable::Parser<Handler>
         options::ExportAddress exportAddress
     );
 
+    void alias(
+        std::string label,
+        const std::string& target,
+        const std::vector<unsigned char>& data,
+        int address,
+        bool printpc,
+        options::ExportWidth exportWidth,
+        options::ExportAddress exportAddress
+    );
 
     AddressList done();
-    int getNextAddress(const std::string & dir) const;
-    void setNextAddress(int nextAddress);
+    // deletes every file under baseDir which wasn't written during this run.
+    // Returns the number of files deleted.
+    std::size_t removeStaleFiles();
 };
 
 }
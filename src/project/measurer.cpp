@@ -0,0 +1,138 @@
+#include "measurer.h"
+
+#include "font/error.h"
+#include "project/exceptions.h"
+
+namespace sable {
+
+void BlockCollector::report(std::string file, error::Levels l, std::string msg, int line)
+{
+    if (l == error::Levels::Error) {
+        throw ParseError("Error in text file " + file + ", line " + std::to_string(line) + ": " + msg);
+    }
+}
+
+void BlockCollector::write(
+    std::string,
+    std::string,
+    const std::vector<unsigned char>& data,
+    int,
+    size_t start,
+    size_t,
+    bool,
+    options::ExportWidth,
+    options::ExportAddress
+) {
+    // blocks split across banks are written twice, but only need to be kept once.
+    if (start == 0) {
+        blocks.push_back(data);
+    }
+}
+
+void Measurer::report(std::string file, error::Levels l, std::string msg, int line)
+{
+    if (l == error::Levels::Error) {
+        throw ParseError("Error in text file " + file + ", line " + std::to_string(line) + ": " + msg);
+    }
+    warnings.push_back(Warning{file, msg, line});
+}
+
+void Measurer::measure(int blockWidth)
+{
+    width = blockWidth;
+}
+
+void Measurer::write(
+    std::string,
+    std::string label,
+    const std::vector<unsigned char>& data,
+    int address,
+    size_t start,
+    size_t length,
+    bool,
+    options::ExportWidth,
+    options::ExportAddress
+) {
+    // blocks split across banks are written once for each bank, but only measured once.
+    // The piece in the next bank is written first.
+    int end = address + static_cast<int>(length) - 1;
+    if (start != 0) {
+        splitEnd = end;
+        return;
+    }
+    blocks.push_back(Block{group, label, address, data.size(), width, "", length < data.size() ? splitEnd : end});
+}
+
+void Measurer::alias(
+    std::string label,
+    const std::string& target,
+    const std::vector<unsigned char>&,
+    int address,
+    bool,
+    options::ExportWidth,
+    options::ExportAddress
+) {
+    blocks.push_back(Block{group, label, address, 0, width, target, address});
+}
+
+parse::FileResult Measurer::processFile(
+    std::istream& input,
+    const util::Mapper& mapper,
+    const std::string& currentDir,
+    const std::string& fileKey,
+    int nextAddress,
+    int startingDirIndex
+) {
+    group = currentDir;
+    return AddressedParser<Measurer>::processFile(input, mapper, currentDir, fileKey, nextAddress, startingDirIndex);
+}
+
+void Checker::report(std::string file, error::Levels l, std::string msg, int line)
+{
+    diagnostics.push_back(Diagnostic{file, line, l, msg});
+}
+
+void Checker::write(
+    std::string,
+    std::string label,
+    const std::vector<unsigned char>&,
+    int address,
+    size_t,
+    size_t length,
+    bool,
+    options::ExportWidth,
+    options::ExportAddress
+) {
+    ranges.push_back(Range{label, file, address, length});
+}
+
+void Checker::alias(
+    std::string,
+    const std::string&,
+    const std::vector<unsigned char>&,
+    int,
+    bool,
+    options::ExportWidth,
+    options::ExportAddress
+) {
+}
+
+parse::FileResult Checker::processFile(
+    std::istream& input,
+    const util::Mapper& mapper,
+    const std::string& currentDir,
+    const std::string& fileKey,
+    int nextAddress,
+    int startingDirIndex
+) {
+    file = fileKey;
+    // a font error stops the file it's in, but the rest of its group is still checked.
+    try {
+        return AddressedParser<Checker>::processFile(input, mapper, currentDir, fileKey, nextAddress, startingDirIndex);
+    } catch (FontError &e) {
+        report(fileKey, error::Levels::Error, e.what(), 0);
+        return parse::FileResult{startingDirIndex, nextAddress};
+    }
+}
+
+}
@@ -0,0 +1,151 @@
+#ifndef MEASURER_H
+#define MEASURER_H
+
+#include <string>
+#include <vector>
+
+#include "project/handler.h"
+
+namespace sable {
+
+// parses the script like Handler, but keeps the encoded blocks in memory.
+struct BlockCollector: AddressedParser<BlockCollector>
+{
+    std::vector<std::vector<unsigned char>> blocks;
+
+    using AddressedParser<BlockCollector>::AddressedParser;
+
+    void report(std::string file, error::Levels l, std::string msg, int line);
+
+    void write(
+        std::string,
+        std::string,
+        const std::vector<unsigned char>& data,
+        int,
+        size_t start,
+        size_t,
+        bool,
+        options::ExportWidth,
+        options::ExportAddress
+    );
+};
+
+// parses the script like Handler, but only keeps each block's size and width.
+struct Measurer: AddressedParser<Measurer>
+{
+    struct Block {
+        std::string group, label;
+        int address;
+        std::size_t size;
+        int width;
+        // the block whose data an alias points to.
+        std::string target;
+        // the last address the block uses, which is in a later bank if it was split.
+        int end;
+    };
+    struct Warning {
+        std::string file, message;
+        int line;
+    };
+    std::string group;
+    std::vector<Block> blocks;
+    std::vector<Warning> warnings;
+    int width = 0;
+    int splitEnd = 0;
+
+    using AddressedParser<Measurer>::AddressedParser;
+
+    void report(std::string file, error::Levels l, std::string msg, int line);
+
+    void measure(int blockWidth);
+
+    void write(
+        std::string,
+        std::string label,
+        const std::vector<unsigned char>& data,
+        int address,
+        size_t start,
+        size_t length,
+        bool,
+        options::ExportWidth,
+        options::ExportAddress
+    );
+
+    void alias(
+        std::string label,
+        const std::string& target,
+        const std::vector<unsigned char>&,
+        int address,
+        bool,
+        options::ExportWidth,
+        options::ExportAddress
+    );
+
+    parse::FileResult processFile(
+        std::istream& input,
+        const util::Mapper& mapper,
+        const std::string& currentDir,
+        const std::string& fileKey,
+        int nextAddress,
+        int startingDirIndex
+    );
+};
+
+// parses the script like Handler, but keeps every problem instead of stopping at the first error.
+struct Checker: AddressedParser<Checker>
+{
+    struct Diagnostic {
+        std::string file;
+        int line;
+        error::Levels level;
+        std::string message;
+    };
+    struct Range {
+        std::string label, file;
+        int address;
+        std::size_t length;
+    };
+    std::vector<Diagnostic> diagnostics;
+    std::vector<Range> ranges;
+    std::string file;
+
+    using AddressedParser<Checker>::AddressedParser;
+
+    void report(std::string file, error::Levels l, std::string msg, int line);
+
+    void write(
+        std::string,
+        std::string label,
+        const std::vector<unsigned char>&,
+        int address,
+        size_t,
+        size_t length,
+        bool,
+        options::ExportWidth,
+        options::ExportAddress
+    );
+
+    // a deduplicated block reuses data which was already checked where it was first written.
+    void alias(
+        std::string,
+        const std::string&,
+        const std::vector<unsigned char>&,
+        int,
+        bool,
+        options::ExportWidth,
+        options::ExportAddress
+    );
+
+    parse::FileResult processFile(
+        std::istream& input,
+        const util::Mapper& mapper,
+        const std::string& currentDir,
+        const std::string& fileKey,
+        int nextAddress,
+        int startingDirIndex
+    );
+};
+
+}
+
+#endif // MEASURER_H
@@ -3,7 +3,15 @@
 #include <algorithm>
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <set>
+#include <chrono>
 #include <cmath>
+#include <utility>
+#include <exception>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
 #include <yaml-cpp/yaml.h>
 
 #include "project/builder.h"
@@ -11,15 +19,23 @@
 #include "project/groupparser.h"
 
 #include "output/rompatcher.h"
+#include "output/patchcache.h"
 #include "exceptions.h"
 #include "data/addresslist.h"
 #include "data/optionhelpers.h"
+#include "data/tokenizer.h"
 #include "data/missing_data.h"
-#include "font/builder.h"
+#include "data/textblockrange.h"
+#include "parse/dictionary.h"
+#include "parse/textdumper.h"
+#include "parse/editorserver.h"
 
 #include "wrapper/filesystem.h"
 #include "project/helpers.h"
 #include "project/folder.h"
+#include "project/container.h"
+#include "project/measurer.h"
+#include "project/runs.h"
 
 namespace sable {
 
@@ -32,36 +48,27 @@ Project Project::from(const std::string &projectDir)
 
     auto self = ProjectSerializer::read(YAML::LoadFile(configPath), projectDir);
 
+    // fonts are only built once something uses them.
+    self.fl = FontList(self.m_LocaleString);
     for (auto &path: self.m_MappingPaths) {
-        auto inFile = YAML::LoadFile(path);
-        for (auto fontIt = inFile.begin(); fontIt != inFile.end(); ++fontIt) {
-            self.fl[fontIt->first.Scalar()] =
-                FontBuilder::make(
-                    fontIt->second,
-                    fontIt->first.Scalar(),
-                    self.m_LocaleString
-                );
+        if (fs::path(path).extension() == ".tbl") {
+            std::ifstream table(path, std::ios::binary);
+            if (!table) {
+                throw ConfigError(path + " could not be opened.");
+            }
+            self.fl.loadTable(table, fs::path(path).stem().string());
+        } else {
+            self.fl.load(YAML::LoadFile(path));
         }
     }
     return self;
 }
 
-bool Project::parseText()
+bool Project::parseText(std::shared_ptr<ParseStats> stats)
 {
     fs::path mainDir(m_MainDir);
-    {
-        if (!fs::exists(mainDir / m_OutputDir / m_BinsDir)) {
-            if (!fs::exists(mainDir / m_OutputDir)) {
-                fs::create_directory(mainDir / m_OutputDir);
-            }
-            if (!fs::exists(mainDir / m_OutputDir / m_BinsDir)) {
-                fs::create_directory(mainDir / m_OutputDir / m_BinsDir);
-            }
-        } else {
-            fs::remove_all(mainDir / m_OutputDir / m_BinsDir / m_TextOutDir);
-        }
-        fs::create_directory(mainDir / m_OutputDir / m_BinsDir / m_TextOutDir);
-    }
+    // existing block files are kept, so the ones which don't change keep their timestamps.
+    fs::create_directories(mainDir / m_OutputDir / m_BinsDir / m_TextOutDir);
 
     auto baseDir = mainDir / m_OutputDir / m_BinsDir / m_TextOutDir;
     Handler handler(
@@ -73,31 +80,22 @@ bool Project::parseText()
         options::ExportWidth::Off,
         exportAllAddresses
     );
+    handler.setDeduplication(deduplicateBlocks);
+    handler.setTokenCache(m_Tokens);
+    handler.setStats(std::move(stats));
     GroupParser gp{handler};
 
     {
-        fs::path input = fs::path(m_MainDir) / m_InputDir;
-
-        std::vector<fs::path> dirs;
-        std::copy(fs::directory_iterator(input), fs::directory_iterator(), std::back_inserter(dirs));
-        std::sort(dirs.begin(), dirs.end());
-
-        for (auto& dir: dirs) {
-            if (!fs::is_directory(dir)) {
-                continue;
-            }
-
-            files::Folder f(dir, m_Mapper);
-            if (f.table) {
-                handler.addresses.addTable(f.group.getName(), f.releaseTable());
-            }
-
-            int dirIndex = 0;
-
-            gp.processGroup(f.group, m_Mapper, f.group.getName(), dirIndex);
+        files::InputDirectory input(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+        for (auto& group: input) {
+            gp.processEntry(group, m_Mapper);
         }
     }
     AddressList addresses = handler.done();
+    handler.removeStaleFiles();
+    if (options::isEnabled(deduplicateBlocks)) {
+        std::cout << "Deduplication saved " << handler.getDeduplicatedBytes() << " bytes.\n";
+    }
 
     {
         std::ofstream mainText((mainDir / m_OutputDir / "text.asm").string());
@@ -144,8 +142,28 @@ bool Project::parseText()
             throw ASMError("Could not open " + fontFilePath.string() + " for writing.\n");
         }
         r.writeIncludes(m_FontIncludes.begin(), m_FontIncludes.end(), output);
-        r.writeFontData(handler.getFonts(), output);
+        handler.getFonts().buildFontData();
+        r.writeFontData(
+            handler.getFonts(),
+            output,
+            options::isEnabled(binaryFontWidths) ? fontFilePath.parent_path() : fs::path()
+        );
         output.close();
+
+        std::set<compression::Codec> codecs;
+        for (auto& [name, font]: handler.getFonts()) {
+            if (font.getCompression() != compression::Codec::None) {
+                codecs.insert(font.getCompression());
+            }
+        }
+        for (auto codec: codecs) {
+            fs::path decompressorPath = mainDir / m_OutputDir / ("decompress_" + compression::getCodecName(codec) + ".asm");
+            std::ofstream decompressor(decompressorPath.string());
+            if (!decompressor) {
+                throw ASMError("Could not open " + decompressorPath.string() + " for writing.\n");
+            }
+            r.writeDecompressor(codec, decompressor);
+        }
     }
     maxAddress = (addresses.end()-1)->address;
     return true;
@@ -160,26 +178,45 @@ void Project::writePatchData()
         m_OutputSize = m_Mapper.calculateFileSize(maxAddress);
         changeSettings = true;
     }
+    auto cacheDir = mainDir / m_OutputDir / "cache";
+    PatchCache cache(cacheDir);
     for (Rom& romData: m_Roms) {
         RomPatcher r(m_BaseType);
         std::string patchFile = (mainDir / (romData.name + ".asm")).string();
 
         fs::path romFilePath = fs::path(m_RomsDir) / romData.file;
         std::string extension = romFilePath.extension().string();
-        if (!r.loadRom(romFilePath.string(), romData.name, romData.hasHeader)) {
+        if (!r.loadRom(romFilePath.string(), romData.name, romData.hasHeader, !romData.patches.empty())) {
             std::cerr << fs::absolute(romFilePath).string() + " does not exist, or could not be opened.\n";
         } else {
             if (changeSettings && r.getRealSize() >= m_OutputSize) {
                 changeSettings = false;
             }
             r.expand(m_OutputSize, m_Mapper);
-            auto result = [&r, &patchFile] () {
+            // the key has to be taken before patching, while the ROM is still the expanded base.
+            std::optional<std::string> cacheKey;
+            if (options::isEnabled(cacheAssembly)) {
+                cacheKey = PatchCache::key(r, patchFile);
+            }
+            bool cached = cacheKey && cache.load(romData.name, *cacheKey, r);
+            auto result = [&r, &patchFile, cached] () {
+                if (cached) {
+                    return RomPatcher::AsarState::Success;
+                }
                 try {
                     return r.applyPatchFile(patchFile);
                 } catch (std::runtime_error &e) {
                     throw ASMError(e.what());
                 }
             }();
+            if (cacheKey && !cached && RomPatcher::succeeded(result)) {
+                try {
+                    cache.store(romData.name, *cacheKey, r);
+                } catch (std::exception &e) {
+                    // the build still worked, it just has to be assembled again next time.
+                    std::cerr << "Could not cache the assembly for " << romData.name << ": " << e.what() << '\n';
+                }
+            }
 
 
             if (RomPatcher::succeeded(result)) {
@@ -187,25 +224,45 @@ void Project::writePatchData()
             } else if (!RomPatcher::wasRun(result)) {
                 throw ASMError("Asar was not initalized.");
             }
+            for (auto& message: r.getLog()) {
+                if (message.kind == AsarMessage::Kind::Warning) {
+                    std::cerr << romData.name << ": " << message.text << '\n';
+                }
+            }
             std::vector<std::string> messages;
             r.getMessages(std::back_inserter(messages));
             if (RomPatcher::succeeded(result)) {
                 for (auto& msg: messages) {
                     std::cout << msg << std::endl;
                 }
-                std::ofstream output(
-                    (fs::path(m_RomsDir) / (romData.name + extension)).string(),
-                    std::ios::out|std::ios::binary
-                );
-                output.write(reinterpret_cast<char*>(&r.at(0)), r.getRealSize());
-                output.close();
+                fs::path outputPath = fs::path(m_RomsDir) / romData.name;
+                try {
+                    // the record only goes in the cache folder when the assembly is cached there too.
+                    auto writtenRecord = options::isEnabled(cacheAssembly)
+                        ? cacheDir / (romData.name + ".written")
+                        : fs::path(outputPath.string() + ".written");
+                    r.writeRom(outputPath.string() + extension, writtenRecord);
+                    for (auto& format: romData.patches) {
+                        auto patchFormat = patch::parseFormat(format);
+                        std::ofstream patchOutput(
+                            outputPath.string() + patch::getExtension(patchFormat),
+                            std::ios::out|std::ios::binary
+                        );
+                        r.writePatch(patchFormat, patchOutput);
+                    }
+                } catch (std::runtime_error &e) {
+                    throw ASMError(e.what());
+                }
                 r.clear();
             } else {
+                std::ostringstream error;
+                if (messages.empty()) {
+                    error << "Assembly for " << romData.name << " failed.\n";
+                }
                 for (auto& msg: messages) {
-                    std::ostringstream error;
                     error << msg << '\n';
-                    throw ASMError(error.str());
                 }
+                throw ASMError(error.str());
             }
         }
     }
@@ -220,6 +277,500 @@ void Project::writePatchData()
     }
 }
 
+bool Project::checkFonts(std::ostream &out) const
+{
+    bool valid = true;
+    for (auto& name: fl.getNames()) {
+        try {
+            fl.at(name);
+        } catch (FontError &e) {
+            out << e.what() << '\n';
+            valid = false;
+        }
+    }
+    return valid;
+}
+
+void Project::serve(std::istream &in, std::ostream &out) const
+{
+    EditorServer server(FontList(fl), m_DefaultMode, m_LocaleString, m_Mapper);
+    server.run(in, out);
+}
+
+void Project::benchmarkCompression(std::ostream &out) const
+{
+    BlockCollector collector(
+        FontList(fl),
+        m_DefaultMode,
+        m_LocaleString,
+        options::ExportWidth::Off,
+        exportAllAddresses
+    );
+    collector.setCompression(options::CompressBlocks::Off);
+    collector.setTokenCache(m_Tokens);
+    GroupParser<BlockCollector> gp{collector};
+
+    files::InputDirectory input(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+    for (auto& group: input) {
+        gp.processEntry(group, m_Mapper);
+    }
+
+    using Clock = std::chrono::steady_clock;
+    auto toMs = [] (Clock::duration d) {
+        return std::chrono::duration<double, std::milli>(d).count();
+    };
+    out << std::left << std::setw(8) << "codec"
+        << std::right << std::setw(8) << "blocks"
+        << std::setw(12) << "raw bytes"
+        << std::setw(12) << "compressed"
+        << std::setw(8) << "ratio"
+        << std::setw(16) << "compress ms"
+        << std::setw(16) << "decompress ms" << '\n';
+    for (auto codec: {compression::Codec::None, compression::Codec::LZ}) {
+        std::size_t rawSize = 0, compressedSize = 0;
+        Clock::duration compressTime{0}, decompressTime{0};
+        for (auto& block: collector.blocks) {
+            auto start = Clock::now();
+            auto compressed = compression::compress(codec, block);
+            auto middle = Clock::now();
+            auto restored = compression::decompress(codec, compressed);
+            decompressTime += Clock::now() - middle;
+            compressTime += middle - start;
+            if (restored != block) {
+                throw std::logic_error(compression::getCodecName(codec) + " codec did not round-trip a block.");
+            }
+            rawSize += block.size();
+            compressedSize += compressed.size();
+        }
+        out << std::left << std::setw(8) << compression::getCodecName(codec)
+            << std::right << std::setw(8) << collector.blocks.size()
+            << std::setw(12) << rawSize
+            << std::setw(12) << compressedSize
+            << std::setw(7) << std::fixed << std::setprecision(1)
+            << (rawSize > 0 ? 100.0 * compressedSize / rawSize : 100.0) << '%'
+            << std::setw(16) << std::setprecision(3) << toMs(compressTime)
+            << std::setw(16) << toMs(decompressTime) << '\n';
+    }
+}
+
+bool Project::measureText(std::ostream &out) const
+{
+    files::InputDirectory input(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+    auto results = parseRuns<Measurer>(input, m_Mapper, deduplicateBlocks, [this] () {
+        // parsers keep state, so each run gets its own, along with its own copy of the fonts.
+        auto measurer = std::make_unique<Measurer>(
+            FontList(fl),
+            m_DefaultMode,
+            m_LocaleString,
+            options::ExportWidth::Off,
+            exportAllAddresses
+        );
+        measurer->setDeduplication(deduplicateBlocks);
+        measurer->setTokenCache(m_Tokens);
+        return measurer;
+    });
+
+    out << std::left << std::setw(32) << "label"
+        << std::setw(16) << "group"
+        << std::right << std::setw(10) << "address"
+        << std::setw(8) << "bytes"
+        << std::setw(8) << "width" << '\n';
+    std::vector<std::pair<std::string, std::pair<std::size_t, std::size_t>>> groupTotals;
+    int lastAddress = 0;
+    for (auto& result: results) {
+        for (auto& block: result->blocks) {
+            out << std::left << std::setw(32) << block.label
+                << std::setw(16) << block.group
+                << std::right << std::setw(4) << '$'
+                << std::hex << std::uppercase << std::setfill('0') << std::setw(6) << block.address
+                << std::dec << std::setfill(' ') << std::setw(8) << block.size
+                << std::setw(8) << block.width;
+            if (!block.target.empty()) {
+                out << "  (same data as " << block.target << ')';
+            }
+            out << '\n';
+            if (groupTotals.empty() || groupTotals.back().first != block.group) {
+                groupTotals.emplace_back(block.group, std::make_pair(0, 0));
+            }
+            groupTotals.back().second.first++;
+            groupTotals.back().second.second += block.size;
+            if (block.size > 0) {
+                lastAddress = std::max(lastAddress, block.end);
+            }
+        }
+        for (auto& address: result->addresses) {
+            if (address.isTable) {
+                auto& table = result->addresses.getTable(address.label);
+                lastAddress = std::max(lastAddress, table.getAddress() + std::max(table.getSize(), 1) - 1);
+            }
+        }
+    }
+
+    out << '\n' << std::left << std::setw(32) << "group"
+        << std::right << std::setw(8) << "blocks"
+        << std::setw(12) << "bytes" << '\n';
+    std::size_t totalSize = 0;
+    for (auto& [name, total]: groupTotals) {
+        out << std::left << std::setw(32) << name
+            << std::right << std::setw(8) << total.first
+            << std::setw(12) << total.second << '\n';
+        totalSize += total.second;
+    }
+    out << std::left << std::setw(32) << "total"
+        << std::right << std::setw(8) << ""
+        << std::setw(12) << totalSize << '\n';
+
+    std::size_t warningCount = 0;
+    for (auto& result: results) {
+        for (auto& warning: result->warnings) {
+            if (warningCount++ == 0) {
+                out << '\n';
+            }
+            out << "Warning in " << warning.file << " on line " << warning.line << ": " << warning.message << '\n';
+        }
+    }
+
+    if (groupTotals.empty()) {
+        out << "\nThere is no text to measure.\n";
+        return true;
+    }
+    auto romSize = m_Mapper.calculateFileSize(lastAddress);
+    out << "\nText ends at $" << std::hex << std::uppercase << lastAddress << std::dec
+        << ", which needs a ROM of " << romSize << " bytes";
+    if (m_OutputSize == 0) {
+        out << ".\n";
+        return true;
+    }
+    out << " out of the configured " << m_OutputSize << ".\n";
+    if (romSize > m_OutputSize) {
+        out << "The text does not fit in the configured output size.\n";
+        return false;
+    }
+    return true;
+}
+
+std::size_t Project::checkText(std::ostream &out) const
+{
+    using Diagnostic = Checker::Diagnostic;
+    std::vector<Diagnostic> diagnostics;
+    std::optional<files::InputDirectory> input;
+    try {
+        input.emplace(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+    } catch (ParseError &e) {
+        diagnostics.push_back(Diagnostic{m_InputDir, 0, error::Levels::Error, e.what()});
+    }
+
+    std::vector<std::unique_ptr<Checker>> results;
+    if (input) {
+        // checked with the same settings as a build, so it finds the same problems.
+        auto makeChecker = [this] () {
+            auto checker = std::make_unique<Checker>(
+                FontList(fl),
+                m_DefaultMode,
+                m_LocaleString,
+                options::ExportWidth::Off,
+                exportAllAddresses
+            );
+            checker->setDeduplication(deduplicateBlocks);
+            checker->setTokenCache(m_Tokens);
+            return checker;
+        };
+        // a missing file is reported, and the rest of its group is still checked.
+        auto reportMissingFiles = [] (GroupParser<Checker>& gp, Checker& checker) {
+            gp.onMissingFile = [&checker] (const std::string&, const fs::path& file) {
+                checker.report(fs::absolute(file).string(), error::Levels::Error, "The file does not exist, or could not be opened.", 0);
+            };
+        };
+        results = parseRuns<Checker>(*input, m_Mapper, deduplicateBlocks, makeChecker, reportMissingFiles);
+    }
+
+    // each run already checked its own blocks for collisions, but not the other runs'.
+    Blocks ranges;
+    std::unordered_map<std::string, std::size_t> runOfLabel;
+    for (std::size_t index = 0; index < results.size(); ++index) {
+        for (auto& range: results[index]->ranges) {
+            runOfLabel.emplace(range.label, index);
+            int start = m_Mapper.ToPC(range.address);
+            if (auto result = ranges.addBlock(start, start + range.length, range.label, range.file);
+                result != Blocks::Collision::None && runOfLabel[result->label] != index) {
+                diagnostics.push_back(Diagnostic{
+                    range.file,
+                    0,
+                    error::Levels::Warning,
+                    "block \"" + range.label + "\" collides with block \"" + result->label +
+                        "\" from file \"" + result->file + "\"."
+                });
+            }
+        }
+        std::move(results[index]->diagnostics.begin(), results[index]->diagnostics.end(), std::back_inserter(diagnostics));
+    }
+
+    std::stable_sort(diagnostics.begin(), diagnostics.end(), [] (const Diagnostic& lhs, const Diagnostic& rhs) {
+        return std::tie(lhs.file, lhs.line) < std::tie(rhs.file, rhs.line);
+    });
+    std::size_t errors = 0, warnings = 0;
+    for (auto& diagnostic: diagnostics) {
+        std::string where = diagnostic.file + (diagnostic.line > 0 ? ", line " + std::to_string(diagnostic.line) : "");
+        if (diagnostic.level == error::Levels::Error) {
+            out << "Error in " << where << ": " << diagnostic.message << '\n';
+            ++errors;
+        } else {
+            out << "Warning in " << where << ": " << diagnostic.message << '\n';
+            ++warnings;
+        }
+    }
+    out << errors << (errors == 1 ? " error, " : " errors, ") << warnings << (warnings == 1 ? " warning.\n" : " warnings.\n");
+    return errors;
+}
+
+void Project::optimizeDictionary(std::ostream &out, std::size_t maxEntries) const
+{
+    std::map<std::pair<std::string, int>, DictionaryOptimizer> optimizers;
+    auto getOptimizer = [this, &optimizers] (const std::string& mode, int page) -> DictionaryOptimizer& {
+        auto key = std::make_pair(mode, page);
+        if (auto it = optimizers.find(key); it != optimizers.end()) {
+            return it->second;
+        }
+        return optimizers.emplace(key, DictionaryOptimizer(fl.at(mode), page, m_LocaleString)).first->second;
+    };
+
+    auto addScript = [&] (std::istream& text) {
+        std::string mode = m_DefaultMode;
+        int page = 0;
+        for (std::string line; std::getline(text, line); ) {
+            getOptimizer(mode, page).addLine(line);
+
+            // only the settings which change the encoding matter here.
+            if (auto setting = line.find('@'); setting != std::string::npos) {
+                util::Tokenizer directive(std::string_view(line).substr(setting + 1));
+                auto name = directive.next();
+                auto option = directive.next();
+                if (name == "type") {
+                    if (option == "default") {
+                        mode = m_DefaultMode;
+                    } else if (fl.contains(std::string(option))) {
+                        mode = option;
+                    }
+                    // like TextParser, the page carries over if the new font has it. The
+                    // parser stops on a page the font doesn't have, so the lines after
+                    // are measured from its first page instead of the old font's page.
+                    if (page >= fl.at(mode).getNumberOfPages()) {
+                        page = 0;
+                    }
+                } else if (name == "page") {
+                    if (auto value = util::parseInt(option);
+                        value && *value >= 0 && *value < fl.at(mode).getNumberOfPages()) {
+                        page = *value;
+                    }
+                }
+            }
+        }
+    };
+    files::InputDirectory input(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+    for (auto& group: input) {
+        if (group.folder != nullptr) {
+            for (auto& file: group.folder->group) {
+                std::ifstream text(file.string());
+                addScript(text);
+            }
+        } else {
+            for (auto& script: group.section->scripts) {
+                files::ScriptStream text(script.text);
+                addScript(text);
+            }
+        }
+    }
+
+    // the suggestions are laid out like a font mapping, so they can be merged into one.
+    // Page 0's entries are in the font itself and the others are under Pages.
+    std::map<std::string, std::map<int, DictionaryOptimizer::Result>> results;
+    std::size_t totalSaved = 0;
+    for (auto& [key, optimizer]: optimizers) {
+        auto result = optimizer.optimize(maxEntries);
+        totalSaved += result.originalSize - result.optimizedSize;
+        results[key.first].emplace(key.second, std::move(result));
+    }
+
+    YAML::Emitter yaml(out);
+    auto writePage = [&yaml] (const DictionaryOptimizer::Result& result, const std::string& label) {
+        yaml << YAML::Comment(
+            label + ": " + std::to_string(result.originalSize) + " -> " +
+            std::to_string(result.optimizedSize) + " bytes"
+        );
+        for (bool nouns: {false, true}) {
+            if (std::none_of(result.entries.begin(), result.entries.end(), [nouns] (auto& e) {
+                    return e.isNoun == nouns;
+            })) {
+                continue;
+            }
+            yaml << YAML::Key << (nouns ? Font::NOUNS : Font::ENCODING) << YAML::Value << YAML::BeginMap;
+            for (auto& entry: result.entries) {
+                if (entry.isNoun != nouns) {
+                    continue;
+                }
+                yaml << YAML::Key << entry.text << YAML::Value << YAML::Flow << YAML::BeginMap;
+                yaml << YAML::Key << Font::CODE_VAL << YAML::Value << YAML::Hex;
+                if (nouns) {
+                    yaml << YAML::Flow << YAML::BeginSeq << entry.code << YAML::EndSeq;
+                } else {
+                    yaml << entry.code;
+                }
+                yaml << YAML::Dec << YAML::Key << Font::TEXT_LENGTH_VAL << YAML::Value << entry.width;
+                yaml << YAML::EndMap;
+            }
+            yaml << YAML::EndMap;
+        }
+    };
+    yaml << YAML::BeginMap;
+    for (auto& [mode, pages]: results) {
+        yaml << YAML::Key << mode << YAML::Value << YAML::BeginMap;
+        if (auto first = pages.find(0); first != pages.end()) {
+            writePage(first->second, mode + ", page 0");
+        }
+        if (int lastPage = pages.rbegin()->first; lastPage > 0) {
+            yaml << YAML::Key << Font::PAGES << YAML::Value << YAML::BeginSeq;
+            // pages without any script text are left empty so the ones after them keep their place.
+            for (int page = 1; page <= lastPage; ++page) {
+                yaml << YAML::BeginMap;
+                if (auto it = pages.find(page); it != pages.end()) {
+                    writePage(it->second, mode + ", page " + std::to_string(page));
+                }
+                yaml << YAML::EndMap;
+            }
+            yaml << YAML::EndSeq;
+        }
+        yaml << YAML::EndMap;
+    }
+    yaml << YAML::EndMap << YAML::Newline;
+    out << "\n# projected savings: " << totalSaved << " bytes\n";
+}
+
+std::size_t Project::dumpText(
+    const std::string &romFile,
+    const std::vector<int> &addresses,
+    std::ostream &out,
+    const std::string& mode
+) const
+{
+    std::string fontName = mode.empty() || mode == "default" ? m_DefaultMode : mode;
+    if (!fl.contains(fontName)) {
+        throw ConfigError("Font \"" + fontName + "\" was not defined");
+    }
+    RomPatcher rom(m_Mapper.getType());
+    if (!rom.loadRom(romFile, "")) {
+        throw ASMError(romFile + " does not exist.");
+    }
+    const unsigned char* romData = rom.getRomData();
+    int romSize = rom.getRomSize();
+
+    // blocks start with a label if they came from a table.
+    std::vector<std::pair<int, std::string>> blocks;
+    for (int address: addresses) {
+        blocks.emplace_back(address, "");
+    }
+    if (addresses.empty()) {
+        files::InputDirectory input(fs::path(m_MainDir) / m_InputDir, m_Mapper);
+        for (auto& group: input) {
+            if (!group.table() || group.table()->getAddress() <= 0) {
+                continue;
+            }
+            const Table& table = *group.table();
+            int entrySize = table.getAddressSize() * (table.getStoreWidths() ? 2 : 1);
+            int tablePC = m_Mapper.ToPC(table.getAddress());
+            for (auto& entry: table) {
+                if (tablePC < 0 || tablePC + table.getAddressSize() > romSize) {
+                    throw ASMError("Table " + group.name + " is outside of " + romFile);
+                }
+                int pointer = 0;
+                for (int index = table.getAddressSize() - 1; index >= 0; --index) {
+                    pointer = (pointer << 8) | romData[tablePC + index];
+                }
+                if (table.getAddressSize() < 3) {
+                    // short pointers are in the same bank as the table.
+                    pointer |= table.getAddress() & 0xFF0000;
+                }
+                blocks.emplace_back(pointer, entry.label);
+                tablePC += entrySize;
+            }
+        }
+    }
+
+    const Font& font = fl.at(fontName);
+    TextDumper dumper(font, m_LocaleString);
+    TextParser parser(
+        FontList(fl),
+        fontName,
+        m_LocaleString,
+        options::ExportWidth::Off,
+        options::ExportAddress::Off
+    );
+    auto encode = [this, &parser] (const std::string& text, int address) {
+        auto settings = parser.getDefaultSetting(address);
+        std::istringstream input(text);
+        std::vector<unsigned char> data;
+        auto metadata = TextParser::Metadata::No;
+        for (bool done = false; !done; ) {
+            auto result = parser.parseLine(input, settings, data, metadata, m_Mapper);
+            done = result.endOfBlock;
+            metadata = result.metadata;
+        }
+        return data;
+    };
+
+    std::size_t totalSize = 0;
+    std::string text;
+    std::vector<unsigned char> decompressed;
+    AsmWriter writer(out);
+    for (auto& [address, label]: blocks) {
+        writer.append("@address ").hex(address, 6).newLine();
+        if (fontName != m_DefaultMode) {
+            writer.append("@type ").append(fontName).newLine();
+        }
+        if (!label.empty()) {
+            writer.append("@label ").append(label).newLine();
+        }
+        int pc = m_Mapper.ToPC(address);
+        if (pc < 0 || pc >= romSize) {
+            writer.append("# the address is outside of the ROM.\n");
+            continue;
+        }
+        const unsigned char* data = romData + pc;
+        std::size_t size = std::min(romSize - pc, 0x10000);
+        if (font.getCompression() != compression::Codec::None) {
+            try {
+                decompressed = compression::decompress(font.getCompression(), std::vector<unsigned char>(data, data + size));
+            } catch (std::runtime_error& e) {
+                writer.append("# ").append(e.what()).newLine();
+                continue;
+            }
+            data = decompressed.data();
+            size = decompressed.size();
+        }
+
+        text.clear();
+        auto result = dumper.dump(data, size, text);
+        bool matches = result.exact || !result.ended;
+        if (result.ended && !result.exact) {
+            try {
+                auto encoded = encode(text, address);
+                matches = encoded.size() == result.length && std::equal(encoded.begin(), encoded.end(), data);
+            } catch (std::runtime_error&) {
+                matches = false;
+            }
+        }
+        if (!matches) {
+            text.clear();
+            dumper.dump(data, size, text, TextDumper::Style::Codes);
+        }
+        if (!result.ended) {
+            writer.append("# no end code was found.\n");
+        }
+        writer.append(text).newLine();
+        totalSize += result.length;
+    }
+    return totalSize;
+}
+
 Project::Project(util::Mapper&& mapper_): m_Mapper{mapper_}
 {
 
@@ -266,6 +817,21 @@ bool Project::areAddressesExported() const
     return options::isEnabled(exportAllAddresses);
 }
 
+bool Project::areBlocksDeduplicated() const
+{
+    return options::isEnabled(deduplicateBlocks);
+}
+
+bool Project::areFontWidthsBinary() const
+{
+    return options::isEnabled(binaryFontWidths);
+}
+
+bool Project::isAssemblyCached() const
+{
+    return options::isEnabled(cacheAssembly);
+}
+
 ConfigError::ConfigError(std::string message) : std::runtime_error(message) {}
 ASMError::ASMError(std::string message) : std::runtime_error(message) {}
 ParseError::ParseError(std::string message) : std::runtime_error(message) {}
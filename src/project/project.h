@@ -5,10 +5,15 @@
 #include <map>
 #include <string>
 #include <memory>
+#include <istream>
+#include <ostream>
 
 #include "data/options.h"
 #include "data/mapper.h"
 #include "font/font.h"
+#include "font/fontlist.h"
+#include "parse/tokenstream.h"
+#include "parse/parsestats.h"
 
 namespace sable {
 
@@ -21,9 +26,11 @@ class Project
         std::string file, name;
         int hasHeader;
         std::vector<std::string> includes;
+        // ips and/or bps, written next to the output ROM.
+        std::vector<std::string> patches;
     };
 
-    std::map<std::string, sable::Font> fl;
+    FontList fl;
     std::string m_MainDir, m_InputDir, m_OutputDir, m_BinsDir,
     m_TextOutDir, m_RomsDir, m_FontDir,
     m_DefaultMode, m_ConfigPath, m_LocaleString;
@@ -35,6 +42,11 @@ class Project
     util::Mapper m_Mapper;
     int maxAddress;
     options::ExportAddress exportAllAddresses;
+    options::Deduplicate deduplicateBlocks;
+    options::BinaryWidths binaryFontWidths;
+    options::CacheAssembly cacheAssembly;
+    // scripts only need to be lexed once, however many times they're built.
+    std::shared_ptr<TokenCache> m_Tokens = std::make_shared<TokenCache>();
 
     Project(util::Mapper&& mapper);
 public:
@@ -59,10 +71,38 @@ public:
     static constexpr const char* OUT_SIZE = "outputSize";
     static constexpr const char* LOCALE = "locale";
     static constexpr const char* EXPORT_ALL_ADDRESSES = "exportAllAddresses";
+    static constexpr const char* DEDUPLICATE_BLOCKS = "deduplicateBlocks";
+    static constexpr const char* BINARY_FONT_WIDTHS = "binaryFontWidths";
+    static constexpr const char* CACHE_ASSEMBLY = "cacheAssembly";
 
     static Project from(const std::string &projectDir);
-    bool parseText();
+    // counts what is encoded into stats if it is given.
+    bool parseText(std::shared_ptr<ParseStats> stats = nullptr);
     void writePatchData();
+    // Fonts are normally only built when the script uses them, so this builds all of them
+    // and writes an error for each bad one. Returns true if every font was valid.
+    bool checkFonts(std::ostream& out) const;
+    // Answers JSON-RPC requests from editor plugins until input ends. See EditorServer.
+    void serve(std::istream& in, std::ostream& out) const;
+    void benchmarkCompression(std::ostream& out) const;
+    // Encodes the script without writing anything, and prints the size and width of each
+    // block, each group's total, any warnings and the size of ROM the text needs.
+    // Returns false if the text doesn't fit in the configured output size.
+    bool measureText(std::ostream& out) const;
+    // Parses the script without writing anything, and prints every error and warning
+    // sorted by file and line instead of stopping at the first error.
+    // Returns the number of errors.
+    std::size_t checkText(std::ostream& out) const;
+    void optimizeDictionary(std::ostream& out, std::size_t maxEntries = 0) const;
+    // Writes the text at each address back out as a script, or the text of every
+    // table with a fixed address if no addresses are given.
+    // Returns the number of encoded bytes which were read.
+    std::size_t dumpText(
+        const std::string& romFile,
+        const std::vector<int>& addresses,
+        std::ostream& out,
+        const std::string& mode = ""
+    ) const;
     std::string MainDir() const;
     std::string RomsDir() const;
     std::string FontConfig() const;
@@ -71,6 +111,9 @@ public:
     explicit operator bool() const;
     util::Mapper getMapper() const;
     bool areAddressesExported() const;
+    bool areBlocksDeduplicated() const;
+    bool areFontWidthsBinary() const;
+    bool isAssemblyCached() const;
 };
 }
 
@@ -0,0 +1,19 @@
+#include "runs.h"
+
+#include "data/optionhelpers.h"
+
+namespace sable {
+
+std::vector<std::vector<files::InputDirectory::Entry*>> splitRuns(files::InputDirectory& input, options::Deduplicate deduplicate)
+{
+    std::vector<std::vector<files::InputDirectory::Entry*>> runs;
+    for (auto& group: input) {
+        if (runs.empty() || (group.table() && !options::isEnabled(deduplicate))) {
+            runs.emplace_back();
+        }
+        runs.back().push_back(&group);
+    }
+    return runs;
+}
+
+}
@@ -0,0 +1,91 @@
+#ifndef RUNS_H
+#define RUNS_H
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "project/container.h"
+#include "project/groupparser.h"
+#include "data/mapper.h"
+#include "data/options.h"
+
+namespace sable {
+
+// A group with a table starts at the table's address, and the groups without tables
+// after it follow on from it, so each run of groups like that can be parsed on its own.
+// Deduplicated blocks can share data with any earlier block, so then everything is one run.
+std::vector<std::vector<files::InputDirectory::Entry*>> splitRuns(files::InputDirectory& input, options::Deduplicate deduplicate);
+
+// calls work with every index below count on a pool of threads, then rethrows
+// the exception from the lowest index which failed, if any did.
+template<class Work>
+void runInParallel(std::size_t count, Work work)
+{
+    std::vector<std::exception_ptr> errors(count);
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] () {
+        for (auto index = next++; index < count; index = next++) {
+            try {
+                work(index);
+            } catch (...) {
+                errors[index] = std::current_exception();
+            }
+        }
+    };
+    std::vector<std::thread> threads;
+    auto threadCount = std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()), count);
+    for (std::size_t index = 1; index < threadCount; ++index) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto& thread: threads) {
+        thread.join();
+    }
+    for (auto& error: errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+// parses each run of groups with its own parser from makeParser, on its own thread.
+// setUp can change how the GroupParser for each parser handles its groups.
+template<class P, class MakeParser, class SetUp>
+std::vector<std::unique_ptr<P>> parseRuns(
+    files::InputDirectory& input,
+    const util::Mapper& mapper,
+    options::Deduplicate deduplicate,
+    MakeParser makeParser,
+    SetUp setUp
+) {
+    auto runs = splitRuns(input, deduplicate);
+    std::vector<std::unique_ptr<P>> results(runs.size());
+    runInParallel(runs.size(), [&] (std::size_t index) {
+        std::unique_ptr<P> parser = makeParser();
+        GroupParser<P> gp{*parser};
+        setUp(gp, *parser);
+        for (auto* group: runs[index]) {
+            gp.processEntry(*group, mapper);
+        }
+        results[index] = std::move(parser);
+    });
+    return results;
+}
+
+template<class P, class MakeParser>
+std::vector<std::unique_ptr<P>> parseRuns(
+    files::InputDirectory& input,
+    const util::Mapper& mapper,
+    options::Deduplicate deduplicate,
+    MakeParser makeParser
+) {
+    return parseRuns<P>(input, mapper, deduplicate, makeParser, [] (GroupParser<P>&, P&) {});
+}
+
+}
+
+#endif // RUNS_H
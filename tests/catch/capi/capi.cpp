@@ -0,0 +1,99 @@
+#include <catch2/catch.hpp>
+#include <thread>
+#include <vector>
+#include <string>
+
+#include "capi/sable.h"
+#include "helpers.h"
+
+namespace {
+    std::string sampleYaml()
+    {
+        YAML::Emitter out;
+        out << sable_tests::getSampleNode();
+        return out.c_str();
+    }
+}
+
+TEST_CASE("C interface", "[capi]")
+{
+    REQUIRE(sable_api_version() == SABLE_API_VERSION);
+    auto yaml = sampleYaml();
+    sable_fonts* fonts = sable_fonts_load_yaml(yaml.c_str(), sable_tests::defaultLocale);
+    REQUIRE(fonts != nullptr);
+
+    SECTION("Bad fonts and names are reported.")
+    {
+        REQUIRE(sable_fonts_load_yaml("normal: {ByteWidth: 3}", sable_tests::defaultLocale) == nullptr);
+        REQUIRE(std::string(sable_last_error()).find("normal") != std::string::npos);
+        REQUIRE(sable_fonts_load_file("missing.tbl", sable_tests::defaultLocale) == nullptr);
+        REQUIRE(std::string(sable_last_error()).find("missing.tbl could not be opened") == 0);
+        REQUIRE(sable_encoder_create(fonts, "missing", 0, 1) == nullptr);
+        REQUIRE(sable_encoder_create(fonts, "normal", 5, 1) == nullptr);
+    }
+    SECTION("Strings are encoded one after another.")
+    {
+        sable_encoder* encoder = sable_encoder_create(fonts, "normal", 0, 1);
+        REQUIRE(encoder != nullptr);
+        const char* strings[] = {"Test", "A\nB", "~", "[Test]"};
+        unsigned char output[64];
+        sable_result results[4];
+        REQUIRE(sable_encode(encoder, strings, 4, output, sizeof(output), results) == SABLE_ENCODING_ERROR);
+        REQUIRE(std::string(sable_last_error()).find("String 2") == 0);
+
+        REQUIRE(results[0].status == SABLE_OK);
+        REQUIRE(results[0].offset == 0);
+        REQUIRE(results[0].length == 6);
+        REQUIRE(results[0].width == 16);
+        REQUIRE(output[4] == 0);
+        REQUIRE(results[1].offset == 6);
+        REQUIRE(results[1].length == 6);
+        REQUIRE(output[8] == 1);
+        REQUIRE(results[2].status == SABLE_ENCODING_ERROR);
+        REQUIRE(results[3].offset == 12);
+        REQUIRE(results[3].status == SABLE_OK);
+        REQUIRE(output[12] == 0);
+        REQUIRE(output[13] == 7);
+
+        SECTION("Strings which don't fit are skipped.")
+        {
+            REQUIRE(sable_encode(encoder, strings, 2, output, 8, results) == SABLE_BUFFER_TOO_SMALL);
+            REQUIRE(results[0].status == SABLE_OK);
+            REQUIRE(results[1].status == SABLE_BUFFER_TOO_SMALL);
+            REQUIRE(results[1].length == 6);
+        }
+        sable_encoder_free(encoder);
+    }
+    SECTION("Encoders can be shared between threads.")
+    {
+        sable_encoder* encoder = sable_encoder_create(fonts, "menu", 0, 1);
+        sable_fonts_free(fonts);
+        fonts = nullptr;
+        std::vector<std::string> text(500);
+        for (std::size_t index = 0; index < text.size(); ++index) {
+            text[index] = "Line " + std::to_string(index);
+        }
+        std::vector<const char*> strings;
+        for (auto& line: text) {
+            strings.push_back(line.c_str());
+        }
+        std::vector<std::vector<unsigned char>> outputs(4, std::vector<unsigned char>(0x4000));
+        std::vector<std::vector<sable_result>> results(4, std::vector<sable_result>(strings.size()));
+        std::vector<sable_status> statuses(4);
+        std::vector<std::thread> threads;
+        for (int thread = 0; thread < 4; ++thread) {
+            threads.emplace_back([&, thread] () {
+                statuses[thread] = sable_encode(encoder, strings.data(), strings.size(), outputs[thread].data(), outputs[thread].size(), results[thread].data());
+            });
+        }
+        for (auto& thread: threads) {
+            thread.join();
+        }
+        for (int thread = 0; thread < 4; ++thread) {
+            REQUIRE(statuses[thread] == SABLE_OK);
+            REQUIRE(outputs[thread] == outputs[0]);
+        }
+        sable_encoder_free(encoder);
+    }
+    sable_fonts_free(fonts);
+}
@@ -6,13 +6,15 @@
 
 using sable::AddressList;
 
-bool operator==(const sable::AddressNode& lhs, const sable::AddressNode& rhs)
+namespace sable {
+bool operator==(const AddressNode& lhs, const AddressNode& rhs)
 {
     return  lhs.address == rhs.address &&
             lhs.label == rhs.label &&
             lhs.isTable == rhs.isTable
     ;
 }
+}
 
 template<>
 struct Catch::StringMaker<sable::AddressNode>
@@ -25,13 +27,15 @@ struct Catch::StringMaker<sable::AddressNode>
 };
 
 
-bool operator==(const sable::TextNode& lhs, const sable::TextNode& rhs)
+namespace sable {
+bool operator==(const TextNode& lhs, const TextNode& rhs)
 {
     return  lhs.files == rhs.files &&
             lhs.printpc == rhs.printpc &&
             lhs.size == rhs.size
     ;
 }
+}
 
 template<>
 struct Catch::StringMaker<sable::TextNode>
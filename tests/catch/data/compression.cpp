@@ -0,0 +1,48 @@
+#include <catch2/catch.hpp>
+
+#include "data/compression.h"
+
+using sable::compression::Codec;
+using sable::compression::compress;
+using sable::compression::decompress;
+
+TEST_CASE("LZ compression", "[compression]")
+{
+    SECTION("Literal runs")
+    {
+        std::vector<unsigned char> data{1, 2, 3, 4};
+        auto result = compress(Codec::LZ, data);
+        REQUIRE(result == std::vector<unsigned char>{4, 0, 3, 1, 2, 3, 4});
+        REQUIRE(decompress(Codec::LZ, result) == data);
+    }
+    SECTION("Repeated data is copied")
+    {
+        std::vector<unsigned char> data{1, 2, 3, 1, 2, 3, 1, 2, 3, 1};
+        auto result = compress(Codec::LZ, data);
+        REQUIRE(result == std::vector<unsigned char>{10, 0, 2, 1, 2, 3, 0x84, 2});
+        REQUIRE(decompress(Codec::LZ, result) == data);
+    }
+    SECTION("Long and empty blocks round trip")
+    {
+        std::vector<unsigned char> data;
+        for (int i = 0; i < 1000; ++i) {
+            data.push_back((i * 7) % 13 + (i / 300));
+        }
+        REQUIRE(decompress(Codec::LZ, compress(Codec::LZ, data)) == data);
+        REQUIRE(compress(Codec::LZ, data).size() < data.size());
+        REQUIRE(decompress(Codec::LZ, compress(Codec::LZ, {})).empty());
+    }
+    SECTION("Malformed data")
+    {
+        REQUIRE_THROWS(decompress(Codec::LZ, {1}));
+        REQUIRE_THROWS(decompress(Codec::LZ, {4, 0, 3, 1}));
+        REQUIRE_THROWS(decompress(Codec::LZ, {4, 0, 0x81, 0}));
+    }
+    SECTION("Codec names")
+    {
+        REQUIRE(sable::compression::parseCodec("lz") == Codec::LZ);
+        REQUIRE(sable::compression::parseCodec("none") == Codec::None);
+        REQUIRE_THROWS(sable::compression::parseCodec("huffman"));
+        REQUIRE(compress(Codec::None, {1, 2}) == std::vector<unsigned char>{1, 2});
+    }
+}
@@ -1,6 +1,9 @@
 #include <catch2/catch.hpp>
 #include "data/mapper.h"
 
+#include <iterator>
+#include <vector>
+
 
 TEST_CASE("Rom mapper class - ToRom")
 {
@@ -270,6 +273,17 @@ TEST_CASE("String to hex conversion")
     REQUIRE(strToHex("$FF") == std::make_pair<unsigned int, int>(255, 1));
     REQUIRE(strToHex("XYV") == std::make_pair<unsigned int, int>(0, -1));
     REQUIRE_THROWS(strToHex("$1000000"));
+    REQUIRE(strToHex("$") == std::make_pair<unsigned int, int>(0, -1));
+    REQUIRE(strToHex("") == std::make_pair<unsigned int, int>(0, -1));
+    // the same values a hex stream read accepted.
+    REQUIRE(strToHex("0x808000") == std::make_pair<unsigned int, int>(0x808000, 4));
+    REQUIRE(strToHex("+80") == std::make_pair<unsigned int, int>(0x80, 2));
+    REQUIRE(strToHex("-5") == std::make_pair<unsigned int, int>(static_cast<unsigned int>(-5), 1));
+    REQUIRE(strToHex("0x") == std::make_pair<unsigned int, int>(0, -1));
+    REQUIRE(strToHex("-") == std::make_pair<unsigned int, int>(0, -1));
+    REQUIRE(strToHex("12G") == std::make_pair<unsigned int, int>(0, -1));
+    REQUIRE(strToHex("c08000") == std::make_pair<unsigned int, int>(0xC08000, 3));
+    REQUIRE_THROWS(strToHex("FFFFFFFFFFFF"));
 }
 
 TEST_CASE("Mapper file size")
@@ -294,3 +308,55 @@ TEST_CASE("Mapper file size")
         REQUIRE(m.calculateFileSize(m.ToRom(0x600000)) == 0x7F0000);
     }
 }
+
+TEST_CASE("Batch address conversion")
+{
+    using sable::util::Mapper;
+    using sable::util::MapperType;
+    Mapper m(MapperType::LOROM, false, true, 0x400000);
+    // each PC address converts to the ROM address at the same index, and back.
+    std::vector<int> pc, rom;
+    SECTION("LoROM")
+    {
+        pc = {0, 0x8000, 0x380000, 0x37FFFF, 0x3FFFFF, -1};
+        rom = {0x808000, 0x818000, 0xF08000, 0xEFFFFF, 0xFFFFFF, -1};
+    }
+    SECTION("LoROM - header")
+    {
+        m = Mapper(MapperType::LOROM, true, true, 0x400000);
+        pc = {0x200, 0x8200, 0x380200, 0x3801FF, 0x4001FF, -1};
+        rom = {0x808000, 0x818000, 0xF08000, 0xEFFFFF, 0xFFFFFF, -1};
+    }
+    SECTION("HiROM")
+    {
+        m = Mapper(MapperType::HIROM, false, true, 0x400000);
+        pc = {0, 0x8000, 0x18000, 0x2FFFFF, 0x3FFFFF, -1};
+        rom = {0xC00000, 0xC08000, 0xC18000, 0xEFFFFF, 0xFFFFFF, -1};
+    }
+    SECTION("HiROM - header")
+    {
+        m = Mapper(MapperType::HIROM, true, true, 0x400000);
+        pc = {0x200, 0x8200, 0x18200, 0x3801FF, 0x4001FF, -1};
+        rom = {0xC00000, 0xC08000, 0xC18000, 0xF7FFFF, 0xFFFFFF, -1};
+    }
+    REQUIRE(m);
+
+    std::vector<int> converted(pc.size());
+    REQUIRE(m.ToRom(pc.begin(), pc.end(), converted.begin()) == converted.end());
+    REQUIRE(converted == rom);
+    converted.clear();
+    m.ToPC(rom.begin(), rom.end(), std::back_inserter(converted));
+    REQUIRE(converted == pc);
+}
+
+TEST_CASE("Header changes update the mapper.")
+{
+    sable::util::Mapper m(sable::util::MapperType::LOROM, false, true, 0x400000);
+    REQUIRE(m.ToPC(0x808000) == 0);
+    REQUIRE(m.ToRom(0x8000) == 0x818000);
+    m.setIsHeadered(true);
+    REQUIRE(m.ToPC(0x808000) == 0x200);
+    REQUIRE(m.ToRom(0x8200) == 0x818000);
+    m.setIsHeadered(false);
+    REQUIRE(m.ToPC(0x808000) == 0);
+}
@@ -0,0 +1,34 @@
+#include <catch2/catch.hpp>
+#include "data/tokenizer.h"
+
+TEST_CASE("Tokenizer splits on whitespace")
+{
+    using sable::util::Tokenizer;
+    std::string line = "  entry const\t$12, 8  \r";
+    Tokenizer tokens(line);
+    REQUIRE_FALSE(tokens.done());
+    REQUIRE(tokens.next() == "entry");
+    REQUIRE(tokens.rest() == "const\t$12, 8  \r");
+    REQUIRE(tokens.next() == "const");
+    REQUIRE(tokens.next() == "$12,");
+    REQUIRE(tokens.next() == "8");
+    REQUIRE(tokens.done());
+    REQUIRE(tokens.next().empty());
+    REQUIRE(tokens.next().empty());
+
+    Tokenizer empty("");
+    REQUIRE(empty.done());
+    REQUIRE(empty.next().empty());
+}
+
+TEST_CASE("Integer parsing")
+{
+    using sable::util::parseInt;
+    REQUIRE(parseInt("12") == 12);
+    REQUIRE(parseInt("-3") == -3);
+    REQUIRE(parseInt("ff", 16) == 255);
+    REQUIRE_FALSE(parseInt(""));
+    REQUIRE_FALSE(parseInt("12a"));
+    REQUIRE_FALSE(parseInt(" 12"));
+    REQUIRE_FALSE(parseInt("99999999999"));
+}
@@ -0,0 +1,215 @@
+#include <catch2/catch.hpp>
+
+#include <sstream>
+#include <yaml-cpp/yaml.h>
+
+#include "font/compiledfont.h"
+#include "font/fontcodegen.h"
+#include "font/fontlist.h"
+#include "parse/textparser.h"
+#include "helpers.h"
+
+namespace sable::generated {
+    // compiled from getCompiledSampleNode when the tests are built.
+    extern const CompiledFonts sampleFonts;
+}
+
+namespace {
+    sable::FontList loadYaml()
+    {
+        sable::FontList fonts(sable_tests::defaultLocale);
+        fonts.load(sable_tests::getCompiledSampleNode());
+        return fonts;
+    }
+
+    sable::FontList loadCompiled()
+    {
+        sable::FontList fonts(sable_tests::defaultLocale);
+        for (auto& font: sable::generated::sampleFonts) {
+            fonts.load(font);
+        }
+        return fonts;
+    }
+
+    sable::TextParser makeParser(sable::FontList&& fonts)
+    {
+        using sable::options::ExportAddress, sable::options::ExportWidth;
+        return sable::TextParser(std::move(fonts), "paged", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    }
+
+    // the encoded text and the width of every line.
+    std::pair<std::vector<unsigned char>, std::vector<int>> encode(sable::FontList&& fonts, const std::string& text)
+    {
+        auto parser = makeParser(std::move(fonts));
+        sable::util::Mapper mapper(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+        std::istringstream input(text);
+        auto settings = parser.getDefaultSetting(0x808000);
+        std::vector<unsigned char> data;
+        std::vector<int> widths;
+        auto metadata = sable::TextParser::Metadata::No;
+        bool keepReading = false;
+        while (input || keepReading) {
+            auto result = parser.parseLine(input, settings, std::back_inserter(data), metadata, mapper);
+            metadata = result.metadata;
+            widths.push_back(result.length);
+            keepReading = !result.endOfBlock && (!data.empty() || metadata == sable::TextParser::Metadata::Yes);
+        }
+        return {data, widths};
+    }
+
+    std::string encodingError(sable::FontList&& fonts, const std::string& text)
+    {
+        try {
+            encode(std::move(fonts), text);
+        } catch (std::exception &e) {
+            return e.what();
+        }
+        return "";
+    }
+}
+
+TEST_CASE("Compiled fonts match their mapping", "[compiled]")
+{
+    auto yaml = loadYaml();
+    auto compiled = loadCompiled();
+    REQUIRE(sable::generated::sampleFonts.count == 4);
+
+    for (auto name: {"menu", "nodigraph", "normal", "paged"}) {
+        INFO(name);
+        REQUIRE(compiled.isBuilt(name));
+        auto& expected = yaml.at(name);
+        auto& font = compiled.at(name);
+        REQUIRE(static_cast<bool>(font));
+        REQUIRE(font.getByteWidth() == expected.getByteWidth());
+        REQUIRE(font.getCommandValue() == expected.getCommandValue());
+        REQUIRE(font.getMaxWidth() == expected.getMaxWidth());
+        REQUIRE(font.getHasDigraphs() == expected.getHasDigraphs());
+        REQUIRE(font.getCompression() == expected.getCompression());
+        REQUIRE(font.getFontWidthLocation() == expected.getFontWidthLocation());
+        REQUIRE(font.getEndValue() == expected.getEndValue());
+        REQUIRE(font.getNumberOfPages() == expected.getNumberOfPages());
+        for (int page = 0; page < font.getNumberOfPages(); ++page) {
+            REQUIRE(font.getMaxEncodedValue(page) == expected.getMaxEncodedValue(page));
+            REQUIRE(font.getPage(page).getGlyphs().equals(expected.getPage(page).getGlyphs(), [] (auto& lhs, auto& rhs) {
+                return lhs.code == rhs.code && lhs.width == rhs.width;
+            }));
+            REQUIRE(font.getPage(page).getNouns().size() == expected.getPage(page).getNouns().size());
+            for (auto& [id, noun]: expected.getPage(page).getNouns()) {
+                REQUIRE(font.getPage(page).getNouns().at(id).codes == noun.codes);
+                REQUIRE(font.getPage(page).getNouns().at(id).width == noun.width);
+            }
+            std::vector<int> widths, expectedWidths;
+            font.getFontWidths(page, std::back_inserter(widths));
+            expected.getFontWidths(page, std::back_inserter(expectedWidths));
+            REQUIRE(widths == expectedWidths);
+        }
+        REQUIRE(font.getCommands().size() == expected.getCommands().size());
+        for (auto& [id, command]: expected.getCommands()) {
+            REQUIRE(font.getCommandData(id).code == command.code);
+            REQUIRE(font.getCommandData(id).page == command.page);
+            REQUIRE(font.getCommandData(id).isNewLine == command.isNewLine);
+        }
+        REQUIRE(font.getExtras() == expected.getExtras());
+    }
+
+    SECTION("Only fonts loaded from tables are encoded from them.")
+    {
+        REQUIRE(compiled.getCompiled("paged") == &sable::generated::sampleFonts.fonts[3]);
+        REQUIRE(yaml.getCompiled("paged") == nullptr);
+        compiled.load(sable_tests::getCompiledSampleNode());
+        REQUIRE(compiled.getCompiled("paged") == nullptr);
+    }
+    SECTION("Scripts encode the same way.")
+    {
+        std::string script =
+            "the A Sable\n"
+            "[Extra1][Ö]\"[special]\n"
+            "❤ マルス[End]\n"
+            "[Page1]Aあ[Page0]ABC[End]\n"
+            "Hello, la? We? ball[la][e?]e\n"
+            "@type nodigraph\n"
+            "Hello, la? We?[End]\n";
+        auto expected = encode(loadYaml(), script);
+        REQUIRE(encode(loadCompiled(), script) == expected);
+        REQUIRE(std::count(expected.second.begin(), expected.second.end(), 0) < 3);
+    }
+    SECTION("Text the tables don't have is reported the same way.")
+    {
+        for (auto script: {"Hello~\n", "[Nothing]\n", "[Page1]Ab\n"}) {
+            INFO(script);
+            auto expected = encodingError(loadYaml(), script);
+            REQUIRE_FALSE(expected.empty());
+            REQUIRE(encodingError(loadCompiled(), script) == expected);
+        }
+    }
+    SECTION("Looking up compiled entries.")
+    {
+        auto& paged = sable::generated::sampleFonts.fonts[3];
+        REQUIRE(paged.name == "paged");
+        REQUIRE(paged.findGlyph(0, "A")->code == 1);
+        REQUIRE(paged.findGlyph(1, "A")->code == 0x10);
+        REQUIRE(paged.findGlyph(1, "B") == nullptr);
+        REQUIRE(paged.findDigraph(0, "l", "a")->id == "la");
+        REQUIRE(paged.findDigraph(0, "a", "l") == nullptr);
+        REQUIRE(paged.findNoun(0, "Sable")->codeCount == 5);
+        REQUIRE(paged.findNoun(1, "Sable") == nullptr);
+        REQUIRE(paged.findCommand("Page1")->page == 1);
+        REQUIRE(paged.findExtra("Ö")->value == 0x41);
+        REQUIRE(paged.findExtra("Page1") == nullptr);
+        REQUIRE(paged.getWidth(0, paged.findGlyph(0, "la")->code) == compiled.at("paged").getWidth(0, "la"));
+    }
+}
+
+// hidden, run it with: tests "[benchmark]"
+TEST_CASE("Encoding with compiled tables against font maps", "[.][benchmark]")
+{
+    std::ostringstream text;
+    for (int line = 0; line < 2000; ++line) {
+        text << "Sable said, \"Hello there, la ball " << line << "!\" We? Really? [Extra1]\n";
+    }
+    text << "[End]\n";
+    sable::util::Mapper mapper(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    auto encodeAll = [&mapper] (sable::TextParser& parser, const sable::TokenStream& tokens) {
+        sable::TokenStream::Reader reader(tokens);
+        auto settings = parser.getDefaultSetting(0x808000);
+        std::vector<unsigned char> data;
+        auto metadata = sable::TextParser::Metadata::No;
+        while (reader) {
+            metadata = parser.parseLine(reader, settings, data, metadata, mapper).metadata;
+        }
+        return data;
+    };
+    auto maps = makeParser(loadYaml());
+    auto tables = makeParser(loadCompiled());
+    std::istringstream input(text.str());
+    auto tokens = maps.lex(input);
+    // every line is encoded instead of being copied from the line cache.
+    maps.setLineCacheSize(0);
+    tables.setLineCacheSize(0);
+    REQUIRE(encodeAll(tables, tokens) == encodeAll(maps, tokens));
+
+    BENCHMARK("font maps")
+    {
+        return encodeAll(maps, tokens);
+    };
+    BENCHMARK("compiled tables")
+    {
+        return encodeAll(tables, tokens);
+    };
+}
+
+TEST_CASE("Generating font source", "[compiled]")
+{
+    auto fonts = loadYaml();
+    std::vector<const sable::Font*> list{&fonts.at("normal"), &fonts.at("paged")};
+    std::ostringstream first, second;
+    sable::FontCodeGenerator::write(list, "someFonts", "fonts.yml", first);
+    sable::FontCodeGenerator::write(list, "someFonts", "fonts.yml", second);
+
+    REQUIRE(first.str() == second.str());
+    REQUIRE_THAT(first.str(), Catch::Contains("const CompiledFonts someFonts{fonts.data(), fonts.size()};"));
+    // anything that isn't printable ASCII is escaped.
+    REQUIRE_THAT(first.str(), Catch::Contains("{\"\\342\\235\\244\", 78, 7}"));
+    REQUIRE_THAT(first.str(), Catch::Contains("{\"\\\"\", 60, 5}"));
+    REQUIRE_THROWS_AS(sable::FontCodeGenerator::write(list, "not a name", "fonts.yml", first), std::runtime_error);
+}
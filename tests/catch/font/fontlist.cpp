@@ -0,0 +1,68 @@
+#include <catch2/catch.hpp>
+
+#include "font/fontlist.h"
+#include "parse/textparser.h"
+#include "helpers.h"
+
+TEST_CASE("Fonts are built on first use", "[fontlist]")
+{
+    using sable::FontList;
+    auto node = sable_tests::getSampleNode();
+    node["broken"] = YAML::Clone(node["nodigraph"]);
+    node["broken"][sable::Font::BYTE_WIDTH] = 3;
+    node["menu"][sable::Font::FONT_ADDR] = "$C00000";
+
+    FontList fonts(sable_tests::defaultLocale);
+    fonts.load(node);
+    REQUIRE(fonts.size() == 4);
+    REQUIRE(fonts.contains("normal"));
+    REQUIRE(fonts.contains("broken"));
+    REQUIRE(!fonts.contains("test"));
+    REQUIRE(fonts.begin() == fonts.end());
+
+    SECTION("Looking a font up builds only that font.")
+    {
+        REQUIRE(fonts.at("normal").getByteWidth() == 1);
+        REQUIRE(fonts.isBuilt("normal"));
+        REQUIRE(!fonts.isBuilt("menu"));
+        REQUIRE(std::distance(fonts.begin(), fonts.end()) == 1);
+        REQUIRE_THROWS_AS(fonts.at("test"), std::out_of_range);
+    }
+    SECTION("Bad fonts only fail when they're used.")
+    {
+        REQUIRE_THROWS_AS(fonts.at("broken"), sable::FontError);
+        REQUIRE(!fonts.isBuilt("broken"));
+        REQUIRE(fonts.contains("broken"));
+    }
+    SECTION("Fonts with data to write are built up front.")
+    {
+        fonts.buildFontData();
+        REQUIRE(fonts.isBuilt("menu"));
+        REQUIRE(!fonts.isBuilt("normal"));
+        REQUIRE(fonts.find("menu")->second.getFontWidthLocation() == "$C00000");
+    }
+    SECTION("Later definitions replace earlier ones.")
+    {
+        REQUIRE(fonts.at("menu").getByteWidth() == 2);
+        YAML::Node replacement;
+        replacement["menu"] = YAML::Clone(node["nodigraph"]);
+        fonts.load(replacement);
+        REQUIRE(!fonts.isBuilt("menu"));
+        REQUIRE(fonts.at("menu").getByteWidth() == 1);
+    }
+    SECTION("The parser builds fonts as the script switches to them.")
+    {
+        sable::TextParser parser(std::move(fonts), "normal", sable_tests::defaultLocale, sable::options::ExportWidth::Off, sable::options::ExportAddress::Off);
+        sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+        auto settings = parser.getDefaultSetting(0x808000);
+        REQUIRE(parser.getFonts().isBuilt("normal"));
+        REQUIRE(!parser.getFonts().isBuilt("nodigraph"));
+        std::istringstream input("@type nodigraph\nText[End]");
+        std::vector<unsigned char> data;
+        parser.parseLine(input, settings, std::back_inserter(data), sable::TextParser::Metadata::No, mapper);
+        REQUIRE(settings.mode == "nodigraph");
+        REQUIRE(parser.getFonts().isBuilt("nodigraph"));
+        REQUIRE(!parser.getFonts().isBuilt("menu"));
+        REQUIRE(!parser.getFonts().isBuilt("broken"));
+    }
+}
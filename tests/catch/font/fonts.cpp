@@ -330,6 +330,15 @@ TEST_CASE("Test config validation")
         normalNode.remove(Font::BYTE_WIDTH);
         REQUIRE_THROWS_WITH(sable::FontBuilder::make(normalNode, "", sable_tests::defaultLocale), Contains(reqMessage + Font::BYTE_WIDTH +"\" is missing."));
     }
+    SECTION("Check compression validation.")
+    {
+        normalNode[Font::COMPRESSION] = "zip";
+        REQUIRE_THROWS_WITH(sable::FontBuilder::make(normalNode, "", sable_tests::defaultLocale), Contains("must be none or lz."));
+        normalNode[Font::COMPRESSION] = "lz";
+        REQUIRE(sable::FontBuilder::make(normalNode, "", sable_tests::defaultLocale).getCompression() == sable::compression::Codec::LZ);
+        normalNode.remove(Font::COMPRESSION);
+        REQUIRE(sable::FontBuilder::make(normalNode, "", sable_tests::defaultLocale).getCompression() == sable::compression::Codec::None);
+    }
     SECTION("Check command value validation.")
     {
         normalNode[Font::CMD_CHAR] = "invalid";
@@ -555,3 +564,69 @@ TEST_CASE("Test config validation")
         );
     }
 }
+
+TEST_CASE("Glyph tables", "[font]")
+{
+    sable::GlyphTable<int> table;
+    REQUIRE(table.find("a") == nullptr);
+    for (int index = 0; index < 1000; ++index) {
+        table.insert("glyph" + std::to_string(index), index);
+    }
+    table.insert("glyph10", -10);
+    REQUIRE(table.size() == 1000);
+    REQUIRE(*table.find("glyph999") == 999);
+    REQUIRE(*table.find("glyph10") == -10);
+    REQUIRE(table.find("glyph1000") == nullptr);
+    int expected = 0;
+    for (auto [id, value]: table) {
+        REQUIRE(id == "glyph" + std::to_string(expected));
+        ++expected;
+    }
+}
+
+TEST_CASE("Glyphs sharing a code use the first width defined", "[font]")
+{
+    using sable::Font;
+    auto node = sable_tests::getSampleNode()["normal"];
+    std::vector<std::pair<std::string, int>> glyphs{{"wide", 12}, {"narrow", 3}, {"plain", 0}};
+    SECTION("wide first")
+    {
+    }
+    SECTION("narrow first")
+    {
+        std::swap(glyphs[0], glyphs[1]);
+    }
+    for (auto& [id, width]: glyphs) {
+        node[Font::ENCODING][id][Font::CODE_VAL] = 0x70;
+        if (width > 0) {
+            node[Font::ENCODING][id][Font::TEXT_LENGTH_VAL] = width;
+        }
+    }
+    auto font = sable::FontBuilder::make(node, "normal", sable_tests::defaultLocale);
+    std::vector<int> widths;
+    font.getFontWidths(0, std::back_inserter(widths));
+    // the command value is 0, so the widths start at code 1.
+    REQUIRE(widths[0x70 - 1] == glyphs.front().second);
+}
+
+TEST_CASE("Identical pages are shared", "[font]")
+{
+    using sable::Font;
+    auto node = sable_tests::getSampleNode();
+    node["normal"][Font::PAGES].push_back(node["normal"][Font::ENCODING]);
+    auto first = sable::FontBuilder::make(node["normal"], "normal", sable_tests::defaultLocale);
+    auto second = sable::FontBuilder::make(node["normal"], "other", sable_tests::defaultLocale);
+    auto menu = sable::FontBuilder::make(node["menu"], "menu", sable_tests::defaultLocale);
+    REQUIRE(&first.getPage(0).getGlyphs() == &first.getPage(1).getGlyphs());
+    REQUIRE(&first.getPage(0).getGlyphs() == &second.getPage(0).getGlyphs());
+    REQUIRE(&first.getPage(0).getGlyphs() != &menu.getPage(0).getGlyphs());
+
+    SECTION("Changing a shared page copies it first.")
+    {
+        Font::Page page = first.getPage(0);
+        page.addGlyph("new", {0x70, 4});
+        REQUIRE(page.getGlyphs().find("new") != nullptr);
+        REQUIRE(first.getPage(0).getGlyphs().find("new") == nullptr);
+        REQUIRE(second.getPage(0).getGlyphs().find("new") == nullptr);
+    }
+}
@@ -13,3 +13,15 @@ TEST_CASE("Test normalization")
     REQUIRE(sable::normalize("zvýraznit") == sable::normalize("zv\u0079\u0301raznit"));
     REQUIRE(sable::normalize("östlich") == sable::normalize("\u006F\u0308stlich"));
 }
+
+TEST_CASE("Checking whether text is already normalized")
+{
+    REQUIRE(sable::isNormalized(""));
+    REQUIRE(sable::isNormalized("plain ASCII [End]"));
+    REQUIRE(sable::isNormalized("\u00C5land"));
+    REQUIRE(sable::isNormalized("\u3042\u3044\u3046"));
+    REQUIRE_FALSE(sable::isNormalized("\u0041\u030Aland"));
+    REQUIRE_FALSE(sable::isNormalized("\u212B"));
+    REQUIRE(sable::normalize("\u00C5land") == "\u00C5land");
+    REQUIRE(sable::isNormalized(sable::normalize("\u0041\u030Aland")));
+}
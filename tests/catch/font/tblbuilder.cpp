@@ -0,0 +1,116 @@
+#include <catch2/catch.hpp>
+
+#include <iomanip>
+#include <sstream>
+
+#include "font/tblbuilder.h"
+#include "font/fontlist.h"
+#include "parse/textparser.h"
+#include "helpers.h"
+
+using sable::TblBuilder, sable::Font, sable::FontError;
+
+namespace {
+    Font fromTable(const std::string& table)
+    {
+        std::istringstream input(table);
+        return TblBuilder::make(input, "table", sable_tests::defaultLocale);
+    }
+}
+
+TEST_CASE("Reading Thingy tables", "[tbl]")
+{
+    SECTION("One byte table")
+    {
+        auto font = fromTable(
+            "; comment\r\n"
+            "41=A\r\n"
+            "42=B\r\n"
+            "20= \r\n"
+            "80=AB\r\n"
+            "F0=[heart]\r\n"
+            "4142=ABBA\r\n"
+            "\r\n"
+            "/00=<end>\r\n"
+            "*01\r\n"
+            "$02=Wait,1\r\n"
+        );
+        REQUIRE(font.getByteWidth() == 1);
+        REQUIRE(font.getHasDigraphs());
+        REQUIRE(font.getNumberOfPages() == 1);
+        REQUIRE(font.getMaxEncodedValue(0) == 0xFF);
+        REQUIRE(font.getTextCode(0, "A") == std::make_tuple(0x41u, false));
+        REQUIRE(font.getTextCode(0, " ") == std::make_tuple(0x20u, false));
+        REQUIRE(font.getTextCode(0, "A", "B") == std::make_tuple(0x80u, true));
+        REQUIRE(font.getTextCode(0, "heart") == std::make_tuple(0xF0u, false));
+        REQUIRE(font.getEndValue() == 0);
+        REQUIRE(font.isCommandNewline("NewLine"));
+        REQUIRE(font.getCommandCode("NewLine") == 1);
+        REQUIRE(font.getCommandCode("Wait") == 2);
+        auto noun = font.getNounData(0, "ABBA");
+        REQUIRE(*(noun++) == 0x41);
+        REQUIRE(*(noun++) == 0x42);
+        REQUIRE(!noun);
+    }
+    SECTION("Two byte codes are in ROM order")
+    {
+        auto font = fromTable("8142=\xE3\x81\x82\n0A00=a\n/FFFF\n*FEFF=\n");
+        REQUIRE(font.getByteWidth() == 2);
+        REQUIRE(!font.getHasDigraphs());
+        REQUIRE(font.getTextCode(0, "\xE3\x81\x82") == std::make_tuple(0x4281u, false));
+        REQUIRE(font.getTextCode(0, "a") == std::make_tuple(0x000Au, false));
+        REQUIRE(font.getEndValue() == 0xFFFF);
+        REQUIRE(font.getCommandCode("NewLine") == 0xFFFE);
+    }
+    SECTION("Bad tables")
+    {
+        REQUIRE_THROWS_WITH(fromTable("41=A\n/00\n"), Catch::Contains("NewLine"));
+        REQUIRE_THROWS_WITH(fromTable("41=A\n4G=B\n"), Catch::Contains("line 2"));
+        REQUIRE_THROWS_AS(fromTable("41=A\n414=B\n"), FontError);
+        REQUIRE_THROWS_AS(fromTable("41\n"), FontError);
+        REQUIRE_THROWS_AS(fromTable("41=\n"), FontError);
+        REQUIRE_THROWS_AS(fromTable("/00\n*01\n"), FontError);
+        REQUIRE_THROWS_AS(fromTable("41=A\n/0000\n*01\n"), FontError);
+        REQUIRE_THROWS_WITH(fromTable("4142=A\n123456=B\n/0000\n*0100\n"), Catch::Contains("line 2"));
+        REQUIRE_THROWS_WITH(fromTable("41=A\n4142=B\n/00\n*01\n"), Catch::Contains("single character"));
+    }
+}
+
+TEST_CASE("Large Thingy tables", "[tbl]")
+{
+    std::ostringstream table;
+    table << std::hex << std::uppercase << std::setfill('0');
+    for (int code = 0x100; code < 0x10000; ++code) {
+        // every code is written as its two bytes in ROM order.
+        table << std::setw(2) << (code & 0xFF) << std::setw(2) << (code >> 8) << "=g" << std::dec << code << std::hex << '\n';
+    }
+    table << "/0000\n*0100\n";
+    auto font = fromTable(table.str());
+    REQUIRE(font.getPage(0).getGlyphs().size() == 0x10000 - 0x100);
+    REQUIRE(font.getTextCode(0, "g4660") == std::make_tuple(0x1234u, false));
+    REQUIRE(font.getCommandCode("NewLine") == 1);
+}
+
+TEST_CASE("Loading tables into a font list", "[tbl]")
+{
+    sable::FontList fonts(sable_tests::defaultLocale);
+    fonts.load(sable_tests::getSampleNode());
+    std::istringstream table("41=A\n42=B\n/00\n*01\n");
+    fonts.loadTable(table, "normal");
+    REQUIRE(fonts.isBuilt("normal"));
+    REQUIRE(fonts.at("normal").getCommandValue() == -1);
+
+    sable::TextParser parser(std::move(fonts), "normal", sable_tests::defaultLocale, sable::options::ExportWidth::Off, sable::options::ExportAddress::Off);
+    sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    std::istringstream input("AB\nBA");
+    auto settings = parser.getDefaultSetting(0x808000);
+    std::vector<unsigned char> data;
+    auto metadata = sable::TextParser::Metadata::No;
+    bool keepReading = false;
+    while (input || keepReading) {
+        auto result = parser.parseLine(input, settings, std::back_inserter(data), metadata, mapper);
+        metadata = result.metadata;
+        keepReading = !result.endOfBlock && (!data.empty() || metadata == sable::TextParser::Metadata::Yes);
+    }
+    REQUIRE(data == std::vector<unsigned char>{0x41, 0x42, 0x01, 0x42, 0x41, 0x00});
+}
@@ -0,0 +1,60 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+#include "output/asmwriter.h"
+
+TEST_CASE("AsmWriter formatting")
+{
+    sable::AsmWriter writer;
+    SECTION("Numbers")
+    {
+        writer.number(0x8081, 1).append(' ')
+              .number(-1, 2).append(' ')
+              .number(0x8000, 3).append(' ')
+              .number(0x12345678, 4).append(' ')
+              .number(-16, 1, 10).append(' ')
+              .number(5, 1, 2).append(' ')
+              .hex(0x123, 2);
+        REQUIRE(writer.str() == "$81 $ffff $008000 $12345678 -16 %00000101 $123");
+        REQUIRE_THROWS(writer.number(1, 5));
+        REQUIRE_THROWS(writer.number(1, 0, 2));
+        REQUIRE_THROWS(writer.number(1, 1, 8));
+    }
+    SECTION("Statements")
+    {
+        writer.assignment("def_test", 0x808000, 3).newLine()
+              .assignment("def_test_length", 16, 3, 10).newLine()
+              .assignment("def_other", 4, 1, 10, "def_test").newLine()
+              .orgDefine("def_test")
+              .org(0x908000)
+              .label("test")
+              .data(3).append("test").newLine()
+              .data(2).number(0x1234, 2).newLine();
+        REQUIRE(writer.str() ==
+            "!def_test = $808000\n"
+            "!def_test_length = 16\n"
+            "!def_other = !def_test+4\n"
+            "ORG !def_test\n"
+            "ORG $908000\n"
+            "test:\n"
+            "dl test\n"
+            "dw $1234\n"
+        );
+        REQUIRE_THROWS(writer.data(4));
+    }
+}
+
+TEST_CASE("AsmWriter buffering")
+{
+    std::ostringstream sink;
+    {
+        sable::AsmWriter writer(sink, 8);
+        writer.append("db $01\n");
+        REQUIRE(sink.str().empty());
+        writer.append("db $02\n");
+        REQUIRE(sink.str() == "db $01\n");
+        writer.flush();
+        REQUIRE(sink.str() == "db $01\ndb $02\n");
+        writer.append("db $03\n");
+    }
+    REQUIRE(sink.str() == "db $01\ndb $02\ndb $03\n");
+}
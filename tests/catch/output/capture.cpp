@@ -27,6 +27,20 @@ TEST_CASE("Capturing puts")
         }
         REQUIRE(sink.str() == "hello!\n");
     }
+    SECTION("More than a pipe can hold")
+    {
+        std::string line(1023, 'x');
+        {
+            OutputCapture o{sink};
+            for (int i = 0; i < 1024 + 1; i++) {
+                std::puts(line.c_str());
+            }
+            o.flush();
+            REQUIRE(o.str().size() == 1024 * (1024 + 1));
+            o.write();
+        }
+        REQUIRE(sink.str().size() == 1024 * (1024 + 1));
+    }
 
     SECTION("capture fails")
     {
@@ -0,0 +1,83 @@
+#include <catch2/catch.hpp>
+#include "output/patchcache.h"
+
+#include <fstream>
+
+#include "output/rompatcher.h"
+
+using sable::PatchCache, sable::RomPatcher;
+
+namespace {
+    void writeFile(const fs::path& file, const std::string& contents)
+    {
+        fs::create_directories(file.parent_path());
+        std::ofstream output(file.string(), std::ios::binary);
+        output << contents;
+    }
+}
+
+TEST_CASE("Assembly cache", "[patchcache]")
+{
+    fs::path dir = fs::temp_directory_path() / "sable_patch_cache_test";
+    fs::remove_all(dir);
+    writeFile(dir / "main.asm", "lorom\nincsrc asm/text.asm ; the text\nincsrc \"asm/fonts.asm\" : print \"done\"\n");
+    writeFile(dir / "asm" / "text.asm", "incbin bin/text.bin\n");
+    writeFile(dir / "asm" / "bin" / "text.bin", "\x01\x02\x03");
+    writeFile(dir / "asm" / "fonts.asm", "incbin widths.bin:0-10 -> widths\n");
+    writeFile(dir / "widths.bin", "\x08\x08");
+
+    RomPatcher rom;
+    REQUIRE(rom.loadRom("sample.sfc", "", -1));
+
+    SECTION("Every file the patch includes is followed, in order.")
+    {
+        auto files = PatchCache::dependencies(dir / "main.asm");
+        REQUIRE(files.has_value());
+        std::vector<std::string> names;
+        for (auto& file: *files) {
+            names.push_back(file.filename().string());
+        }
+        REQUIRE(names == std::vector<std::string>{"main.asm", "text.asm", "text.bin", "fonts.asm", "widths.bin"});
+    }
+    SECTION("The key changes with the ROM and the included files.")
+    {
+        auto key = PatchCache::key(rom, dir / "main.asm");
+        REQUIRE(key.has_value());
+        REQUIRE(PatchCache::key(rom, dir / "main.asm") == key);
+
+        writeFile(dir / "asm" / "bin" / "text.bin", "\x01\x02\x04");
+        auto changedText = PatchCache::key(rom, dir / "main.asm");
+        REQUIRE(changedText != key);
+
+        rom.at(0) ^= 0xFF;
+        REQUIRE(PatchCache::key(rom, dir / "main.asm") != changedText);
+    }
+    SECTION("Patches which use files that can't be followed aren't cached.")
+    {
+        writeFile(dir / "asm" / "text.asm", "incbin !textDir/text.bin\n");
+        REQUIRE(!PatchCache::key(rom, dir / "main.asm"));
+        writeFile(dir / "asm" / "text.asm", "incbin missing.bin\n");
+        REQUIRE(!PatchCache::key(rom, dir / "main.asm"));
+        writeFile(dir / "asm" / "text.asm", "db readfile1(\"bin/text.bin\", 0)\n");
+        REQUIRE(!PatchCache::key(rom, dir / "main.asm"));
+    }
+    SECTION("A stored ROM is only loaded with the same key.")
+    {
+        PatchCache cache(dir / "cache");
+        REQUIRE(!cache.load("rom", "key", rom));
+
+        RomPatcher patched;
+        REQUIRE(patched.loadRom("sample.sfc", "", -1));
+        patched.at(0x10) = 0x42;
+        cache.store("rom", "key", patched);
+
+        REQUIRE(!cache.load("rom", "other key", rom));
+        REQUIRE(rom.at(0x10) != 0x42);
+        REQUIRE(cache.load("rom", "key", rom));
+        REQUIRE(rom.at(0x10) == 0x42);
+        std::vector<std::string> prints;
+        REQUIRE(rom.getMessages(std::back_inserter(prints)));
+        REQUIRE(prints.empty());
+    }
+    fs::remove_all(dir);
+}
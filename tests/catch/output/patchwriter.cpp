@@ -0,0 +1,262 @@
+#include <catch2/catch.hpp>
+#include "output/patchwriter.h"
+
+#include <fstream>
+#include <sstream>
+
+#include "output/rompatcher.h"
+
+typedef std::vector<unsigned char> ByteVector;
+
+namespace {
+    ByteVector applyIps(ByteVector data, const std::string& patch)
+    {
+        REQUIRE(patch.substr(0, 5) == "PATCH");
+        auto byte = [&patch] (std::size_t index) -> std::size_t {
+            return static_cast<unsigned char>(patch.at(index));
+        };
+        std::size_t position = 5;
+        while (patch.substr(position, 3) != "EOF") {
+            std::size_t offset = (byte(position) << 16) | (byte(position + 1) << 8) | byte(position + 2);
+            std::size_t size = (byte(position + 3) << 8) | byte(position + 4);
+            position += 5;
+            if (size == 0) {
+                size = (byte(position) << 8) | byte(position + 1);
+                if (data.size() < offset + size) {
+                    data.resize(offset + size);
+                }
+                std::fill_n(data.begin() + offset, size, byte(position + 2));
+                position += 3;
+            } else {
+                if (data.size() < offset + size) {
+                    data.resize(offset + size);
+                }
+                std::copy_n(patch.begin() + position, size, data.begin() + offset);
+                position += size;
+            }
+        }
+        position += 3;
+        if (position + 3 == patch.size()) {
+            data.resize((byte(position) << 16) | (byte(position + 1) << 8) | byte(position + 2));
+            position += 3;
+        }
+        REQUIRE(position == patch.size());
+        return data;
+    }
+
+    ByteVector applyBps(const ByteVector& source, const std::string& patch)
+    {
+        REQUIRE(patch.substr(0, 4) == "BPS1");
+        std::size_t position = 4;
+        auto decode = [&] () {
+            std::uint64_t data = 0, shift = 1;
+            while (true) {
+                unsigned char x = patch.at(position++);
+                data += (x & 0x7F) * shift;
+                if (x & 0x80) {
+                    break;
+                }
+                shift <<= 7;
+                data += shift;
+            }
+            return data;
+        };
+        REQUIRE(decode() == source.size());
+        ByteVector target(decode());
+        position += decode();
+        std::size_t outputOffset = 0, sourceRelative = 0, targetRelative = 0;
+        while (position < patch.size() - 12) {
+            auto action = decode();
+            std::size_t length = (action >> 2) + 1;
+            switch (action & 3) {
+            case 0:
+                std::copy_n(source.begin() + outputOffset, length, target.begin() + outputOffset);
+                outputOffset += length;
+                break;
+            case 1:
+                std::copy_n(patch.begin() + position, length, target.begin() + outputOffset);
+                position += length;
+                outputOffset += length;
+                break;
+            case 2:
+            case 3:
+            {
+                auto offset = decode();
+                std::int64_t relative = (offset & 1 ? -1 : 1) * static_cast<std::int64_t>(offset >> 1);
+                auto& base = (action & 3) == 2 ? sourceRelative : targetRelative;
+                base += relative;
+                while (length--) {
+                    target[outputOffset++] = (action & 3) == 2 ? source[base++] : target[base++];
+                }
+                break;
+            }
+            }
+        }
+        REQUIRE(outputOffset == target.size());
+        auto crc = [&patch] (std::size_t index) {
+            std::uint32_t value = 0;
+            for (int byte = 3; byte >= 0; --byte) {
+                value = (value << 8) | static_cast<unsigned char>(patch.at(index + byte));
+            }
+            return value;
+        };
+        REQUIRE(crc(position) == sable::patch::crc32(source.data(), source.size()));
+        REQUIRE(crc(position + 4) == sable::patch::crc32(target.data(), target.size()));
+        REQUIRE(crc(position + 8) == sable::patch::crc32(reinterpret_cast<const unsigned char*>(patch.data()), position + 8));
+        return target;
+    }
+}
+
+TEST_CASE("Finding changed ranges", "[patch]")
+{
+    using sable::patch::diff;
+    ByteVector base(100, 0), target(100, 0);
+    SECTION("Identical data has no changes.")
+    {
+        REQUIRE(diff(base.data(), base.size(), target.data(), target.size()).empty());
+    }
+    SECTION("Changes are found at any alignment.")
+    {
+        target[3] = 1;
+        target[40] = 2;
+        target[41] = 2;
+        target[99] = 3;
+        auto ranges = diff(base.data(), base.size(), target.data(), target.size());
+        REQUIRE(ranges.size() == 3);
+        REQUIRE(ranges[0].offset == 3);
+        REQUIRE(ranges[0].length == 1);
+        REQUIRE(ranges[1].offset == 40);
+        REQUIRE(ranges[1].length == 2);
+        REQUIRE(ranges[2].offset == 99);
+        REQUIRE(ranges[2].length == 1);
+    }
+    SECTION("Nearby changes are merged.")
+    {
+        target[10] = 1;
+        target[14] = 1;
+        auto ranges = diff(base.data(), base.size(), target.data(), target.size());
+        REQUIRE(ranges.size() == 1);
+        REQUIRE(ranges[0].offset == 10);
+        REQUIRE(ranges[0].length == 5);
+        REQUIRE(diff(base.data(), base.size(), target.data(), target.size(), 0).size() == 2);
+    }
+    SECTION("Expanded data is always changed.")
+    {
+        target.resize(150, 0);
+        auto ranges = diff(base.data(), base.size(), target.data(), target.size());
+        REQUIRE(ranges.size() == 1);
+        REQUIRE(ranges[0].offset == 100);
+        REQUIRE(ranges[0].length == 50);
+    }
+}
+
+TEST_CASE("Writing patches", "[patch]")
+{
+    ByteVector base(0x20000);
+    for (std::size_t index = 0; index < base.size(); ++index) {
+        base[index] = (index * 7) & 0xFF;
+    }
+    ByteVector target = base;
+    std::fill_n(target.begin() + 0x100, 0x40, 0xFF);
+    target[0x1000] ^= 0x55;
+    std::copy_n(base.begin(), 0x300, target.begin() + 0x8000);
+    SECTION("Same size.")
+    {
+    }
+    SECTION("Expanded.")
+    {
+        target.resize(0x40000, 0);
+        target.back() = 1;
+    }
+    SECTION("Truncated.")
+    {
+        target.resize(0x18000);
+    }
+    SECTION("Large changes.")
+    {
+        std::fill(target.begin() + 0x2000, target.begin() + 0x1F000, 0xEE);
+    }
+    std::ostringstream ips, bps;
+    sable::patch::writeIps(ips, base, target);
+    sable::patch::writeBps(bps, base, target);
+    REQUIRE(applyIps(base, ips.str()) == target);
+    REQUIRE(applyBps(base, bps.str()) == target);
+    REQUIRE(bps.str().size() < 0x1000);
+}
+
+TEST_CASE("IPS records never start at EOF.", "[patch]")
+{
+    ByteVector base(0x460000, 0), target = base;
+    target[0x454F46] = 1;
+    target[0x454F50] = 1;
+    std::fill_n(target.begin() + 0x454F46 + 0x100, 0x20, 2);
+    std::ostringstream ips;
+    sable::patch::writeIps(ips, base, target);
+    REQUIRE(ips.str().find("EOF") == ips.str().size() - 3);
+    REQUIRE(applyIps(base, ips.str()) == target);
+}
+
+TEST_CASE("Patch formats", "[patch]")
+{
+    using sable::patch::Format;
+    REQUIRE(sable::patch::parseFormat("ips") == Format::IPS);
+    REQUIRE(sable::patch::parseFormat("bps") == Format::BPS);
+    REQUIRE_THROWS(sable::patch::parseFormat("ups"));
+    REQUIRE(sable::patch::getExtension(Format::BPS) == ".bps");
+    unsigned char check[] = "123456789";
+    REQUIRE(sable::patch::crc32(check, 9) == 0xCBF43926);
+}
+
+TEST_CASE("Writing only changed ROM data", "[patch][rompatcher]")
+{
+    fs::path romFile = fs::temp_directory_path() / "sable_patch_test.sfc";
+    fs::path outputFile = fs::temp_directory_path() / "sable_patch_test_out.sfc";
+    fs::path record = fs::temp_directory_path() / "sable_patch_test" / "test.written";
+    {
+        std::ofstream rom(romFile, std::ios::binary);
+        rom << std::string(0x8000, '\x00');
+    }
+    fs::remove(outputFile);
+    fs::remove(record);
+    auto readOutput = [&outputFile] () {
+        std::ifstream output(outputFile, std::ios::binary);
+        return ByteVector((std::istreambuf_iterator<char>(output)), std::istreambuf_iterator<char>());
+    };
+    sable::RomPatcher patcher;
+    REQUIRE(patcher.loadRom(romFile.string(), "test", 0, true));
+    REQUIRE(patcher.writeRom(outputFile.string(), record) == 0x8000);
+    REQUIRE(patcher.writeRom(outputFile.string(), record) == 0);
+    patcher.at(0x10) = 1;
+    patcher.at(0x4000) = 2;
+    REQUIRE(patcher.writeRom(outputFile.string(), record) == 2);
+    {
+        auto data = readOutput();
+        REQUIRE(data.size() == 0x8000);
+        REQUIRE(data[0x10] == 1);
+        REQUIRE(data[0x4000] == 2);
+    }
+    std::ostringstream ips;
+    patcher.writePatch(sable::patch::Format::IPS, ips);
+    REQUIRE(ips.str().size() == 5 + 6 + 6 + 3);
+
+    SECTION("Ranges only the last build wrote go back to the loaded ROM's data")
+    {
+        sable::RomPatcher next;
+        REQUIRE(next.loadRom(romFile.string(), "test"));
+        next.at(0x20) = 3;
+        REQUIRE(next.writeRom(outputFile.string(), record) == 3);
+        auto data = readOutput();
+        REQUIRE(data[0x10] == 0);
+        REQUIRE(data[0x20] == 3);
+        REQUIRE(data[0x4000] == 0);
+        REQUIRE_THROWS_AS(next.writePatch(sable::patch::Format::IPS, ips), std::logic_error);
+    }
+    SECTION("Without a record the whole ROM is written")
+    {
+        fs::remove(record);
+        REQUIRE(patcher.writeRom(outputFile.string(), record) == 0x8000);
+    }
+    fs::remove(romFile);
+    fs::remove(outputFile);
+    fs::remove_all(record.parent_path());
+}
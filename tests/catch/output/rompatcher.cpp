@@ -333,6 +333,39 @@ TEST_CASE("Font output", "[rompatcher]")
         REQUIRE(lines[2] == "db $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08, $08");
         REQUIRE(lines[3] == "db $08, $08, $08, $08, $08, $08, $08, $08, $08");
     }
+    SECTION("Binary width table.")
+    {
+        fl["normal"][sable::Font::FONT_ADDR] = "!somewhere";
+        fl["normal"][sable::Font::ENCODING]["B"][sable::Font::TEXT_LENGTH_VAL] = 6;
+        fl["normal"][sable::Font::ENCODING]["C"][sable::Font::TEXT_LENGTH_VAL] = 0;
+        subject1["test"] = sable::FontBuilder::make(
+            fl["normal"],
+            "test",
+            sable_tests::defaultLocale
+        );
+        REQUIRE(subject1["test"].getWidth(0, "B") == 6);
+        REQUIRE(subject1["test"].getWidth(0, "C") == 0);
+        fs::path widthDir = fs::temp_directory_path() / "sable_width_test";
+        fs::create_directories(widthDir);
+        r.writeFontData(subject1, sink, widthDir);
+
+        std::string data = sink.str();
+        auto lines = getLines(data);
+        REQUIRE(lines.size() == 3);
+        REQUIRE(lines[1] == "ORG !somewhere");
+        REQUIRE(lines[2] == "incbin test_widths.bin");
+
+        std::ifstream widthFile((widthDir / "test_widths.bin").string(), std::ios::binary);
+        std::vector<char> widths{std::istreambuf_iterator<char>(widthFile), std::istreambuf_iterator<char>()};
+        // code 0 is the command value, so the table starts at A.
+        REQUIRE(widths.size() == 26);
+        REQUIRE(widths[0] == 8);
+        REQUIRE(widths[1] == 6);
+        REQUIRE(widths[2] == 0);
+        REQUIRE(widths[25] == 8);
+        widthFile.close();
+        fs::remove_all(widthDir);
+    }
 }
 
 TEST_CASE("Address data output", "[rompatcher]")
@@ -447,6 +480,24 @@ TEST_CASE("Address data output", "[rompatcher]")
         REQUIRE(lines[5] == "incbin test/file2.bin");
         REQUIRE(lines[6] == "");
     }
+    SECTION("Deduplicated block.")
+    {
+        al.addAddress(0x908000, "somefile", false);
+        al.addAlias("somefile2", 0x908008, {"somefile", 8, ExportWidth::On});
+        r.writeParsedData(al, writeDir, textSink, defineSink);
+        REQUIRE(defineSink.str() == "!def_somefile = $908000\n"
+                                    "!def_somefile2 = $908008\n"
+                                    "!def_somefile2_length = 8\n");
+
+        std::string data = textSink.str();
+        auto lines = getLines(data);
+        REQUIRE(lines.size() == 5);
+        REQUIRE(lines[0] == "ORG !def_somefile");
+        REQUIRE(lines[1] == "somefile:");
+        REQUIRE(lines[2] == "incbin test/file.bin");
+        REQUIRE(lines[3] == "");
+        REQUIRE(lines[4] == "somefile2 = !def_somefile2 ; same data as somefile");
+    }
     SECTION("Table with 3-byte addresses")
     {
         sable::Table tbl;
@@ -537,3 +588,15 @@ TEST_CASE("Address data output", "[rompatcher]")
         REQUIRE_THROWS(r.writeParsedData(al, writeDir, textSink, defineSink));
     }
 }
+
+TEST_CASE("Decompressor output", "[rompatcher]")
+{
+    sable::RomPatcher r;
+    std::ostringstream output;
+    REQUIRE_THROWS(r.writeDecompressor(sable::compression::Codec::None, output));
+    r.writeDecompressor(sable::compression::Codec::LZ, output);
+    std::string data = output.str();
+    auto lines = getLines(data);
+    REQUIRE(std::find(lines.begin(), lines.end(), "sable_decompress_lz:") != lines.end());
+    REQUIRE(lines.back() == "    rtl");
+}
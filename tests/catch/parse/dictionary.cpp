@@ -0,0 +1,71 @@
+#include <catch2/catch.hpp>
+
+#include "parse/dictionary.h"
+#include "font/builder.h"
+
+#include "helpers.h"
+
+using sable_tests::getSampleFonts;
+using sable::DictionaryOptimizer;
+
+TEST_CASE("Dictionary optimization", "[dictionary]")
+{
+    auto fonts = getSampleFonts();
+    SECTION("Frequent pairs become digraphs")
+    {
+        DictionaryOptimizer subject(fonts.at("normal"), 0, sable_tests::defaultLocale);
+        for (int i = 0; i < 10; ++i) {
+            subject.addLine("the that this they them[End]");
+        }
+        auto result = subject.optimize(1);
+        REQUIRE(result.entries.size() == 1);
+        REQUIRE(!result.entries[0].isNoun);
+        REQUIRE(result.entries[0].text == "th");
+        REQUIRE(result.entries[0].savings == 50);
+        REQUIRE(result.originalSize - result.optimizedSize == 50);
+        auto used = fonts.at("normal").getUsedCodes(0);
+        REQUIRE(used.find(result.entries[0].code) == used.end());
+    }
+    SECTION("Command codes aren't given out")
+    {
+        auto node = sable_tests::getSampleNode();
+        auto used = fonts.at("normal").getUsedCodes(0);
+        unsigned int free = 0;
+        while (used.count(free)) {
+            ++free;
+        }
+        node["normal"][sable::Font::COMMANDS]["End"][sable::Font::CODE_VAL] = free;
+        auto font = sable::FontBuilder::make(node["normal"], "normal", sable_tests::defaultLocale);
+        DictionaryOptimizer subject(font, 0, sable_tests::defaultLocale);
+        for (int i = 0; i < 10; ++i) {
+            subject.addLine("the that this they them");
+        }
+        auto result = subject.optimize(1);
+        REQUIRE(result.entries.size() == 1);
+        REQUIRE(result.entries[0].code != free);
+    }
+    SECTION("Frequent words become nouns without digraph support")
+    {
+        DictionaryOptimizer subject(fonts.at("nodigraph"), 0, sable_tests::defaultLocale);
+        subject.addLine("Alice and Alice");
+        subject.addLine("Alice # comment Alice Alice");
+        subject.addLine("Alice @label Alice");
+        auto result = subject.optimize();
+        REQUIRE(result.entries.size() == 2);
+        REQUIRE(result.entries[0].isNoun);
+        REQUIRE(result.entries[0].text == "Alice");
+        REQUIRE(result.entries[0].savings == 16);
+        REQUIRE(result.entries[1].text == "and");
+        REQUIRE(result.entries[1].savings == 2);
+        REQUIRE(result.originalSize == 27);
+        REQUIRE(result.optimizedSize == 9);
+    }
+    SECTION("Nothing is suggested when there's nothing to save")
+    {
+        DictionaryOptimizer subject(fonts.at("normal"), 0, sable_tests::defaultLocale);
+        subject.addLine("a[End]b");
+        auto result = subject.optimize();
+        REQUIRE(result.entries.empty());
+        REQUIRE(result.originalSize == result.optimizedSize);
+    }
+}
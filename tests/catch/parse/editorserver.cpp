@@ -0,0 +1,62 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "parse/editorserver.h"
+#include "helpers.h"
+
+using sable::EditorServer;
+using Catch::Matchers::Contains;
+
+TEST_CASE("Editor server requests", "[server]")
+{
+    sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    auto node = sable_tests::getSampleNode();
+    node["normal"][sable::Font::MAX_WIDTH] = 20;
+    EditorServer server(node.as<std::map<std::string, sable::Font>>(), "normal", sable_tests::defaultLocale, mapper);
+
+    SECTION("Initialize lists the fonts.")
+    {
+        REQUIRE(server.handle(R"({"jsonrpc":"2.0","id":1,"method":"initialize"})") ==
+                R"({"jsonrpc":"2.0","id":1,"result":{"defaultMode":"normal","fonts":["menu","nodigraph","normal"]}})");
+    }
+    SECTION("Lines get their widths and bytes.")
+    {
+        auto reply = server.handle(R"({"jsonrpc":"2.0","id":"a","method":"encode","params":{"text":"Testing\nLine[End]"}})");
+        REQUIRE_THAT(reply, Contains(R"("id":"a")"));
+        REQUIRE_THAT(reply, Contains(R"({"line":1,"width":30,"maxWidth":20,)"));
+        REQUIRE_THAT(reply, Contains(R"("blocks":[{"line":1,"label":"","size":)"));
+        REQUIRE_THAT(reply, Contains(R"({"line":1,"severity":"warning","message":"Line is longer than the specified max width of 20 pixels."})"));
+    }
+    SECTION("Each block is reported.")
+    {
+        auto reply = server.handle(R"({"jsonrpc":"2.0","id":2,"method":"encode","params":{"text":"A[End]\nB[End]","type":"menu"}})");
+        REQUIRE_THAT(reply, Contains(R"("blocks":[{"line":1,"label":"","size":4},{"line":2,"label":"","size":4}])"));
+        REQUIRE_THAT(reply, Contains(R"({"line":1,"width":8,"maxWidth":0,"bytes":"0000FFFF"})"));
+    }
+    SECTION("Unknown glyphs are errors, and parsing carries on.")
+    {
+        auto reply = server.handle(R"({"jsonrpc":"2.0","id":3,"method":"encode","params":{"text":"~\nOK[End]"}})");
+        REQUIRE_THAT(reply, Contains(R"({"line":1,"severity":"error","message":"\"~\" not found)"));
+        REQUIRE_THAT(reply, Contains(R"({"line":2,)"));
+    }
+    SECTION("Bad requests get errors.")
+    {
+        REQUIRE_THAT(server.handle("{not json"), Contains(R"("code":-32700)"));
+        REQUIRE_THAT(server.handle(R"({"jsonrpc":"2.0","id":4,"method":"nothing"})"), Contains(R"("id":4,"error":{"code":-32601)"));
+        REQUIRE_THAT(server.handle(R"({"jsonrpc":"2.0","id":5,"method":"encode","params":{"text":"A","type":"none"}})"), Contains(R"("code":-32602)"));
+        REQUIRE(server.handle(R"({"jsonrpc":"2.0","method":"nothing"})").empty());
+    }
+    SECTION("The server runs until exit.")
+    {
+        std::istringstream input(
+            "{\"jsonrpc\":\"2.0\",\"id\":1,\"method\":\"shutdown\"}\n"
+            "\n"
+            "{\"jsonrpc\":\"2.0\",\"method\":\"exit\"}\n"
+            "{\"jsonrpc\":\"2.0\",\"id\":2,\"method\":\"shutdown\"}\n"
+        );
+        std::ostringstream output;
+        server.run(input, output);
+        REQUIRE(server.isDone());
+        REQUIRE(output.str() == "{\"jsonrpc\":\"2.0\",\"id\":1,\"result\":null}\n");
+    }
+}
@@ -29,12 +29,19 @@ struct stubWriter: sable::Parser<stubWriter>
     };
     std::vector<expected> cases;
     std::vector<errorParams> errors;
+    std::vector<int> widths;
+    bool haltOnError = true;
 
     stubWriter(const std::string& defaultMode)
         : Parser(getSampleFonts(), defaultMode, "en_US.utf-8", sable::options::ExportWidth::Off, sable::options::ExportAddress::On)
     {
     }
 
+    stubWriter(std::map<std::string, sable::Font>&& fonts, const std::string& defaultMode)
+        : Parser(std::move(fonts), defaultMode, "en_US.utf-8", sable::options::ExportWidth::Off, sable::options::ExportAddress::On)
+    {
+    }
+
     void report(
         std::string file,
         sable::error::Levels l,
@@ -42,7 +49,7 @@ struct stubWriter: sable::Parser<stubWriter>
         int line
     ) {
         errors.push_back({file, l, msg, line});
-        if (l == sable::error::Levels::Error) {
+        if (l == sable::error::Levels::Error && haltOnError) {
             throw std::runtime_error("Test Halted");
         }
     }
@@ -61,6 +68,11 @@ struct stubWriter: sable::Parser<stubWriter>
     {
         cases.push_back({fileName, label, data, address, start, length, printpc});
     }
+
+    void measure(int width)
+    {
+        widths.push_back(width);
+    }
 };
 
 TEST_CASE("Loading script data from files")
@@ -292,3 +304,154 @@ TEST_CASE("Data store error handling")
         }
     }
 }
+
+TEST_CASE("Parsing continues after errors that don't stop it")
+{
+    stubWriter subject("normal");
+    subject.haltOnError = false;
+    std::istringstream input;
+    sable::util::Mapper m(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    input.str("ABC[NotACommand]\n"
+              "DEF\n"
+              "GHI[AlsoNotACommand]\n"
+              "JKL[End]\n");
+    REQUIRE_NOTHROW(subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+    REQUIRE(subject.errors.size() == 2);
+    REQUIRE(subject.errors[0].line == 1);
+    REQUIRE(subject.errors[1].line == 3);
+    REQUIRE(subject.cases.size() == 1);
+}
+
+TEST_CASE("Block widths are measured")
+{
+    stubWriter subject("normal");
+    std::istringstream input;
+    sable::util::Mapper m(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    input.str("ABCDEFG[End]\n"
+              "DEFG[End]\n"
+              "DEFG\n"
+              "ABCDEFG\n");
+    REQUIRE_NOTHROW(subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+    REQUIRE(subject.cases.size() == 3);
+    REQUIRE(subject.widths.size() == 3);
+    REQUIRE(subject.widths[0] > subject.widths[1]);
+    REQUIRE(subject.widths[2] == subject.widths[0]);
+    REQUIRE(subject.errors.size() == 0);
+}
+
+TEST_CASE("Block deduplication")
+{
+    stubWriter subject("normal");
+    std::istringstream input;
+    sable::util::Mapper m(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    sable::parse::FileResult r;
+    input.str("ABCDEFG[End]\n"
+              "ABCDEFG[End]\n"
+              "DEFG[End]\n"
+              "XYZ\n");
+    SECTION("Deduplication is off by default")
+    {
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+        REQUIRE(subject.cases.size() == 4);
+        REQUIRE(subject.cases[1].address == 0x808009);
+        REQUIRE(subject.getDeduplicatedBytes() == 0);
+    }
+    SECTION("Identical blocks and suffixes share data")
+    {
+        subject.setDeduplication(sable::options::Deduplicate::On);
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+        REQUIRE(subject.cases.size() == 4);
+        REQUIRE(subject.cases[0].address == 0x808000);
+        REQUIRE(subject.cases[0].label == "test_0");
+        REQUIRE(subject.cases[0].data.size() == 9);
+
+        REQUIRE(subject.cases[1].address == 0x808000);
+        REQUIRE(subject.cases[1].label == "test_1");
+
+        REQUIRE(subject.cases[2].address == 0x808003);
+        REQUIRE(subject.cases[2].label == "test_2");
+        REQUIRE(subject.cases[2].data.size() == 6);
+
+        REQUIRE(subject.cases[3].address == 0x808009);
+        REQUIRE(subject.cases[3].label == "test_3");
+
+        REQUIRE(subject.getDeduplicatedBytes() == 15);
+        REQUIRE(r.address == 0x808009 + subject.cases[3].data.size());
+        REQUIRE(r.dirIndex == 4);
+    }
+    REQUIRE(subject.errors.size() == 0);
+}
+
+TEST_CASE("Block compression")
+{
+    auto node = sable_tests::getSampleNode();
+    node["normal"][sable::Font::COMPRESSION] = "lz";
+    stubWriter subject(node.as<std::map<std::string, sable::Font>>(), "normal");
+    std::istringstream input;
+    sable::util::Mapper m(sable::util::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    sable::parse::FileResult r;
+    std::vector<unsigned char> raw;
+    {
+        stubWriter plain("normal");
+        input.str("ABCABCABCABCABCABC\n");
+        plain.processFile(input, m, "test", "test/test.txt", 0x808000, 0);
+        raw = plain.cases[0].data;
+        input.clear();
+    }
+    SECTION("Blocks are stored compressed")
+    {
+        input.str("ABCABCABCABCABCABC\n");
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+        REQUIRE(subject.cases.size() == 1);
+        REQUIRE(subject.cases[0].length < raw.size());
+        REQUIRE(subject.cases[0].length == subject.cases[0].data.size());
+        REQUIRE(sable::compression::decompress(sable::compression::Codec::LZ, subject.cases[0].data) == raw);
+        REQUIRE(r.address == 0x808000 + subject.cases[0].length);
+    }
+    SECTION("Compressed blocks are not split across banks")
+    {
+        input.str("ABCABCABCABCABCABC\n");
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", 0x80FFFC, 0));
+        REQUIRE(subject.cases.size() == 1);
+        REQUIRE(subject.cases[0].address == 0x818000);
+    }
+    SECTION("A compressed block which ends on the last byte of a bank stays in it")
+    {
+        stubWriter measured(node.as<std::map<std::string, sable::Font>>(), "normal");
+        input.str("ABCABCABCABCABCABC\n");
+        measured.processFile(input, m, "test", "test/test.txt", 0x808000, 0);
+        int start = 0x810000 - static_cast<int>(measured.cases[0].length);
+        input.clear();
+        input.str("ABCABCABCABCABCABC\n");
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", start, 0));
+        // like any block which fills its bank, the next bank gets an empty piece.
+        REQUIRE(subject.cases.back().address == start);
+        REQUIRE(subject.cases.back().length == measured.cases[0].length);
+        REQUIRE(r.address == 0x818000);
+    }
+    SECTION("A compressed block with an address that doesn't fit is an error")
+    {
+        input.str("@address 80FFFC\nABCABCABCABCABCABC\n");
+        REQUIRE_THROWS_WITH(subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0), "Test Halted");
+        REQUIRE(subject.errors.size() == 1);
+        REQUIRE(subject.errors[0].msg.find("doesn't fit in the bank at $80FFFC") != std::string::npos);
+        subject.errors.clear();
+
+        // a handler which keeps going still gets the block where it was put.
+        subject.haltOnError = false;
+        input.clear();
+        input.str("@address 80FFFC\nABCABCABCABCABCABC\n");
+        subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0);
+        REQUIRE(subject.errors.size() == 1);
+        REQUIRE(subject.cases.back().address == 0x80FFFC);
+        subject.errors.clear();
+    }
+    SECTION("Compression can be turned off")
+    {
+        subject.setCompression(sable::options::CompressBlocks::Off);
+        input.str("ABCABCABCABCABCABC\n");
+        REQUIRE_NOTHROW(r = subject.processFile(input, m, "test", "test/test.txt", 0x808000, 0));
+        REQUIRE(subject.cases[0].data == raw);
+    }
+    REQUIRE(subject.errors.size() == 0);
+}
@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "parse/textparser.h"
+#include "helpers.h"
+
+using sable::ParseStats, sable::TextParser;
+using sable::options::ExportAddress, sable::options::ExportWidth;
+using Metadata = TextParser::Metadata;
+
+TEST_CASE("Collecting statistics", "[stats]")
+{
+    sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    TextParser parser(sable_tests::getSampleFonts(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    REQUIRE(parser.getStats() == nullptr);
+    auto stats = std::make_shared<ParseStats>();
+    parser.setStats(stats);
+
+    std::istringstream input("Hello all[Test]\nla");
+    auto settings = parser.getDefaultSetting(0x808000);
+    std::vector<unsigned char> data;
+    auto metadata = Metadata::No;
+    bool keepReading = false;
+    while (input || keepReading) {
+        auto result = parser.parseLine(input, settings, std::back_inserter(data), metadata, mapper);
+        metadata = result.metadata;
+        keepReading = !result.endOfBlock && (!data.empty() || metadata == Metadata::Yes);
+    }
+
+    REQUIRE(stats->getFonts().size() == 1);
+    auto& font = stats->getFonts().at("normal");
+    auto& page = font.pages.at(0);
+    SECTION("Glyphs are counted once for each time they're encoded.")
+    {
+        REQUIRE(page.glyphs.at("H") == 1);
+        REQUIRE(page.glyphs.at("a") == 1);
+        REQUIRE(page.glyphs.at("ll") == 2);
+        REQUIRE(page.glyphs.at("la") == 1);
+        REQUIRE(page.glyphs.count("l") == 0);
+    }
+    SECTION("Digraphs are split into hits and misses.")
+    {
+        REQUIRE(page.digraphs.at("ll") == 2);
+        REQUIRE(page.digraphs.at("la") == 1);
+        REQUIRE(page.digraphMisses.at("He") == 1);
+        REQUIRE(page.digraphMisses.at("o ") == 1);
+        REQUIRE(page.digraphMisses.count("ll") == 0);
+    }
+    SECTION("Commands include the ones added automatically.")
+    {
+        REQUIRE(font.commands.at("Test") == 1);
+        REQUIRE(font.commands.at("NewLine") == 1);
+        REQUIRE(font.commands.at("End") == 1);
+    }
+    SECTION("Writing the counts out")
+    {
+        std::ostringstream json, csv;
+        stats->writeJson(json);
+        stats->writeCsv(csv);
+        REQUIRE(json.str().rfind("{\"fonts\":{\"normal\":{\"pages\":{\"0\":{\"glyphs\":{", 0) == 0);
+        REQUIRE(json.str().find("\"commands\":{\"End\":1,\"NewLine\":1,\"Test\":1}") != std::string::npos);
+        REQUIRE(csv.str().rfind("font,page,kind,key,count\n", 0) == 0);
+        REQUIRE(csv.str().find("normal,0,digraph,ll,2\n") != std::string::npos);
+        REQUIRE(csv.str().find("normal,0,digraph_miss,o ,1\n") != std::string::npos);
+        REQUIRE(csv.str().find("normal,,command,Test,1\n") != std::string::npos);
+    }
+}
+
+TEST_CASE("Quoting statistics for CSV", "[stats]")
+{
+    ParseStats stats;
+    stats.addGlyph("normal", 0, ",");
+    stats.addGlyph("normal", 0, "\"");
+    stats.addBlock("normal", 12, 40);
+    std::ostringstream csv;
+    stats.writeCsv(csv);
+    REQUIRE(csv.str() ==
+        "font,page,kind,key,count\n"
+        "normal,0,glyph,\"\"\"\",1\n"
+        "normal,0,glyph,\",\",1\n"
+        "normal,,block_bytes,12,1\n"
+        "normal,,block_width,40,1\n"
+    );
+}
@@ -0,0 +1,120 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "parse/textdumper.h"
+#include "parse/textparser.h"
+#include "helpers.h"
+
+using sable::TextDumper, sable::TextParser;
+using sable::options::ExportAddress, sable::options::ExportWidth;
+typedef std::vector<unsigned char> ByteVector;
+
+namespace {
+    ByteVector encode(TextParser& parser, const std::string& text, const std::string& mode)
+    {
+        sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+        auto settings = parser.getDefaultSetting(0x808000);
+        settings.mode = mode;
+        std::istringstream input(text);
+        ByteVector data;
+        auto metadata = TextParser::Metadata::No;
+        for (bool done = false; !done; ) {
+            auto result = parser.parseLine(input, settings, std::back_inserter(data), metadata, mapper);
+            done = result.endOfBlock;
+            metadata = result.metadata;
+        }
+        return data;
+    }
+
+    std::string dump(const TextDumper& dumper, const ByteVector& data, TextDumper::Style style = TextDumper::Style::Script)
+    {
+        std::string text;
+        auto result = dumper.dump(data.data(), data.size(), text, style);
+        REQUIRE(result.ended);
+        REQUIRE(result.length == data.size());
+        return text;
+    }
+}
+
+TEST_CASE("Dumping encoded text", "[dumper]")
+{
+    auto fonts = sable_tests::getSampleFonts();
+    TextParser parser(sable_tests::getSampleNode().as<std::map<std::string, sable::Font>>(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    TextDumper normal(fonts.at("normal"), sable_tests::defaultLocale);
+
+    SECTION("Plain text and new lines come back as written.")
+    {
+        std::string script = "This is a test.\nIt has (two) lines, \"quotes\"[Test] and a command.[End]";
+        auto data = encode(parser, script, "normal");
+        REQUIRE(dump(normal, data) == script);
+    }
+    SECTION("Digraphs are written as their characters.")
+    {
+        std::string script = "llama la ll e?[End]";
+        auto data = encode(parser, script, "normal");
+        REQUIRE(data.size() == 12);
+        REQUIRE(dump(normal, data) == script);
+    }
+    SECTION("Characters which would merge into a digraph are bracketed.")
+    {
+        auto l = encode(parser, "l", "normal").front();
+        auto a = encode(parser, "a", "normal").front();
+        ByteVector data{l, l, l, a, 0, 0};
+        auto text = dump(normal, data);
+        // a is also a hex digit, so it has to be written as its code.
+        REQUIRE(text == "l[l]l[1B][End]");
+        REQUIRE(encode(parser, text, "normal") == data);
+    }
+    SECTION("Unknown codes and bracketed glyphs round-trip.")
+    {
+        ByteVector data{0xF0, 1, 0x41, 0x4D, 0, 2, 0, 0};
+        auto text = dump(normal, data);
+        REQUIRE(text == "[F0]A4[special][00]B[End]");
+        REQUIRE(encode(parser, text, "normal") == data);
+        std::string heart = "❤e†[End]";
+        REQUIRE(dump(normal, encode(parser, heart, "normal")) == heart);
+    }
+    SECTION("Fonts with two byte codes and no command prefix.")
+    {
+        TextDumper menu(fonts.at("menu"), sable_tests::defaultLocale);
+        std::string script = "Menu text[Test]\nNext\nLine[End]";
+        auto data = encode(parser, script, "menu");
+        REQUIRE(dump(menu, data) == script);
+    }
+    SECTION("Blocks can be written as codes.")
+    {
+        auto data = encode(parser, "Some text.\nMore text[End]", "normal");
+        auto text = dump(normal, data, TextDumper::Style::Codes);
+        REQUIRE(text.substr(0, 8) == "[13][29]");
+        REQUIRE(text.find('\n') == std::string::npos);
+        REQUIRE(encode(parser, text, "normal") == data);
+    }
+    SECTION("Dumping stops at the end of the data when there's no end code.")
+    {
+        auto data = encode(parser, "Cut off[End]", "normal");
+        data.resize(data.size() - 2);
+        std::string text;
+        auto result = normal.dump(data.data(), data.size(), text);
+        REQUIRE(!result.ended);
+        REQUIRE(result.length == data.size());
+        REQUIRE(text == "Cut off");
+    }
+}
+
+TEST_CASE("Dumping text with nouns", "[dumper]")
+{
+    auto node = sable_tests::getSampleNode();
+    node["normal"][sable::Font::NOUNS]["Sable"][sable::Font::CODE_VAL] = std::vector<int>{0x70, 0x71};
+    auto fonts = node.as<std::map<std::string, sable::Font>>();
+    TextParser parser(std::map<std::string, sable::Font>(fonts), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    TextDumper normal(fonts.at("normal"), sable_tests::defaultLocale);
+
+    std::string script = "A Sable appears.[End]";
+    auto data = encode(parser, script, "normal");
+    REQUIRE(data.size() == 15);
+    std::string text;
+    auto result = normal.dump(data.data(), data.size(), text);
+    REQUIRE(result.ended);
+    REQUIRE(!result.exact);
+    REQUIRE(text == script);
+}
@@ -19,10 +19,12 @@ sable::options::ExportWidth,
 sable::ParseSettings;
 using Metadata = sable::TextParser::Metadata;
 
-bool operator==(sable::TextParser::Result lhs, std::pair<bool, int> rhs)
+namespace sable {
+bool operator==(TextParser::Result lhs, std::pair<bool, int> rhs)
 {
     return lhs.endOfBlock == rhs.first && lhs.length == rhs.second;
 }
+}
 
 TEST_CASE("Class properties", "[parser]")
 {
@@ -192,6 +194,17 @@ TEST_CASE("Single lines", "[parser]")
         REQUIRE(v[1] == 1);
         REQUIRE(v[2] == 1);
     }
+    SECTION("Check that text after a Noun is read once")
+    {
+        node["normal"][Font::NOUNS]["Noun"][Font::CODE_VAL] = std::vector<int>{1,1,1};
+        TextParser p2(node.as<std::map<std::string, sable::Font>>(), "normal", defLocale, ExportWidth::Off, ExportAddress::On);
+        sample.str("Noun A");
+        sable::TextParser::Result result;
+        REQUIRE_NOTHROW(result = p2.parseLine(sample, settings, std::back_inserter(v), Metadata::No, m));
+        REQUIRE(v.size() == 7);
+        REQUIRE(v[2] == 1);
+        REQUIRE(v[3] != 1);
+    }
     SECTION("Check extras are read correctly.")
     {
         sample.str("[Extra1]");
@@ -820,3 +833,61 @@ TEST_CASE("Parser error checking", "[parser]")
         );
     }
 }
+
+TEST_CASE("Repeated lines are copied from the cache", "[parser]")
+{
+    using sable::TextParser;
+    auto node = sable_tests::getSampleNode();
+    sable::util::Mapper m(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    auto encode = [&m] (TextParser& parser, const std::string& text) {
+        std::istringstream sample(text);
+        auto settings = parser.getDefaultSetting(0x808000);
+        ByteVector v;
+        auto lastRead = Metadata::No;
+        bool keepReading = false;
+        while (sample || keepReading) {
+            auto result = parser.parseLine(sample, settings, std::back_inserter(v), lastRead, m);
+            lastRead = result.metadata;
+            keepReading = !result.endOfBlock && (!v.empty() || lastRead == Metadata::Yes);
+        }
+        return v;
+    };
+    TextParser cached(node.as<std::map<std::string, sable::Font>>(), "normal", defLocale, ExportWidth::Off, ExportAddress::On);
+    TextParser uncached(node.as<std::map<std::string, sable::Font>>(), "normal", defLocale, ExportWidth::Off, ExportAddress::On);
+    uncached.setLineCacheSize(0);
+    std::string script = "ABC\n"
+                         "ABC\n"
+                         "@type menu\n"
+                         "ABC\n"
+                         "ABC\n"
+                         "@autoend off\n"
+                         "ABC\n"
+                         "ABC # a comment\n"
+                         "ABC";
+
+    REQUIRE(encode(cached, script) == encode(uncached, script));
+    // each font and autoend setting encodes the line once.
+    REQUIRE(cached.getLineCacheStats().misses == 3);
+    REQUIRE(cached.getLineCacheStats().hits == 3);
+    REQUIRE(uncached.getLineCacheStats().hits == 0);
+    REQUIRE(uncached.getLineCacheStats().misses == 0);
+
+    SECTION("The address is still checked.")
+    {
+        auto settings = cached.getDefaultSetting(0);
+        std::istringstream sample("ABC");
+        ByteVector v;
+        REQUIRE_THROWS_WITH(
+            cached.parseLine(sample, settings, std::back_inserter(v), Metadata::No, m),
+            "Attempted to parse text before address was set."
+        );
+        REQUIRE(cached.getLineCacheStats().hits == 4);
+    }
+    SECTION("Only the most recent lines are kept.")
+    {
+        cached.setLineCacheSize(1);
+        encode(cached, "ABC\nAB\nABC");
+        REQUIRE(cached.getLineCacheStats().hits == 3);
+        REQUIRE(cached.getLineCacheStats().misses == 6);
+    }
+}
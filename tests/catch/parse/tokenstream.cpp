@@ -0,0 +1,140 @@
+#include <catch2/catch.hpp>
+#include <sstream>
+
+#include "parse/textparser.h"
+#include "helpers.h"
+
+using sable::TokenStream, sable::TextParser;
+using sable::options::ExportAddress, sable::options::ExportWidth;
+using Metadata = TextParser::Metadata;
+typedef std::vector<unsigned char> ByteVector;
+
+namespace {
+    // reads blocks until the input runs out, like Parser::processFile.
+    template<class Input>
+    ByteVector encode(TextParser& parser, Input& input, const sable::util::Mapper& mapper)
+    {
+        auto settings = parser.getDefaultSetting(0x808000);
+        ByteVector data;
+        auto metadata = Metadata::No;
+        bool keepReading = false;
+        while (input || keepReading) {
+            auto result = parser.parseLine(input, settings, std::back_inserter(data), metadata, mapper);
+            metadata = result.metadata;
+            keepReading = !result.endOfBlock && (!data.empty() || metadata == Metadata::Yes);
+        }
+        return data;
+    }
+}
+
+TEST_CASE("Lexing scripts", "[tokens]")
+{
+    TextParser parser(sable_tests::getSampleFonts(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    std::istringstream input("@label one\nHello [Test]there\nall# a comment\nOops [broken\n");
+    auto tokens = parser.lex(input);
+    using Type = TokenStream::Type;
+
+    REQUIRE(tokens.lines() == 4);
+    auto types = [&tokens] (std::size_t index) {
+        std::vector<Type> result;
+        for (auto token = tokens.line(index).firstToken; token < tokens.line(index).lastToken; ++token) {
+            result.push_back(tokens.token(token).type);
+        }
+        return result;
+    };
+    SECTION("Settings take the rest of the line.")
+    {
+        REQUIRE(types(0) == std::vector{Type::Directive});
+        auto& directive = tokens.token(tokens.line(0).firstToken);
+        REQUIRE(tokens.text(directive) == "@label one");
+        REQUIRE(directive.startsLine);
+        REQUIRE(tokens.line(0).next == 'H');
+    }
+    SECTION("Brackets keep just their contents.")
+    {
+        REQUIRE(types(1) == std::vector{Type::Text, Type::Text, Type::Bracket, Type::Text});
+        auto first = tokens.line(1).firstToken;
+        REQUIRE(tokens.text(tokens.token(first)) == "Hello");
+        REQUIRE(tokens.text(tokens.token(first + 2)) == "Test");
+        auto& word = tokens.token(first + 3);
+        REQUIRE(word.lastChar - word.firstChar == 5);
+        REQUIRE(tokens.character(word, word.firstChar + 1) == "h");
+        REQUIRE(tokens.textFrom(word, word.firstChar + 2) == "ere");
+    }
+    SECTION("Comments end the line.")
+    {
+        REQUIRE(types(2) == std::vector{Type::Text, Type::Comment});
+    }
+    SECTION("Unclosed brackets are kept for the encoder to report.")
+    {
+        REQUIRE(types(3) == std::vector{Type::Text, Type::Text, Type::Unclosed});
+        REQUIRE(tokens.line(3).next == std::char_traits<char>::eof());
+        REQUIRE(tokens.line(3).terminated);
+    }
+}
+
+TEST_CASE("Encoding lexed scripts", "[tokens]")
+{
+    sable::util::Mapper mapper(sable::util::MapperType::LOROM, false, true, sable::util::NORMAL_ROM_MAX_SIZE);
+    TextParser normal(sable_tests::getSampleFonts(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    TextParser menu(sable_tests::getSampleFonts(), "menu", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    const std::string script = "@label start\nHello all,\nlast line[Test]la\n# done";
+
+    std::istringstream input(script);
+    const auto tokens = normal.lex(input);
+    SECTION("One stream encodes the same as the text for each font.")
+    {
+        for (auto* parser: {&normal, &menu}) {
+            std::istringstream text(script);
+            TokenStream::Reader reader(tokens);
+            auto expected = encode(*parser, text, mapper);
+            REQUIRE(!expected.empty());
+            REQUIRE(encode(*parser, reader, mapper) == expected);
+        }
+    }
+    SECTION("Fonts give different bytes for the same stream.")
+    {
+        TokenStream::Reader first(tokens), second(tokens);
+        REQUIRE(encode(normal, first, mapper) != encode(menu, second, mapper));
+    }
+    SECTION("Digraphs can use the start of the next word.")
+    {
+        std::istringstream text("e?");
+        auto digraph = normal.lex(text);
+        TokenStream::Reader reader(digraph);
+        auto settings = normal.getDefaultSetting(0x808000);
+        ByteVector data;
+        normal.parseLine(reader, settings, std::back_inserter(data), Metadata::No, mapper);
+        REQUIRE(data == ByteVector({0x4C, 0, 0}));
+    }
+}
+
+TEST_CASE("Token cache", "[tokens]")
+{
+    TextParser parser(sable_tests::getSampleFonts(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    sable::TokenCache cache;
+    REQUIRE(cache.find("a.txt") == nullptr);
+
+    std::istringstream input("Hello\nthere");
+    auto added = cache.add("a.txt", parser.lex(input));
+    REQUIRE(cache.find("a.txt") == added);
+    REQUIRE(added->lines() == 2);
+    REQUIRE_FALSE(added->line(1).terminated);
+    REQUIRE(cache.size() == 1);
+}
+
+TEST_CASE("Lines are normalized when they're lexed", "[tokens]")
+{
+    TextParser parser(sable_tests::getSampleFonts(), "normal", sable_tests::defaultLocale, ExportWidth::Off, ExportAddress::Off);
+    std::istringstream composed("\u00C5 [\u00C5]\n"), decomposed("\u0041\u030A [\u0041\u030A]\n");
+    auto expected = parser.lex(composed);
+    auto tokens = parser.lex(decomposed);
+
+    REQUIRE(tokens.lines() == expected.lines());
+    auto& line = tokens.line(0);
+    REQUIRE(line.lastToken - line.firstToken == expected.line(0).lastToken - expected.line(0).firstToken);
+    for (auto token = line.firstToken; token < line.lastToken; ++token) {
+        REQUIRE(tokens.text(tokens.token(token)) == expected.text(expected.token(token)));
+    }
+    REQUIRE(tokens.text(tokens.token(line.firstToken)) == "\u00C5");
+}
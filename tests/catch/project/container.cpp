@@ -0,0 +1,221 @@
+#include <catch2/catch.hpp>
+
+#include <string>
+#include <sstream>
+#include <map>
+#include "wrapper/filesystem.h"
+#include "helpers.h"
+#include "files.h"
+#include "project/container.h"
+#include "project/groupparser.h"
+#include "project/exceptions.h"
+
+namespace {
+    struct stubSectionParser {
+        int address;
+        std::vector<std::string> keys;
+        std::map<std::string, sable::Font> fl;
+
+        const std::map<std::string, sable::Font>& getFonts() const{
+            return fl;
+        }
+        int getNextAddress(const std::string &) const
+        {
+            return address;
+        }
+        void setNextAddress(int nextAddress)
+        {
+            address = nextAddress;
+        }
+
+        sable::parse::FileResult processFile(
+            std::istream& input,
+            const sable::util::Mapper&,
+            const std::string&,
+            const std::string& fileKey,
+            int nextAddress,
+            int startingDirIndex
+        ) {
+            int count = 0;
+            input >> count;
+            keys.push_back(fileKey);
+            return {.dirIndex = startingDirIndex + 1, .address = (count + nextAddress)};
+        }
+    };
+
+    std::string readAll(std::string_view text)
+    {
+        sable::files::ScriptStream input(text);
+        std::stringstream out;
+        out << input.rdbuf();
+        return out.str();
+    }
+}
+
+TEST_CASE("Reading groups from a container", "[container]")
+{
+    using sable::files::Container;
+    caseFileList samplesFolder(fs::path("container_samples"));
+    sable::util::Mapper m(sable::util::LOROM, false, false);
+
+    SECTION("Groups without tables are sorted by name.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group second\n"
+            "%%file b.txt\n"
+            "b text\n"
+            "%%file a.txt\n"
+            "a text\n"
+            "\n"
+            "%%group first\n"
+            "%%file only.txt\n"
+            "only\n"
+        });
+        Container c(samplesFolder.folder / "text.sable", m);
+        REQUIRE(c.groups.size() == 2);
+        REQUIRE(c.groups[0].name == "second");
+        REQUIRE(c.groups[1].name == "first");
+        REQUIRE_FALSE(c.groups[0].table);
+        REQUIRE(c.groups[0].scripts.size() == 2);
+        REQUIRE(c.groups[0].scripts[0].name == "a.txt");
+        REQUIRE(readAll(c.groups[0].scripts[0].text) == "a text\n\n");
+        REQUIRE(c.groups[0].scripts[1].name == "b.txt");
+        REQUIRE(readAll(c.groups[0].scripts[1].text) == "b text\n");
+        REQUIRE(c.groups[1].scripts[0].text == "only\n");
+    }
+    SECTION("A group with a table uses its file order.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group tabled\n"
+            "%%table\n"
+            "address 818000\n"
+            "file z.txt\n"
+            "file a.txt\n"
+            "%%file a.txt\n"
+            "a\n"
+            "%%file z.txt\n"
+            "z\n"
+        });
+        Container c(samplesFolder.folder / "text.sable", m);
+        REQUIRE(c.groups.size() == 1);
+        REQUIRE(c.groups[0].table);
+        REQUIRE(c.groups[0].table->getAddress() == 0x818000);
+        REQUIRE(c.groups[0].scripts.size() == 2);
+        REQUIRE(c.groups[0].scripts[0].name == "z.txt");
+        REQUIRE(c.groups[0].scripts[1].name == "a.txt");
+    }
+    SECTION("Escaped lines lose one %.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group escapes\n"
+            "%%file a.txt\n"
+            "before\n"
+            "%%%group not a group\n"
+            "%%%%four\n"
+        });
+        Container c(samplesFolder.folder / "text.sable", m);
+        REQUIRE(c.groups.size() == 1);
+        REQUIRE(readAll(c.groups[0].scripts[0].text) == "before\n%%group not a group\n%%%four\n");
+    }
+    SECTION("Text outside of a file is an error.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "stray text\n"
+            "%%group a\n"
+        });
+        REQUIRE_THROWS_AS(Container(samplesFolder.folder / "text.sable", m), sable::ParseError);
+    }
+    SECTION("A file defined twice is an error.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group a\n"
+            "%%file a.txt\n"
+            "%%file a.txt\n"
+        });
+        REQUIRE_THROWS_WITH(
+            Container(samplesFolder.folder / "text.sable", m),
+            Catch::Contains("line 3") && Catch::Contains("more than once")
+        );
+    }
+    SECTION("A table can't list a file the group doesn't have.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group a\n"
+            "%%table\n"
+            "file missing.txt\n"
+            "%%file a.txt\n"
+        });
+        REQUIRE_THROWS_WITH(
+            Container(samplesFolder.folder / "text.sable", m),
+            Catch::Contains("missing.txt does not exist")
+        );
+    }
+    SECTION("Unknown directives are errors.")
+    {
+        samplesFolder.create(caseFile{
+            "text.sable",
+            "%%group a\n"
+            "%%folder b\n"
+        });
+        REQUIRE_THROWS_AS(Container(samplesFolder.folder / "text.sable", m), sable::ParseError);
+    }
+}
+
+TEST_CASE("Input directories mix folders and containers", "[container]")
+{
+    using sable::files::InputDirectory;
+    caseFileList samplesFolder(fs::path("container_samples"));
+    sable::util::Mapper m(sable::util::LOROM, false, false);
+    samplesFolder.create(
+        std::string("b"),
+        caseFile{"b/1.txt", "1\n"},
+        std::string("d"),
+        caseFile{"d/1.txt", "1\n"},
+        caseFile{"groups.sable", "%%group c\n%%file 1.txt\n1\n%%group a\n%%file 1.txt\n1\n"},
+        caseFile{"notes.txt", "ignored\n"}
+    );
+
+    SECTION("Groups are sorted by name.")
+    {
+        InputDirectory input(samplesFolder.folder, m);
+        std::vector<std::string> names;
+        for (auto& group: input) {
+            names.push_back(group.name);
+            REQUIRE((group.folder == nullptr) != (group.section == nullptr));
+        }
+        REQUIRE(names == std::vector<std::string>{"a", "b", "c", "d"});
+    }
+    SECTION("A group can only be defined once.")
+    {
+        samplesFolder.create(caseFile{"more.sable", "%%group b\n%%file 1.txt\n1\n"});
+        REQUIRE_THROWS_AS(InputDirectory(samplesFolder.folder, m), sable::ParseError);
+    }
+}
+
+TEST_CASE("Parsing a container section - using stubs.", "[container]")
+{
+    using sable::GroupParser;
+    caseFileList samplesFolder(fs::path("container_samples"));
+    sable::util::Mapper m(sable::util::LOROM, false, false);
+    samplesFolder.create(caseFile{
+        "text.sable",
+        "%%group samples\n"
+        "%%file test1.txt\n3\n"
+        "%%file test2.txt\n5\n"
+        "%%file test3.txt\n8\n"
+    });
+    sable::files::Container c(samplesFolder.folder / "text.sable", m);
+    stubSectionParser stub{800, {}, {}};
+    GroupParser<stubSectionParser> gp(stub);
+
+    REQUIRE_NOTHROW(gp.processSection(c.groups.front(), m, "samples", 0));
+    REQUIRE(stub.address == 816);
+    REQUIRE(stub.keys.size() == 3);
+    REQUIRE(stub.keys.front() == (fs::absolute(samplesFolder.folder / "text.sable") / "test1.txt").string());
+}
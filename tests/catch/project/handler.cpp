@@ -132,3 +132,36 @@ TEST_CASE("Error handling.")
         REQUIRE(sink.str() == "");
     }
 }
+
+TEST_CASE("Only changed files are rewritten")
+{
+    using sable::options::ExportAddress, sable::options::ExportWidth;
+    caseFileList cs("samples");
+    cs.create(caseFile{"stale.bin", "old"}, "olddir");
+    std::ostringstream sink;
+    std::vector<unsigned char> data{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    auto past = fs::file_time_type::clock::now() - std::chrono::hours(1);
+    {
+        Handler first(fs::path("samples"), sink, sable_tests::getSampleFonts(), "normal", "en_US.utf-8", ExportWidth::Off, ExportAddress::On);
+        first.write("test1.bin", "test1", data, 0x808000, 0, 10, false, ExportWidth::Off, ExportAddress::On);
+        first.write("test2.bin", "test2", data, 0x808010, 0, 4, false, ExportWidth::Off, ExportAddress::On);
+        REQUIRE(first.changedFiles == 2);
+        REQUIRE(first.removeStaleFiles() == 1);
+        REQUIRE(!fs::exists(cs.folder / "stale.bin"));
+        REQUIRE(!fs::exists(cs.folder / "olddir"));
+    }
+    fs::last_write_time(cs.folder / "test1.bin", past);
+    fs::last_write_time(cs.folder / "test2.bin", past);
+
+    Handler second(fs::path("samples"), sink, sable_tests::getSampleFonts(), "normal", "en_US.utf-8", ExportWidth::Off, ExportAddress::On);
+    second.write("test1.bin", "test1", data, 0x808000, 0, 10, false, ExportWidth::Off, ExportAddress::On);
+    second.write("test2.bin", "test2", data, 0x808010, 4, 4, false, ExportWidth::Off, ExportAddress::On);
+    REQUIRE(second.changedFiles == 1);
+    REQUIRE(fs::last_write_time(cs.folder / "test1.bin") == past);
+    REQUIRE(fs::last_write_time(cs.folder / "test2.bin") != past);
+    REQUIRE(second.removeStaleFiles() == 0);
+    std::ifstream changed((cs.folder / "test2.bin").string(), std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(changed)), std::istreambuf_iterator<char>());
+    REQUIRE(contents == std::string("\x04\x05\x06\x07", 4));
+    REQUIRE(!fs::exists(cs.folder / "test2.bin.tmp"));
+}
@@ -1,7 +1,10 @@
 #include <catch2/catch.hpp>
+#include <sstream>
 #include "yaml-cpp/yaml.h"
 #include "project/project.h"
 #include "project/builder.h"
+#include "font/builder.h"
+#include "helpers.h"
 
 #include "files.h"
 #ifdef WIN32
@@ -109,6 +112,18 @@ TEST_CASE("Test project config validation", "[project]")
                 romNode["header"] = "argleblargle";
                 err = "rom something does not have a valid header option - must be \"true\", \"false\", \"auto\", or not defined.\n";
             }
+            SECTION("bad patches")
+            {
+                SECTION("not a sequence")
+                {
+                    romNode["patches"] = "ips";
+                }
+                SECTION("unknown format")
+                {
+                    romNode["patches"] = std::array{"ips", "ups"};
+                }
+                err = "rom something does not have a valid patches option - must be a sequence of \"ips\" and/or \"bps\".\n";
+            }
 
             testNode[Project::ROMS] = std::array{romNode2, romNode};
             REQUIRE_THROWS_WITH(
@@ -295,6 +310,18 @@ TEST_CASE("Test project config validation", "[project]")
             REQUIRE_THROWS_WITH(ProjectSerializer::read(testNode, "."), "config > exportAllAddresses must be a string with a valid value(on/off or true/false).\n");
         }
 
+        SECTION("Invalid deduplicateBlocks.")
+        {
+            testNode[Project::CONFIG_SECTION][Project::DEDUPLICATE_BLOCKS] = std::array{"wrong!"};
+            REQUIRE_THROWS_WITH(ProjectSerializer::read(testNode, "."), "config > deduplicateBlocks must be a string with a valid value(on/off or true/false).\n");
+        }
+
+        SECTION("Invalid binaryFontWidths.")
+        {
+            testNode[Project::CONFIG_SECTION][Project::BINARY_FONT_WIDTHS] = std::array{"wrong!"};
+            REQUIRE_THROWS_WITH(ProjectSerializer::read(testNode, "."), "config > binaryFontWidths must be a string with a valid value(on/off or true/false).\n");
+        }
+
         SECTION("Invalid ROM folder")
         {
 
@@ -381,6 +408,30 @@ TEST_CASE("Test project config validation", "[project]")
             auto p = ProjectSerializer::read(testNode, ".");
             REQUIRE(!p.areAddressesExported());
         }
+        SECTION("block deduplication setting")
+        {
+            auto p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(!p.areBlocksDeduplicated());
+            testNode[Project::CONFIG_SECTION][Project::DEDUPLICATE_BLOCKS] = "on";
+            p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(p.areBlocksDeduplicated());
+        }
+        SECTION("binary font width setting")
+        {
+            auto p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(!p.areFontWidthsBinary());
+            testNode[Project::CONFIG_SECTION][Project::BINARY_FONT_WIDTHS] = "true";
+            p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(p.areFontWidthsBinary());
+        }
+        SECTION("assembly cache setting")
+        {
+            auto p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(!p.isAssemblyCached());
+            testNode[Project::CONFIG_SECTION][Project::CACHE_ASSEMBLY] = "on";
+            p = ProjectSerializer::read(testNode, ".");
+            REQUIRE(p.isAssemblyCached());
+        }
 
         SECTION("Input file options")
         {
@@ -420,3 +471,170 @@ TEST_CASE("Test project config validation", "[project]")
         }
     }
 }
+
+TEST_CASE("Measure a project's text", "[project]")
+{
+    caseFileList cs{"measure"};
+    YAML::Emitter fonts;
+    fonts << sable_tests::getSampleNode();
+    cs.create(
+        caseFile{fs::path{"config.yml"},
+            "files: {mainDir: project, input: {directory: text}, romDir: roms,\n"
+            "  output: {directory: asm, binaries: {mainDir: bin, textDir: text, fonts: {dir: fonts}}}}\n"
+            "config: {directory: config, inMapping: fonts.yml, outputSize: 4m, deduplicateBlocks: on}\n"
+            "roms: [{name: test, file: test.sfc, header: false}]\n"
+        },
+        "config",
+        "project"
+    );
+    caseFileList config{cs.folder / "config"};
+    config.add(caseFile{fs::path{"fonts.yml"}, fonts.c_str()});
+    caseFileList text{cs.folder / "project" / "text"};
+    caseFileList first{text.folder / "first"};
+    caseFileList second{text.folder / "second"};
+    // the table ends at $80FFF8, so the second block starts at $80FFFE and is split into the next bank.
+    first.create(
+        caseFile{fs::path{"table.txt"}, "address 80FFF0\nwidth 3\nfile 01.txt\nfile 02.txt\n\nentry first\nentry split\nentry dummy\n"},
+        caseFile{fs::path{"01.txt"}, "@label first\nKLM\n"},
+        caseFile{fs::path{"02.txt"}, "@label split\nABCDEFGHIJ\n"}
+    );
+    second.create(
+        caseFile{fs::path{"table.txt"}, "address 808000\nwidth 3\nfile 01.txt\n\nentry second\n"},
+        caseFile{fs::path{"01.txt"}, "@label second\nKLM\n"}
+    );
+
+    auto project = Project::from(cs.folder.string());
+    std::ostringstream out;
+    REQUIRE(project.measureText(out));
+    auto report = out.str();
+    INFO(report);
+    // deduplication works across groups with their own tables, like it does in a build.
+    REQUIRE(report.find("(same data as first)") != std::string::npos);
+    REQUIRE(report.find("Text ends at $818009,") != std::string::npos);
+}
+
+TEST_CASE("Check a project's text", "[project]")
+{
+    caseFileList cs{"check"};
+    auto fontNode = sable_tests::getSampleNode();
+    fontNode["broken"][sable::Font::BYTE_WIDTH] = 1;
+    YAML::Emitter fonts;
+    fonts << fontNode;
+    cs.create(
+        caseFile{fs::path{"config.yml"},
+            "files: {mainDir: project, input: {directory: text}, romDir: roms,\n"
+            "  output: {directory: asm, binaries: {mainDir: bin, textDir: text, fonts: {dir: fonts}}}}\n"
+            "config: {directory: config, inMapping: fonts.yml, outputSize: 4m, deduplicateBlocks: on}\n"
+            "roms: [{name: test, file: test.sfc, header: false}]\n"
+        },
+        "config",
+        "project"
+    );
+    caseFileList config{cs.folder / "config"};
+    config.add(caseFile{fs::path{"fonts.yml"}, fonts.c_str()});
+    caseFileList text{cs.folder / "project" / "text"};
+    caseFileList first{text.folder / "first"};
+    caseFileList second{text.folder / "second"};
+    // 02.txt is missing, and the other two files use a font which can't be built.
+    first.create(
+        caseFile{fs::path{"table.txt"}, "address 808000\nwidth 3\nfile 01.txt\nfile 02.txt\nfile 03.txt\n\nentry a\nentry b\nentry c\n"},
+        caseFile{fs::path{"01.txt"}, "@label a\n@type broken\nABC\n"},
+        caseFile{fs::path{"03.txt"}, "@label c\nABC\n@type broken\nDEF\n"}
+    );
+    second.create(
+        caseFile{fs::path{"table.txt"}, "address 818000\nwidth 3\nfile 01.txt\nfile 02.txt\n\nentry d\nentry e\n"},
+        caseFile{fs::path{"01.txt"}, "@label d\n@type broken\nABC\n"},
+        caseFile{fs::path{"02.txt"}, "@label e\nAB~C\n"}
+    );
+
+    auto project = Project::from(cs.folder.string());
+    std::ostringstream out;
+    REQUIRE(project.checkText(out) == 5);
+    auto report = out.str();
+    INFO(report);
+    auto errorIn = [&report] (const fs::path& file, const std::string& message) {
+        auto start = report.find("Error in " + fs::absolute(file).string());
+        if (start == std::string::npos) {
+            return false;
+        }
+        return report.substr(start, report.find('\n', start) - start).find(message) != std::string::npos;
+    };
+    REQUIRE(errorIn(first.folder / "01.txt", "In font \"broken\""));
+    REQUIRE(errorIn(first.folder / "02.txt", "The file does not exist, or could not be opened."));
+    REQUIRE(errorIn(first.folder / "03.txt", "In font \"broken\""));
+    REQUIRE(errorIn(second.folder / "01.txt", "In font \"broken\""));
+    REQUIRE(errorIn(second.folder / "02.txt", "\"~\" not found in Encoding of font normal"));
+    REQUIRE(report.find("5 errors, 0 warnings.") != std::string::npos);
+}
+
+TEST_CASE("Dictionary suggestions can be merged into a font", "[project]")
+{
+    using sable::Font;
+    caseFileList cs{"dictionary"};
+    auto fontNode = sable_tests::getSampleNode();
+    fontNode["normal"][Font::PAGES].push_back(YAML::Clone(fontNode["normal"][Font::ENCODING]));
+    YAML::Emitter fonts;
+    fonts << fontNode;
+    cs.create(
+        caseFile{fs::path{"config.yml"},
+            "files: {mainDir: project, input: {directory: text}, romDir: roms,\n"
+            "  output: {directory: asm, binaries: {mainDir: bin, textDir: text, fonts: {dir: fonts}}}}\n"
+            "config: {directory: config, inMapping: fonts.yml}\n"
+            "roms: [{name: test, file: test.sfc, header: false}]\n"
+        },
+        "config",
+        "project"
+    );
+    caseFileList config{cs.folder / "config"};
+    config.add(caseFile{fs::path{"fonts.yml"}, fonts.c_str()});
+    caseFileList text{cs.folder / "project" / "text"};
+    caseFileList group{text.folder / "group"};
+    std::string script = "@label a\n";
+    for (int line = 0; line < 20; ++line) {
+        script += "ABAB CDCD ABAB\n";
+    }
+    script += "@page 1\n";
+    for (int line = 0; line < 20; ++line) {
+        script += "EFEF EFEF GHGH\n";
+    }
+    // nodigraph only has one page, so this goes back to its first.
+    script += "@type nodigraph\n";
+    for (int line = 0; line < 20; ++line) {
+        script += "IJIJ IJIJ\n";
+    }
+    group.create(
+        caseFile{fs::path{"table.txt"}, "address 808000\nwidth 3\nfile 01.txt\n\nentry a\n"},
+        caseFile{fs::path{"01.txt"}, script}
+    );
+
+    auto project = Project::from(cs.folder.string());
+    std::ostringstream out;
+    project.optimizeDictionary(out, 2);
+    INFO(out.str());
+    auto suggestions = YAML::Load(out.str());
+    REQUIRE(suggestions.IsMap());
+    REQUIRE(suggestions.size() == 2);
+    REQUIRE(suggestions["nodigraph"][Font::NOUNS]["IJIJ"].IsDefined());
+    REQUIRE(!suggestions["nodigraph"][Font::PAGES].IsDefined());
+    auto normal = suggestions["normal"];
+    REQUIRE(normal[Font::NOUNS]["ABAB"].IsDefined());
+    REQUIRE(normal[Font::PAGES].size() == 1);
+    REQUIRE(normal[Font::PAGES][0][Font::NOUNS]["EFEF"].IsDefined());
+
+    // page 1 keeps its encoding and gets the suggestions for it.
+    YAML::Node page;
+    page[Font::ENCODING] = fontNode["normal"][Font::PAGES][0];
+    page[Font::NOUNS] = normal[Font::PAGES][0][Font::NOUNS];
+    fontNode["normal"][Font::PAGES][0] = page;
+    for (auto entry: normal[Font::NOUNS]) {
+        fontNode["normal"][Font::NOUNS][entry.first] = entry.second;
+    }
+    auto font = sable::FontBuilder::make(fontNode["normal"], "normal", sable_tests::defaultLocale);
+    for (int index: {0, 1}) {
+        auto nouns = index == 0 ? normal[Font::NOUNS] : normal[Font::PAGES][0][Font::NOUNS];
+        for (auto entry: nouns) {
+            auto noun = font.getNounData(index, entry.first.as<std::string>());
+            REQUIRE(*noun == entry.second[Font::CODE_VAL][0].as<int>());
+        }
+    }
+}
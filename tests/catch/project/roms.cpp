@@ -52,6 +52,13 @@ TEST_CASE("Valid ROM Decoding")
         REQUIRE(rom.includes[2] == "folder/include.bin");
     }
 
+    SECTION("With patches")
+    {
+        n["patches"] = std::array{"ips", "bps"};
+        rom = n.as<sable::ProjectSerializer::Rom>();
+        REQUIRE(rom.patches == std::vector<std::string>{"ips", "bps"});
+    }
+
     REQUIRE(rom.file == "something.sfc");
     REQUIRE(rom.name == "something");
 }
@@ -61,6 +68,13 @@ TEST_CASE("Invalid ROM Decoding")
     YAML::Node n;
     n["name"] = "something";
     n["file"] = "something.sfc";
-    n["header"] = "bad!";
+    SECTION("Bad header")
+    {
+        n["header"] = "bad!";
+    }
+    SECTION("Bad patch format")
+    {
+        n["patches"] = std::array{"ups"};
+    }
     REQUIRE_THROWS(n.as<sable::ProjectSerializer::Rom>());
 }
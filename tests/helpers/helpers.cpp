@@ -129,6 +129,29 @@ YAML::Node sable_tests::getSampleNode()
     return sampleNode;
 }
 
+YAML::Node sable_tests::getCompiledSampleNode()
+{
+    using sable::Font;
+    auto sampleNode = getSampleNode();
+    auto paged = YAML::Clone(sampleNode["normal"]);
+    paged[Font::FONT_ADDR] = "!pagedWidths";
+    paged[Font::COMPRESSION] = "lz";
+    paged[Font::NOUNS]["Sable"] = NounNode{{"19", "27", "28", "38", "31"}, "20"};
+    paged[Font::NOUNS]["マルス"] = NounNode{{"0x50", "0x50"}, "12"};
+    YAML::Node page;
+    page[Font::ENCODING]["A"] = EncNode{"0x10", "8"};
+    page[Font::ENCODING]["あ"] = EncNode{"0x11", "12"};
+    page[Font::MAX_CHAR] = 0x20;
+    paged[Font::PAGES].push_back(page);
+    paged[Font::COMMANDS]["Page0"][Font::CODE_VAL] = 0xF0;
+    paged[Font::COMMANDS]["Page0"][Font::CMD_PAGE] = 0;
+    paged[Font::COMMANDS]["Page1"][Font::CODE_VAL] = 0xF1;
+    paged[Font::COMMANDS]["Page1"][Font::CMD_PAGE] = 1;
+    paged[Font::EXTRAS]["Ö"] = 0x41;
+    sampleNode["paged"] = paged;
+    return sampleNode;
+}
+
 namespace YAML {
 using sable_tests::EncNode, sable_tests::NounNode;
 Node convert<sable_tests::EncNode>::encode(const EncNode& rhs)
@@ -25,6 +25,9 @@ YAML::Node createSampleNode(
 );
 
 YAML::Node getSampleNode();
+// getSampleNode with a "paged" font that also has nouns, a second page and
+// compression. The tests compile these fonts in with sable-fontgen.
+YAML::Node getCompiledSampleNode();
 std::locale getTestLocale();
 
 std::map<std::string, sable::Font> getSampleFonts();
@@ -0,0 +1,22 @@
+#include <fstream>
+#include <iostream>
+#include <yaml-cpp/yaml.h>
+
+#include "helpers.h"
+
+// Writes getCompiledSampleNode out as a mapping file for sable-fontgen.
+int main(int argc, char * argv[])
+{
+    if (argc != 2) {
+        std::cerr << "Usage: " << argv[0] << " OUTPUT\n";
+        return 1;
+    }
+    YAML::Emitter yaml;
+    yaml << sable_tests::getCompiledSampleNode();
+    std::ofstream output(argv[1], std::ios::binary);
+    if (!output || !(output << yaml.c_str() << '\n')) {
+        std::cerr << argv[1] << " could not be written.\n";
+        return 1;
+    }
+    return 0;
+}